@@ -0,0 +1,127 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <ftw.h>
+#include <unistd.h>
+#include "Benchmark.h"
+#include "Workloads.h"
+#include "RuntimeEnv.h"
+#include "JavaThread.h"
+#include "GC.h"
+
+RuntimeEnv crt;
+
+static const char *USAGE =
+        "usage: cjvm-bench [options]\n"
+        "  --warmups N       warmup samples per benchmark (default 5)\n"
+        "  --samples N       measured samples per benchmark (default 10)\n"
+        "  --time MS         target duration of one sample in milliseconds (default 200)\n"
+        "  --filter TEXT     only run benchmarks whose name contains TEXT\n"
+        "  --json FILE       write results as JSON to FILE, - for stdout\n"
+        "  --classes DIR     write the generated benchmark classes to DIR and keep them\n"
+        "  --list            list benchmarks and exit\n";
+
+static int removeEntry(const char *path, const struct stat *, int, struct FTW *) {
+    return remove(path);
+}
+
+static bool parseCount(const char *arg, uint32_t &out) {
+    char *end = nullptr;
+    const unsigned long value = std::strtoul(arg, &end, 10);
+    if (!*arg || *end || value == 0 || value > UINT32_MAX) {
+        return false;
+    }
+    out = (uint32_t)value;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    BenchmarkRunner::Options options;
+    std::string filter, jsonPath, classDir;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--warmups") == 0 && hasValue) {
+            // 允许不预热
+            options.warmups = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--samples") == 0 && hasValue && parseCount(argv[i + 1], options.samples)) {
+            ++i;
+        } else if (strcmp(argv[i], "--time") == 0 && hasValue && parseCount(argv[i + 1], options.sampleMillis)) {
+            ++i;
+        } else if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && hasValue) {
+            jsonPath = argv[++i];
+        } else if (strcmp(argv[i], "--classes") == 0 && hasValue) {
+            classDir = argv[++i];
+        } else if (strcmp(argv[i], "--list") == 0) {
+            list = true;
+        } else {
+            std::cerr << USAGE;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // 没有指定目录时生成到临时目录，结束后删除
+    const bool temporary = classDir.empty();
+    if (temporary) {
+        char pattern[] = "/tmp/cjvm-bench-XXXXXX";
+        if (!mkdtemp(pattern)) {
+            std::cerr << __func__ << ":Can not create temporary class directory\n";
+            return EXIT_FAILURE;
+        }
+        classDir = pattern;
+    }
+
+    JavaThread::attachCurrentThread(nullptr);
+    std::vector<BenchmarkResult> results;
+    int status = EXIT_SUCCESS;
+    {
+        Workloads workloads(classDir);
+        if (!workloads.prepare()) {
+            std::cerr << __func__ << ":Failed to prepare benchmark classes in " << classDir << "\n";
+            status = EXIT_FAILURE;
+        } else {
+            BenchmarkRunner runner(options);
+            for (const auto &benchmark : workloads.benchmarks()) {
+                if (list) {
+                    std::cout << benchmark.name << "\t" << benchmark.description << "\n";
+                    continue;
+                }
+                if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+                    continue;
+                }
+                // 进度和表格写到 stderr，stdout 留给 --json -
+                std::cerr << "running " << benchmark.name << "\n";
+                results.push_back(runner.run(benchmark));
+            }
+
+            if (!list) {
+                BenchmarkRunner::printTable(std::cerr, results);
+                if (jsonPath == "-") {
+                    runner.printJson(std::cout, results);
+                } else if (!jsonPath.empty()) {
+                    std::ofstream out(jsonPath, std::ios::trunc);
+                    runner.printJson(out, results);
+                    if (!out.good()) {
+                        std::cerr << __func__ << ":Can not write " << jsonPath << "\n";
+                        status = EXIT_FAILURE;
+                    }
+                }
+            }
+        }
+    }
+
+    if (temporary) {
+        nftw(classDir.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+    JavaThread::detachCurrentThread();
+    crt.gc->terminateGC();
+    return status;
+}
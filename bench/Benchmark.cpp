@@ -0,0 +1,143 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include "Benchmark.h"
+
+volatile uint64_t benchmarkSink = 0;
+
+// 自由度为 1..30 的 t 分布双侧 95% 分位数，自由度更大时用正态分布的 1.96
+static const double T_QUANTILE_95[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double tQuantile(std::size_t degrees) {
+    const std::size_t count = sizeof(T_QUANTILE_95) / sizeof(T_QUANTILE_95[0]);
+    return degrees == 0 ? 0 : degrees <= count ? T_QUANTILE_95[degrees - 1] : 1.96;
+}
+
+double BenchmarkRunner::measure(const Benchmark &benchmark, uint64_t calls) {
+    if (benchmark.setup) {
+        benchmark.setup();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    benchmark.run(calls);
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+uint64_t BenchmarkRunner::calibrate(const Benchmark &benchmark) const {
+    // 调用次数翻倍直到耗时超过目标的十分之一，再按比例放大到目标时间
+    const double target = options.sampleMillis / 1000.0;
+    uint64_t calls = 1;
+    double elapsed = measure(benchmark, calls);
+    while (elapsed < target / 10 && calls < (UINT64_MAX >> 1)) {
+        calls <<= 1;
+        elapsed = measure(benchmark, calls);
+    }
+    const double scaled = (double)calls * target / std::max(elapsed, 1e-9);
+    return std::max<uint64_t>(1, (uint64_t)scaled);
+}
+
+BenchmarkResult BenchmarkRunner::run(const Benchmark &benchmark) const {
+    BenchmarkResult result;
+    result.name = benchmark.name;
+    result.description = benchmark.description;
+    result.callsPerSample = calibrate(benchmark);
+
+    for (uint32_t i = 0; i < options.warmups; i++) {
+        measure(benchmark, result.callsPerSample);
+    }
+    const double ops = (double)result.callsPerSample * benchmark.opsPerCall;
+    for (uint32_t i = 0; i < options.samples; i++) {
+        result.samples.push_back(ops / std::max(measure(benchmark, result.callsPerSample), 1e-9));
+    }
+
+    const std::size_t n = result.samples.size();
+    double sum = 0;
+    for (double x : result.samples) {
+        sum += x;
+    }
+    result.mean = n ? sum / n : 0;
+    double squares = 0;
+    for (double x : result.samples) {
+        squares += (x - result.mean) * (x - result.mean);
+    }
+    result.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0;
+    const double margin = n > 1 ? tQuantile(n - 1) * result.stddev / std::sqrt((double)n) : 0;
+    result.ciLow = result.mean - margin;
+    result.ciHigh = result.mean + margin;
+    return result;
+}
+
+void BenchmarkRunner::printTable(std::ostream &os, const std::vector<BenchmarkResult> &results) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-24s %16s %16s %8s\n", "benchmark", "ops/sec", "95% CI +/-", "CI %");
+    os << line;
+    for (const auto &r : results) {
+        const double margin = r.ciHigh - r.mean;
+        std::snprintf(line, sizeof(line), "%-24s %16.0f %16.0f %7.2f%%\n", r.name.c_str(), r.mean, margin,
+                      r.mean > 0 ? margin / r.mean * 100 : 0.0);
+        os << line;
+    }
+}
+
+static void printJsonString(std::ostream &os, const std::string &str) {
+    os << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            os << escaped;
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+static void printJsonNumber(std::ostream &os, double value) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.6g", std::isfinite(value) ? value : 0.0);
+    os << number;
+}
+
+void BenchmarkRunner::printJson(std::ostream &os, const std::vector<BenchmarkResult> &results) const {
+    os << "{\n  \"suite\": \"cjvm-bench\",\n";
+    os << "  \"warmups\": " << options.warmups << ",\n";
+    os << "  \"samples\": " << options.samples << ",\n";
+    os << "  \"sampleMillis\": " << options.sampleMillis << ",\n";
+    os << "  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult &r = results[i];
+        os << (i ? ",\n" : "\n") << "    {\"name\": ";
+        printJsonString(os, r.name);
+        os << ", \"description\": ";
+        printJsonString(os, r.description);
+        os << ", \"unit\": \"ops/s\", \"callsPerSample\": " << r.callsPerSample << ", \"mean\": ";
+        printJsonNumber(os, r.mean);
+        os << ", \"stddev\": ";
+        printJsonNumber(os, r.stddev);
+        os << ", \"ci95\": [";
+        printJsonNumber(os, r.ciLow);
+        os << ", ";
+        printJsonNumber(os, r.ciHigh);
+        os << "], \"samples\": [";
+        for (std::size_t k = 0; k < r.samples.size(); ++k) {
+            if (k) {
+                os << ", ";
+            }
+            printJsonNumber(os, r.samples[k]);
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+}
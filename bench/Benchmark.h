@@ -0,0 +1,74 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_BENCHMARK_H
+#define CJVM_BENCHMARK_H
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 基准测试的计算结果写入这里，防止被编译器当作死代码删除
+extern volatile uint64_t benchmarkSink;
+
+/**
+ * 一个基准测试：run(calls) 执行 calls 次被测操作，每次包含 opsPerCall 个操作。
+ * setup 在每次采样之前调用，不计入时间
+ */
+class Benchmark {
+public:
+    std::string name;
+    std::string description;
+    uint64_t opsPerCall = 1;
+    std::function<void()> setup;
+    std::function<void(uint64_t calls)> run;
+};
+
+class BenchmarkResult {
+public:
+    std::string name;
+    std::string description;
+    // 每次采样执行的 run 的调用次数
+    uint64_t callsPerSample = 0;
+    // 每次采样的 ops/sec
+    std::vector<double> samples;
+    double mean = 0;
+    double stddev = 0;
+    // 均值的 95% 置信区间
+    double ciLow = 0;
+    double ciHigh = 0;
+};
+
+/**
+ * 先按目标采样时间校准每次采样的调用次数，再做若干次不计入结果的预热采样，最后正式采样。
+ * 置信区间按 t 分布计算
+ */
+class BenchmarkRunner {
+public:
+    class Options {
+    public:
+        uint32_t warmups = 5;
+        uint32_t samples = 10;
+        uint32_t sampleMillis = 200;
+    };
+
+    explicit BenchmarkRunner(const Options &options) : options(options) {}
+
+    BenchmarkResult run(const Benchmark &benchmark) const;
+
+    static void printTable(std::ostream &os, const std::vector<BenchmarkResult> &results);
+    void printJson(std::ostream &os, const std::vector<BenchmarkResult> &results) const;
+
+private:
+    // 执行一次采样，返回耗时(秒)
+    static double measure(const Benchmark &benchmark, uint64_t calls);
+    uint64_t calibrate(const Benchmark &benchmark) const;
+
+    Options options;
+};
+
+
+#endif //CJVM_BENCHMARK_H
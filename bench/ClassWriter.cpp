@@ -0,0 +1,257 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#include "ClassWriter.h"
+#include "Opcode.h"
+
+#define CLASS_FILE_MAGIC 0xCAFEBABE
+#define CLASS_FILE_MAJOR 50
+
+#define CONSTANT_TAG_UTF8 1
+#define CONSTANT_TAG_CLASS 7
+#define CONSTANT_TAG_FIELD_REF 9
+#define CONSTANT_TAG_METHOD_REF 10
+#define CONSTANT_TAG_NAME_AND_TYPE 12
+
+#define STACK_MAP_FULL_FRAME 255
+
+static inline void putU2(std::vector<u1> &out, u2 value) {
+    out.push_back((u1)(value >> 8));
+    out.push_back((u1)value);
+}
+
+static inline void putU4(std::vector<u1> &out, u4 value) {
+    putU2(out, (u2)(value >> 16));
+    putU2(out, (u2)value);
+}
+
+static inline void putBytes(std::vector<u1> &out, const std::vector<u1> &bytes) {
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+static void putTypes(std::vector<u1> &out, const std::vector<VerificationType> &types) {
+    putU2(out, (u2)types.size());
+    for (const auto &type : types) {
+        out.push_back(type.tag);
+        if (type.tag == VerificationType::ITEM_OBJECT) {
+            putU2(out, type.classIndex);
+        }
+    }
+}
+
+
+/****************************************************************************
+ * CodeBuilder
+ ****************************************************************************/
+CodeBuilder& CodeBuilder::op(u1 opcode) {
+    code.push_back(opcode);
+    return *this;
+}
+
+CodeBuilder& CodeBuilder::op1(u1 opcode, u1 operand) {
+    code.push_back(opcode);
+    code.push_back(operand);
+    return *this;
+}
+
+CodeBuilder& CodeBuilder::op2(u1 opcode, u2 operand) {
+    code.push_back(opcode);
+    putU2(code, operand);
+    return *this;
+}
+
+CodeBuilder& CodeBuilder::iinc(u1 slot, int8_t delta) {
+    code.push_back(op_iinc);
+    code.push_back(slot);
+    code.push_back((u1)delta);
+    return *this;
+}
+
+CodeBuilder::Label CodeBuilder::newLabel() {
+    labels.push_back(-1);
+    return (Label)(labels.size() - 1);
+}
+
+void CodeBuilder::bind(Label label) {
+    labels[label] = (int32_t)code.size();
+}
+
+CodeBuilder& CodeBuilder::branch(u1 opcode, Label label) {
+    fixups.push_back(Fixup{(u4)code.size() + 1, (u4)code.size(), label});
+    code.push_back(opcode);
+    putU2(code, 0);
+    return *this;
+}
+
+void CodeBuilder::frame(const std::vector<VerificationType> &locals, const std::vector<VerificationType> &stack) {
+    frames.push_back(Frame{pc(), locals, stack});
+}
+
+std::vector<u1> CodeBuilder::finish() {
+    for (const auto &fixup : fixups) {
+        const int32_t offset = labels[fixup.label] - (int32_t)fixup.from;
+        code[fixup.at] = (u1)((u2)offset >> 8);
+        code[fixup.at + 1] = (u1)offset;
+    }
+    fixups.clear();
+    return code;
+}
+
+
+/****************************************************************************
+ * ClassWriter
+ ****************************************************************************/
+ClassWriter::ClassWriter(const std::string &name, const std::string &superName, u2 accessFlags)
+        : name(name), superName(superName), accessFlags(accessFlags) {
+    thisClass = classRef(name);
+    superClass = superName.empty() ? 0 : classRef(superName);
+}
+
+u2 ClassWriter::constant(const std::string &key, const std::vector<u1> &entry) {
+    auto pos = constantIndex.find(key);
+    if (pos != constantIndex.end()) {
+        return pos->second;
+    }
+    putBytes(constants, entry);
+    constantIndex.emplace(key, constantCount);
+    return constantCount++;
+}
+
+u2 ClassWriter::utf8(const std::string &str) {
+    // 基准测试的名字和描述符都是 ASCII，与 modified UTF-8 相同
+    std::vector<u1> entry{CONSTANT_TAG_UTF8};
+    putU2(entry, (u2)str.size());
+    entry.insert(entry.end(), str.begin(), str.end());
+    return constant(std::string(1, CONSTANT_TAG_UTF8) + str, entry);
+}
+
+u2 ClassWriter::classRef(const std::string &name) {
+    std::vector<u1> entry{CONSTANT_TAG_CLASS};
+    putU2(entry, utf8(name));
+    return constant(std::string(1, CONSTANT_TAG_CLASS) + name, entry);
+}
+
+u2 ClassWriter::nameAndType(const std::string &name, const std::string &descriptor) {
+    std::vector<u1> entry{CONSTANT_TAG_NAME_AND_TYPE};
+    putU2(entry, utf8(name));
+    putU2(entry, utf8(descriptor));
+    return constant(std::string(1, CONSTANT_TAG_NAME_AND_TYPE) + name + ":" + descriptor, entry);
+}
+
+u2 ClassWriter::memberRef(u1 tag, const std::string &owner, const std::string &name, const std::string &descriptor) {
+    std::vector<u1> entry{tag};
+    putU2(entry, classRef(owner));
+    putU2(entry, nameAndType(name, descriptor));
+    return constant(std::string(1, (char)tag) + owner + "." + name + ":" + descriptor, entry);
+}
+
+u2 ClassWriter::fieldRef(const std::string &owner, const std::string &name, const std::string &descriptor) {
+    return memberRef(CONSTANT_TAG_FIELD_REF, owner, name, descriptor);
+}
+
+u2 ClassWriter::methodRef(const std::string &owner, const std::string &name, const std::string &descriptor) {
+    return memberRef(CONSTANT_TAG_METHOD_REF, owner, name, descriptor);
+}
+
+void ClassWriter::addField(u2 accessFlags, const std::string &name, const std::string &descriptor) {
+    putU2(fields, accessFlags);
+    putU2(fields, utf8(name));
+    putU2(fields, utf8(descriptor));
+    putU2(fields, 0);
+    fieldCount++;
+}
+
+void ClassWriter::addMethod(u2 accessFlags, const std::string &name, const std::string &descriptor, u2 maxStack,
+                            u2 maxLocals, CodeBuilder &code, const std::vector<ExceptionEntry> &handlers) {
+    const std::vector<u1> bytes = code.finish();
+    std::vector<u1> stackMap;
+    if (!code.frames.empty()) {
+        putU2(stackMap, (u2)code.frames.size());
+        int32_t previous = -1;
+        for (const auto &frame : code.frames) {
+            stackMap.push_back(STACK_MAP_FULL_FRAME);
+            putU2(stackMap, (u2)(frame.pc - previous - 1));
+            putTypes(stackMap, frame.locals);
+            putTypes(stackMap, frame.stack);
+            previous = frame.pc;
+        }
+    }
+
+    putU2(methods, accessFlags);
+    putU2(methods, utf8(name));
+    putU2(methods, utf8(descriptor));
+    putU2(methods, 1);
+
+    const u2 codeName = utf8("Code");
+    const u2 stackMapName = stackMap.empty() ? (u2)0 : utf8("StackMapTable");
+    putU2(methods, codeName);
+    putU4(methods, (u4)(2 + 2 + 4 + bytes.size() + 2 + 8 * handlers.size() + 2 +
+                        (stackMap.empty() ? 0 : 6 + stackMap.size())));
+    putU2(methods, maxStack);
+    putU2(methods, maxLocals);
+    putU4(methods, (u4)bytes.size());
+    putBytes(methods, bytes);
+    putU2(methods, (u2)handlers.size());
+    for (const auto &handler : handlers) {
+        putU2(methods, handler.startPC);
+        putU2(methods, handler.endPC);
+        putU2(methods, handler.handlerPC);
+        putU2(methods, handler.catchType);
+    }
+    if (stackMap.empty()) {
+        putU2(methods, 0);
+    } else {
+        putU2(methods, 1);
+        putU2(methods, stackMapName);
+        putU4(methods, (u4)stackMap.size());
+        putBytes(methods, stackMap);
+    }
+    methodCount++;
+}
+
+void ClassWriter::addDefaultConstructor() {
+    CodeBuilder code;
+    code.op(op_aload_0).op2(op_invokespecial, methodRef(superName, "<init>", "()V")).op(op_return);
+    addMethod(0x0001, "<init>", "()V", 1, 1, code);
+}
+
+bool ClassWriter::write(const std::string &dir) const {
+    std::vector<u1> out;
+    putU4(out, CLASS_FILE_MAGIC);
+    putU2(out, 0);
+    putU2(out, CLASS_FILE_MAJOR);
+    putU2(out, constantCount);
+    putBytes(out, constants);
+    putU2(out, accessFlags);
+    putU2(out, thisClass);
+    putU2(out, superClass);
+    putU2(out, 0);
+    putU2(out, fieldCount);
+    putBytes(out, fields);
+    putU2(out, methodCount);
+    putBytes(out, methods);
+    putU2(out, 0);
+
+    std::string path = dir;
+    for (std::size_t start = 0, slash; (slash = name.find('/', start)) != std::string::npos; start = slash + 1) {
+        path += "/" + name.substr(start, slash - start);
+        if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+            std::cerr << __func__ << ":Can not create directory " << path << "\n";
+            return false;
+        }
+    }
+    path = dir + "/" + name + ".class";
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << __func__ << ":Can not create class file " << path << "\n";
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    return file.good();
+}
@@ -0,0 +1,135 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_CLASSWRITER_H
+#define CJVM_CLASSWRITER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Type.h"
+
+// StackMapTable 中的验证类型
+class VerificationType {
+public:
+    enum : u1 {
+        ITEM_INTEGER = 1,
+        ITEM_OBJECT = 7
+    };
+
+    u1 tag;
+    // tag 为 ITEM_OBJECT 时为常量池中 CONSTANT_Class 的下标
+    u2 classIndex;
+};
+
+/**
+ * 方法体的字节码，跳转目标用标签表示，finish 时回填 16 位的跳转偏移量。
+ * 跳转目标和异常处理器的入口要用 frame 记录栈帧状态，生成 StackMapTable 供校验器使用
+ */
+class CodeBuilder {
+    friend class ClassWriter;
+
+public:
+    using Label = u4;
+
+    CodeBuilder& op(u1 opcode);
+    CodeBuilder& op1(u1 opcode, u1 operand);
+    CodeBuilder& op2(u1 opcode, u2 operand);
+    CodeBuilder& iinc(u1 slot, int8_t delta);
+
+    Label newLabel();
+    void bind(Label label);
+    CodeBuilder& branch(u1 opcode, Label label);
+
+    // 当前位置的栈帧，没有列出的局部变量为 top
+    void frame(const std::vector<VerificationType> &locals, const std::vector<VerificationType> &stack = {});
+
+    u2 pc() const { return (u2)code.size(); }
+    std::vector<u1> finish();
+
+private:
+    class Fixup {
+    public:
+        // 偏移量所在的位置和跳转指令的 pc
+        u4 at;
+        u4 from;
+        Label label;
+    };
+
+    class Frame {
+    public:
+        u2 pc;
+        std::vector<VerificationType> locals;
+        std::vector<VerificationType> stack;
+    };
+
+    std::vector<u1> code;
+    std::vector<Frame> frames;
+    std::vector<int32_t> labels;
+    std::vector<Fixup> fixups;
+};
+
+/**
+ * 生成 class 文件的最小汇编器，只支持基准测试用到的常量和属性，栈帧一律写成 full_frame
+ */
+class ClassWriter {
+public:
+    class ExceptionEntry {
+    public:
+        u2 startPC;
+        u2 endPC;
+        u2 handlerPC;
+        // 常量池中的 CONSTANT_Class 下标，0 表示捕获所有异常
+        u2 catchType;
+    };
+
+    ClassWriter(const std::string &name, const std::string &superName, u2 accessFlags = 0x0021);
+
+    // 常量池，内容相同的项只添加一次
+    u2 utf8(const std::string &str);
+    u2 classRef(const std::string &name);
+    u2 fieldRef(const std::string &owner, const std::string &name, const std::string &descriptor);
+    u2 methodRef(const std::string &owner, const std::string &name, const std::string &descriptor);
+
+    void addField(u2 accessFlags, const std::string &name, const std::string &descriptor);
+    void addMethod(u2 accessFlags, const std::string &name, const std::string &descriptor, u2 maxStack,
+                   u2 maxLocals, CodeBuilder &code, const std::vector<ExceptionEntry> &handlers = {});
+    // 只调用父类构造函数的 <init>()V
+    void addDefaultConstructor();
+
+    static VerificationType intType() {
+        return VerificationType{VerificationType::ITEM_INTEGER, 0};
+    }
+
+    VerificationType objectType(const std::string &className) {
+        return VerificationType{VerificationType::ITEM_OBJECT, classRef(className)};
+    }
+
+    const std::string& getName() const { return name; }
+
+    // 写入 dir 下按包名组织的子目录，子目录不存在时创建
+    bool write(const std::string &dir) const;
+
+private:
+    u2 constant(const std::string &key, const std::vector<u1> &entry);
+    u2 nameAndType(const std::string &name, const std::string &descriptor);
+    u2 memberRef(u1 tag, const std::string &owner, const std::string &name, const std::string &descriptor);
+
+    std::string name;
+    std::string superName;
+    u2 accessFlags;
+    u2 thisClass;
+    u2 superClass;
+
+    u2 constantCount = 1;
+    std::map<std::string, u2> constantIndex;
+    std::vector<u1> constants;
+    u2 fieldCount = 0;
+    std::vector<u1> fields;
+    u2 methodCount = 0;
+    std::vector<u1> methods;
+};
+
+
+#endif //CJVM_CLASSWRITER_H
@@ -0,0 +1,475 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <functional>
+#include <iostream>
+#include "Workloads.h"
+#include "ClassWriter.h"
+#include "RuntimeEnv.h"
+#include "MethodArea.h"
+#include "JavaClass.h"
+#include "JavaString.h"
+#include "StringTable.h"
+#include "ObjectMonitor.h"
+#include "ArrayOps.h"
+#include "SSA.h"
+#include "Optimizer.h"
+#include "Opcode.h"
+
+#define ACC_PUBLIC_STATIC 0x0009
+#define ALLOC_HEAP_CAPACITY (64*1024*1024)
+
+// 异常处理器方法中嵌套的 try 块个数，以及被查找的 pc
+static const u2 HANDLER_DEPTH = 8;
+static const u2 HANDLER_PCS[] = {1, 13, 24, 46};
+
+static const char* const SHAPE_CLASSES[] = {"bench/Shape", "bench/Square", "bench/Circle", "bench/Triangle"};
+static const char* const EXCEPTION_CLASSES[] = {"java/lang/Throwable", "java/lang/Exception",
+                                                "java/lang/RuntimeException", "bench/E0", "bench/E1", "bench/E2",
+                                                "bench/E3"};
+
+static std::string loadClassName(u4 i) {
+    return "bench/load/C" + std::to_string(i);
+}
+
+/**
+ * static int kernel(T[] a) { int s = 0; for (int i = 0; i < a.length; i++) { T e = a[i]; s += element(e); } return s; }
+ * element 读取局部变量 3 中的 e，向操作数栈压入一个 int
+ */
+static void arrayLoop(CodeBuilder &c, const VerificationType &array,
+                      const std::function<void(CodeBuilder&)> &element) {
+    CodeBuilder::Label body = c.newLabel(), cond = c.newLabel();
+    const std::vector<VerificationType> locals{array, ClassWriter::intType(), ClassWriter::intType()};
+    c.op(op_iconst_0).op(op_istore_1).op(op_iconst_0).op(op_istore_2).branch(op_goto, cond);
+    c.bind(body);
+    c.frame(locals);
+    c.op(op_aload_0).op(op_iload_2).op(op_aaload).op(op_astore_3).op(op_iload_1);
+    element(c);
+    c.op(op_iadd).op(op_istore_1).iinc(2, 1);
+    c.bind(cond);
+    c.frame(locals);
+    c.op(op_iload_2).op(op_aload_0).op(op_arraylength).branch(op_if_icmplt, body);
+    c.op(op_iload_1).op(op_ireturn);
+}
+
+bool Workloads::emitClasses() {
+    std::vector<ClassWriter> classes;
+
+    ClassWriter object("java/lang/Object", "");
+    CodeBuilder ret;
+    ret.op(op_return);
+    object.addMethod(0x0001, "<init>", "()V", 0, 1, ret);
+    classes.push_back(object);
+
+    for (std::size_t i = 0; i < sizeof(EXCEPTION_CLASSES) / sizeof(EXCEPTION_CLASSES[0]); ++i) {
+        ClassWriter exception(EXCEPTION_CLASSES[i], i == 0 ? "java/lang/Object" : EXCEPTION_CLASSES[i - 1]);
+        exception.addDefaultConstructor();
+        classes.push_back(exception);
+    }
+
+    ClassWriter pointClass("bench/Point", "java/lang/Object");
+    pointClass.addField(0x0001, "x", "I");
+    pointClass.addField(0x0001, "y", "I");
+    pointClass.addDefaultConstructor();
+    classes.push_back(pointClass);
+
+    for (int i = 0; i < 4; i++) {
+        ClassWriter shape(SHAPE_CLASSES[i], i == 0 ? "java/lang/Object" : SHAPE_CLASSES[0]);
+        shape.addDefaultConstructor();
+        CodeBuilder area;
+        area.op1(op_bipush, (u1)(i * 3)).op(op_ireturn);
+        shape.addMethod(0x0001, "area", "()I", 1, 1, area);
+        classes.push_back(shape);
+    }
+
+    ClassWriter kernelClass("bench/Kernels", "java/lang/Object");
+    kernelClass.addDefaultConstructor();
+
+    // static int arith(int n) { int s = 0; for (int i = 0; i < n; i++) s = (s * 31 + i) ^ (i >> 3); return s; }
+    CodeBuilder arith;
+    CodeBuilder::Label body = arith.newLabel(), cond = arith.newLabel();
+    const std::vector<VerificationType> ints(3, ClassWriter::intType());
+    arith.op(op_iconst_0).op(op_istore_1).op(op_iconst_0).op(op_istore_2).branch(op_goto, cond);
+    arith.bind(body);
+    arith.frame(ints);
+    arith.op(op_iload_1).op1(op_bipush, 31).op(op_imul).op(op_iload_2).op(op_iadd)
+         .op(op_iload_2).op(op_iconst_3).op(op_ishr).op(op_ixor).op(op_istore_1).iinc(2, 1);
+    arith.bind(cond);
+    arith.frame(ints);
+    arith.op(op_iload_2).op(op_iload_0).branch(op_if_icmplt, body);
+    arith.op(op_iload_1).op(op_ireturn);
+    kernelClass.addMethod(ACC_PUBLIC_STATIC, "arith", "(I)I", 3, 3, arith);
+
+    // static int fields(Point[] a): s += a[i].x + a[i].y
+    pointX = kernelClass.fieldRef("bench/Point", "x", "I");
+    pointY = kernelClass.fieldRef("bench/Point", "y", "I");
+    CodeBuilder fields;
+    arrayLoop(fields, kernelClass.objectType("[Lbench/Point;"), [&](CodeBuilder &c) {
+        c.op(op_aload_3).op2(op_getfield, pointX).op(op_aload_3).op2(op_getfield, pointY).op(op_iadd);
+    });
+    kernelClass.addMethod(ACC_PUBLIC_STATIC, "fields", "([Lbench/Point;)I", 3, 4, fields);
+
+    // static int calls(Shape[] a): s += a[i].area()
+    shapeArea = kernelClass.methodRef("bench/Shape", "area", "()I");
+    CodeBuilder calls;
+    arrayLoop(calls, kernelClass.objectType("[Lbench/Shape;"), [&](CodeBuilder &c) {
+        c.op(op_aload_3).op2(op_invokevirtual, shapeArea);
+    });
+    kernelClass.addMethod(ACC_PUBLIC_STATIC, "calls", "([Lbench/Shape;)I", 3, 4, calls);
+
+    // static int handlers(int n)：HANDLER_DEPTH 层嵌套的 try 块，由内向外依次捕获 E3、E2、E1、E0、
+    // RuntimeException、Exception、Throwable 和任意异常，每层前后各有一条 iinc
+    CodeBuilder handlers;
+    for (u2 i = 0; i < HANDLER_DEPTH * 2; i++) {
+        handlers.iinc(0, 1);
+    }
+    handlers.op(op_iload_0).op(op_ireturn);
+    const u2 handlerPC = handlers.pc();
+    handlers.frame({ClassWriter::intType()}, {kernelClass.objectType("java/lang/Throwable")});
+    handlers.op(op_astore_1).op(op_iload_0).op(op_ireturn);
+    std::vector<ClassWriter::ExceptionEntry> table;
+    const u2 middle = HANDLER_DEPTH * 3;
+    const std::size_t exceptionCount = sizeof(EXCEPTION_CLASSES) / sizeof(EXCEPTION_CLASSES[0]);
+    for (u2 depth = 0; depth < HANDLER_DEPTH; depth++) {
+        const u2 catchType = depth < exceptionCount
+                             ? kernelClass.classRef(EXCEPTION_CLASSES[exceptionCount - 1 - depth]) : (u2)0;
+        table.push_back(ClassWriter::ExceptionEntry{(u2)(middle - 3 * (depth + 1)), (u2)(middle + 3 * (depth + 1)),
+                                                    handlerPC, catchType});
+    }
+    kernelClass.addMethod(ACC_PUBLIC_STATIC, "handlers", "(I)I", 1, 2, handlers, table);
+    classes.push_back(kernelClass);
+
+    // 类加载用的类：四个 int 字段和各自的 getter
+    for (u4 i = 0; i < LOAD_CLASS_COUNT; i++) {
+        const std::string name = loadClassName(i);
+        ClassWriter loaded(name, "java/lang/Object");
+        loaded.addDefaultConstructor();
+        for (int k = 0; k < 4; k++) {
+            const std::string field = "f" + std::to_string(k);
+            loaded.addField(0x0002, field, "I");
+            CodeBuilder getter;
+            getter.op(op_aload_0).op2(op_getfield, loaded.fieldRef(name, field, "I")).op(op_ireturn);
+            loaded.addMethod(0x0001, "get" + std::to_string(k), "()I", 1, 1, getter);
+        }
+        classes.push_back(loaded);
+    }
+
+    for (const auto &c : classes) {
+        if (!c.write(classDir)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+JavaClass* Workloads::load(const char *name) {
+    JavaClass *jc = ma->loadClassIfAbsent(name);
+    if (!jc) {
+        std::cerr << __func__ << ":Failed to load benchmark class " << name << "\n";
+        return nullptr;
+    }
+    ma->linkClassIfAbsent(name);
+    return jc;
+}
+
+std::size_t Workloads::newArray(u1 componentType, int32_t length) {
+    return crt.jheap->allocateArray(currentThread->tlab, componentType, length,
+                                    componentType == T_EXTRA_OBJECT ? point : nullptr);
+}
+
+bool Workloads::prepare() {
+    if (!emitClasses()) {
+        return false;
+    }
+    ma = new MethodArea({classDir});
+    crt.ma = ma;
+
+    kernels = load("bench/Kernels");
+    point = load("bench/Point");
+    if (!kernels || !point) {
+        return false;
+    }
+    for (const char *name : SHAPE_CLASSES) {
+        shapes.push_back(load(name));
+        if (!shapes.back()) {
+            return false;
+        }
+    }
+    for (const char *name : EXCEPTION_CLASSES) {
+        exceptions.push_back(load(name));
+        if (!exceptions.back()) {
+            return false;
+        }
+    }
+    arithMethod = kernels->getMethod("arith", "(I)I");
+    fieldsMethod = kernels->getMethod("fields", "([Lbench/Point;)I");
+    callsMethod = kernels->getMethod("calls", "([Lbench/Shape;)I");
+    handlersMethod = kernels->getMethod("handlers", "(I)I");
+    if (!arithMethod || !fieldsMethod || !callsMethod || !handlersMethod || !handlersMethod->handlers) {
+        std::cerr << __func__ << ":Malformed benchmark class bench/Kernels\n";
+        return false;
+    }
+
+    ThreadLocalAllocBuffer &tlab = currentThread->tlab;
+    const FieldInfo *x = point->getField("x", "I");
+    const FieldInfo *y = point->getField("y", "I");
+    for (u4 i = 0; i < POINT_COUNT; i++) {
+        const std::size_t obj = crt.jheap->allocateObject(tlab, point->getInstanceSize(), point);
+        if (obj == 0) {
+            return false;
+        }
+        *crt.jheap->at<int32_t>(obj + x->offset) = (int32_t)i;
+        *crt.jheap->at<int32_t>(obj + y->offset) = (int32_t)i * 2;
+        crt.jheap->publish(obj);
+        points.push_back(obj);
+    }
+
+    localLock = crt.jheap->allocateObject(tlab, point->getInstanceSize(), point);
+    sharedLock = crt.jheap->allocateObject(tlab, point->getInstanceSize(), point);
+    if (localLock == 0 || sharedLock == 0) {
+        return false;
+    }
+    crt.jheap->publish(sharedLock);
+
+    for (u4 i = 0; i < STRING_COUNT; i++) {
+        literals.push_back("bench/literal/" + std::to_string(i));
+    }
+    const std::string text(64, 'j');
+    stringA = JavaString::create(crt.jheap, tlab, reinterpret_cast<const u1*>(text.data()), text.size(), nullptr);
+    stringB = JavaString::create(crt.jheap, tlab, reinterpret_cast<const u1*>(text.data()), text.size(), nullptr);
+
+    intSrc = newArray(T_INT, INT_COPY_LENGTH);
+    intDst = newArray(T_INT, INT_COPY_LENGTH);
+    refSrc = newArray(T_EXTRA_OBJECT, REFERENCE_COPY_LENGTH);
+    refDst = newArray(T_EXTRA_OBJECT, REFERENCE_COPY_LENGTH);
+    if (stringA == 0 || stringB == 0 || intSrc == 0 || intDst == 0 || refSrc == 0 || refDst == 0) {
+        return false;
+    }
+    auto *refs = reinterpret_cast<HeapRef*>(crt.jheap->arrayElements(refSrc));
+    for (u4 i = 0; i < REFERENCE_COPY_LENGTH; i++) {
+        refs[i] = encodeReference(points[i % POINT_COUNT]);
+    }
+
+    allocHeap = new JavaHeap(ALLOC_HEAP_CAPACITY);
+    return true;
+}
+
+Workloads::~Workloads() {
+    delete allocHeap;
+    if (crt.ma == ma) {
+        crt.ma = nullptr;
+    }
+    delete ma;
+}
+
+void Workloads::addCompile(std::vector<Benchmark> &out, const char *name, const char *description,
+                           MethodInfo *method) {
+    Benchmark b;
+    b.name = name;
+    b.description = description;
+    b.run = [this, method](uint64_t calls) {
+        for (uint64_t i = 0; i < calls; i++) {
+            SSAGraph *graph = SSAGraph::build(kernels, method);
+            if (graph) {
+                Optimizer::run(graph);
+                benchmarkSink = benchmarkSink + graph->nodes.size();
+                delete graph;
+            }
+        }
+    };
+    out.push_back(b);
+}
+
+std::vector<Benchmark> Workloads::benchmarks() {
+    std::vector<Benchmark> out;
+
+    addCompile(out, "compile.arith", "SSA construction and optimization of an arithmetic loop", arithMethod);
+    addCompile(out, "compile.fields", "SSA construction and optimization of a field access loop", fieldsMethod);
+    addCompile(out, "compile.calls", "SSA construction and optimization of a virtual call loop", callsMethod);
+
+    Benchmark field;
+    field.name = "field.get";
+    field.description = "getfield through the constant pool cache";
+    field.opsPerCall = 2;
+    field.run = [this](uint64_t calls) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < calls; i++) {
+            const std::size_t obj = points[i % POINT_COUNT];
+            sum += *crt.jheap->at<int32_t>(obj + kernels->resolveField(pointX)->field->offset);
+            sum += *crt.jheap->at<int32_t>(obj + kernels->resolveField(pointY)->field->offset);
+        }
+        benchmarkSink = benchmarkSink + sum;
+    };
+    out.push_back(field);
+
+    Benchmark invoke;
+    invoke.name = "invoke.virtual";
+    invoke.description = "invokevirtual resolution and receiver method selection";
+    invoke.run = [this](uint64_t calls) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < calls; i++) {
+            const ResolvedMethod *resolved = kernels->resolveMethod(shapeArea);
+            JavaClass *receiver = shapes[1 + i % 3];
+            ResolvedMethod selected;
+            if (receiver->lookupMethod(resolved->jc->getString(resolved->method->nameIndex),
+                                       resolved->jc->getString(resolved->method->descriptorIndex), selected)) {
+                sum += reinterpret_cast<std::uintptr_t>(selected.method);
+            }
+        }
+        benchmarkSink = benchmarkSink + sum;
+    };
+    out.push_back(invoke);
+
+    Benchmark subtype;
+    subtype.name = "typecheck.subtype";
+    subtype.description = "checkcast/instanceof subtype checks";
+    subtype.run = [this](uint64_t calls) {
+        const JavaClass *pairs[][2] = {{exceptions[6], exceptions[3]}, {exceptions[6], exceptions[0]},
+                                       {shapes[1], shapes[0]}, {shapes[2], shapes[3]}};
+        uint64_t hits = 0;
+        for (uint64_t i = 0; i < calls; i++) {
+            hits += pairs[i % 4][0]->isSubtypeOf(pairs[i % 4][1]);
+        }
+        benchmarkSink = benchmarkSink + hits;
+    };
+    out.push_back(subtype);
+
+    Benchmark handler;
+    handler.name = "exception.handler";
+    handler.description = "exception handler lookup in nested try blocks";
+    handler.run = [this](uint64_t calls) {
+        int64_t sum = 0;
+        for (uint64_t i = 0; i < calls; i++) {
+            const u2 pc = HANDLER_PCS[i % 4];
+            const JavaClass *thrown = exceptions[3 + (i / 4) % 4];
+            sum += handlersMethod->handlers->findHandler(kernels, pc, thrown);
+        }
+        benchmarkSink = benchmarkSink + (uint64_t)sum;
+    };
+    out.push_back(handler);
+
+    Benchmark allocObject;
+    allocObject.name = "alloc.object";
+    allocObject.description = "TLAB allocation of a small object, heap discarded when full";
+    allocObject.run = [this](uint64_t calls) {
+        const u4 size = point->getInstanceSize();
+        for (uint64_t i = 0; i < calls; i++) {
+            std::size_t obj = allocHeap->allocateObject(allocTlab, size, point);
+            if (obj == 0) {
+                delete allocHeap;
+                allocHeap = new JavaHeap(ALLOC_HEAP_CAPACITY);
+                allocTlab.retire();
+                obj = allocHeap->allocateObject(allocTlab, size, point);
+            }
+            benchmarkSink = benchmarkSink + obj;
+        }
+    };
+    out.push_back(allocObject);
+
+    Benchmark allocArray;
+    allocArray.name = "alloc.array";
+    allocArray.description = "TLAB allocation of an int[16], heap discarded when full";
+    allocArray.run = [this](uint64_t calls) {
+        for (uint64_t i = 0; i < calls; i++) {
+            std::size_t array = allocHeap->allocateArray(allocTlab, T_INT, 16);
+            if (array == 0) {
+                delete allocHeap;
+                allocHeap = new JavaHeap(ALLOC_HEAP_CAPACITY);
+                allocTlab.retire();
+                array = allocHeap->allocateArray(allocTlab, T_INT, 16);
+            }
+            benchmarkSink = benchmarkSink + array;
+        }
+    };
+    out.push_back(allocArray);
+
+    Benchmark monitorLocal;
+    monitorLocal.name = "monitor.local";
+    monitorLocal.description = "uncontended monitorenter/monitorexit on an unpublished object";
+    monitorLocal.run = [this](uint64_t calls) {
+        for (uint64_t i = 0; i < calls; i++) {
+            ObjectSynchronizer::enter(currentThread, localLock);
+            ObjectSynchronizer::exit(currentThread, localLock);
+        }
+    };
+    out.push_back(monitorLocal);
+
+    Benchmark monitorShared;
+    monitorShared.name = "monitor.shared";
+    monitorShared.description = "uncontended monitorenter/monitorexit on a published object";
+    monitorShared.run = [this](uint64_t calls) {
+        for (uint64_t i = 0; i < calls; i++) {
+            ObjectSynchronizer::enter(currentThread, sharedLock);
+            ObjectSynchronizer::exit(currentThread, sharedLock);
+        }
+    };
+    out.push_back(monitorShared);
+
+    Benchmark copyInt;
+    copyInt.name = "arraycopy.int";
+    copyInt.description = "System.arraycopy of an int[1024]";
+    copyInt.run = [this](uint64_t calls) {
+        for (uint64_t i = 0; i < calls; i++) {
+            ArrayOps::copy(crt.jheap->arrayElements(intDst), crt.jheap->arrayElements(intSrc),
+                           INT_COPY_LENGTH * sizeof(int32_t));
+        }
+    };
+    out.push_back(copyInt);
+
+    Benchmark copyReference;
+    copyReference.name = "arraycopy.reference";
+    copyReference.description = "System.arraycopy of an Object[256] with GC barriers";
+    copyReference.run = [this](uint64_t calls) {
+        auto *dst = reinterpret_cast<HeapRef*>(crt.jheap->arrayElements(refDst));
+        auto *src = reinterpret_cast<const HeapRef*>(crt.jheap->arrayElements(refSrc));
+        for (uint64_t i = 0; i < calls; i++) {
+            ArrayOps::copyReferences(crt.gc, dst, src, REFERENCE_COPY_LENGTH);
+        }
+    };
+    out.push_back(copyReference);
+
+    Benchmark intern;
+    intern.name = "string.intern";
+    intern.description = "string table lookup of an interned literal";
+    intern.run = [this](uint64_t calls) {
+        for (uint64_t i = 0; i < calls; i++) {
+            const std::string &literal = literals[i % STRING_COUNT];
+            benchmarkSink = benchmarkSink + crt.stringTable->intern(
+                    currentThread->tlab, reinterpret_cast<const u1*>(literal.data()), literal.size(), nullptr);
+        }
+    };
+    out.push_back(intern);
+
+    Benchmark equals;
+    equals.name = "string.equals";
+    equals.description = "String.equals on two distinct 64 character strings";
+    equals.run = [this](uint64_t calls) {
+        uint64_t hits = 0;
+        for (uint64_t i = 0; i < calls; i++) {
+            hits += JavaString::equals(crt.jheap, stringA, stringB);
+        }
+        benchmarkSink = benchmarkSink + hits;
+    };
+    out.push_back(equals);
+
+    Benchmark classLoad;
+    classLoad.name = "classload";
+    classLoad.description = "loading and linking classes from a directory class path";
+    classLoad.opsPerCall = LOAD_CLASS_COUNT;
+    classLoad.run = [this](uint64_t calls) {
+        for (uint64_t i = 0; i < calls; i++) {
+            MethodArea area({classDir});
+            crt.ma = &area;
+            for (u4 k = 0; k < LOAD_CLASS_COUNT; k++) {
+                const std::string name = loadClassName(k);
+                benchmarkSink = benchmarkSink + (uint64_t)(area.loadClassIfAbsent(name.c_str()) != nullptr);
+                area.linkClassIfAbsent(name.c_str());
+            }
+            crt.ma = ma;
+        }
+    };
+    out.push_back(classLoad);
+
+    return out;
+}
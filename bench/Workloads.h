@@ -0,0 +1,88 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_WORKLOADS_H
+#define CJVM_WORKLOADS_H
+
+#include <string>
+#include <vector>
+#include "Type.h"
+#include "JavaHeap.h"
+#include "Benchmark.h"
+
+class MethodArea;
+class JavaClass;
+class MethodInfo;
+
+/**
+ * cjvm-bench 的基准测试集
+ *
+ * 用到的类由 ClassWriter 生成到 classDir 中，再由虚拟机自己的类加载器加载：
+ *  - bench/Kernels: 算术循环、字段读取循环、虚调用循环和带多层异常处理器的方法
+ *  - bench/Point、bench/Shape 及其三个子类、bench/E0..E3 异常层次
+ *  - bench/load/C0..C127: 测试类加载用的类
+ *
+ * 还没有执行引擎，每个基准测试衡量的是解释器和编译器执行相应字节码时依赖的运行时操作
+ */
+class Workloads {
+public:
+    explicit Workloads(const std::string &classDir) : classDir(classDir) {}
+    ~Workloads();
+
+    Workloads(const Workloads&) = delete;
+    Workloads& operator=(const Workloads&) = delete;
+
+    // 生成并加载基准测试用的类，失败返回 false
+    bool prepare();
+    std::vector<Benchmark> benchmarks();
+
+private:
+    enum : u4 {
+        LOAD_CLASS_COUNT = 128,
+        POINT_COUNT = 64,
+        STRING_COUNT = 64,
+        INT_COPY_LENGTH = 1024,
+        REFERENCE_COPY_LENGTH = 256
+    };
+
+    bool emitClasses();
+    JavaClass* load(const char *name);
+    std::size_t newArray(u1 componentType, int32_t length);
+
+    void addCompile(std::vector<Benchmark> &out, const char *name, const char *description, MethodInfo *method);
+
+    std::string classDir;
+    MethodArea *ma = nullptr;
+
+    JavaClass *kernels = nullptr;
+    JavaClass *point = nullptr;
+    std::vector<JavaClass*> shapes;
+    std::vector<JavaClass*> exceptions;
+    MethodInfo *arithMethod = nullptr;
+    MethodInfo *fieldsMethod = nullptr;
+    MethodInfo *callsMethod = nullptr;
+    MethodInfo *handlersMethod = nullptr;
+    // Kernels 常量池中 Point.x、Point.y 和 Shape.area 的下标
+    u2 pointX = 0;
+    u2 pointY = 0;
+    u2 shapeArea = 0;
+
+    std::vector<std::size_t> points;
+    std::size_t localLock = 0;
+    std::size_t sharedLock = 0;
+    std::vector<std::string> literals;
+    std::size_t stringA = 0;
+    std::size_t stringB = 0;
+    std::size_t intSrc = 0;
+    std::size_t intDst = 0;
+    std::size_t refSrc = 0;
+    std::size_t refDst = 0;
+
+    // 分配基准测试独占的堆，满了之后整个丢弃重建
+    JavaHeap *allocHeap = nullptr;
+    ThreadLocalAllocBuffer allocTlab;
+};
+
+
+#endif //CJVM_WORKLOADS_H
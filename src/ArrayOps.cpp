@@ -0,0 +1,340 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cstring>
+#include "ArrayOps.h"
+#include "Opcode.h"
+#include "GC.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define ARRAYOPS_X86
+#endif
+
+namespace {
+
+    inline int32_t loadElement(u1 componentType, const u1 *data, int32_t i) {
+        switch (componentType) {
+            case ArrayOps::LATIN1_CHAR:
+                return data[i];
+            case T_BOOLEAN:
+                return data[i] ? 1231 : 1237;
+            case T_BYTE:
+                return (int8_t)data[i];
+            case T_CHAR:
+                return ((const uint16_t*)data)[i];
+            case T_SHORT:
+                return ((const int16_t*)data)[i];
+            case T_FLOAT: {
+                // Float.floatToIntBits，所有 NaN 归一为 0x7fc00000
+                float f = ((const float*)data)[i];
+                int32_t bits;
+                memcpy(&bits, &f, sizeof(bits));
+                return f != f ? 0x7fc00000 : bits;
+            }
+            case T_LONG: {
+                uint64_t v = ((const uint64_t*)data)[i];
+                return (int32_t)(v ^ (v >> 32));
+            }
+            case T_DOUBLE: {
+                double d = ((const double*)data)[i];
+                uint64_t bits;
+                memcpy(&bits, &d, sizeof(bits));
+                if (d != d) {
+                    bits = 0x7ff8000000000000ULL;
+                }
+                return (int32_t)(bits ^ (bits >> 32));
+            }
+            default:
+                return ((const int32_t*)data)[i];
+        }
+    }
+
+    uint32_t hashTail(uint32_t h, u1 componentType, const u1 *data, int32_t from, int32_t length) {
+        for (int32_t i = from; i < length; ++i) {
+            h = 31 * h + (uint32_t)loadElement(componentType, data, i);
+        }
+        return h;
+    }
+
+
+    /************************************************************************
+     * 标量实现
+     ************************************************************************/
+    void copyScalar(u1 *dst, const u1 *src, std::size_t bytes) {
+        memmove(dst, src, bytes);
+    }
+
+    void fillScalar(u1 *dst, uint64_t value, std::size_t elementSize, std::size_t count) {
+        if (elementSize == 1) {
+            memset(dst, (int)(value & 0xFF), count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            memcpy(dst + i * elementSize, &value, elementSize);
+        }
+    }
+
+    int64_t mismatchScalar(const u1 *a, const u1 *b, std::size_t bytes) {
+        for (std::size_t i = 0; i < bytes; ++i) {
+            if (a[i] != b[i]) {
+                return (int64_t)i;
+            }
+        }
+        return -1;
+    }
+
+    int32_t hashScalar(u1 componentType, const u1 *data, int32_t length, uint32_t initial) {
+        return (int32_t)hashTail(initial, componentType, data, 0, length);
+    }
+
+
+#ifdef ARRAYOPS_X86
+    /************************************************************************
+     * SSE2 实现
+     ************************************************************************/
+    void copySSE2(u1 *dst, const u1 *src, std::size_t bytes) {
+        if (dst > src && dst < src + bytes) {
+            // 目标在源之后且重叠，从尾部向前复制，剩下的头部交给 memmove
+            while (bytes >= 16) {
+                bytes -= 16;
+                _mm_storeu_si128((__m128i*)(dst + bytes), _mm_loadu_si128((const __m128i*)(src + bytes)));
+            }
+            copyScalar(dst, src, bytes);
+            return;
+        }
+
+        std::size_t i = 0;
+        for (; i + 16 <= bytes; i += 16) {
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_loadu_si128((const __m128i*)(src + i)));
+        }
+        copyScalar(dst + i, src + i, bytes - i);
+    }
+
+    __m128i broadcastSSE2(uint64_t value, std::size_t elementSize) {
+        switch (elementSize) {
+            case 1: return _mm_set1_epi8((char)value);
+            case 2: return _mm_set1_epi16((short)value);
+            case 4: return _mm_set1_epi32((int)value);
+            default: return _mm_set1_epi64x((long long)value);
+        }
+    }
+
+    void fillSSE2(u1 *dst, uint64_t value, std::size_t elementSize, std::size_t count) {
+        const __m128i v = broadcastSSE2(value, elementSize);
+        std::size_t bytes = elementSize * count;
+        std::size_t i = 0;
+        for (; i + 16 <= bytes; i += 16) {
+            _mm_storeu_si128((__m128i*)(dst + i), v);
+        }
+        fillScalar(dst + i, value, elementSize, (bytes - i) / elementSize);
+    }
+
+    int64_t mismatchSSE2(const u1 *a, const u1 *b, std::size_t bytes) {
+        std::size_t i = 0;
+        for (; i + 16 <= bytes; i += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+            __m128i y = _mm_loadu_si128((const __m128i*)(b + i));
+            unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+            if (mask != 0xFFFF) {
+                return (int64_t)(i + __builtin_ctz(~mask));
+            }
+        }
+        int64_t tail = mismatchScalar(a + i, b + i, bytes - i);
+        return tail < 0 ? -1 : (int64_t)i + tail;
+    }
+
+
+    /************************************************************************
+     * AVX2 实现
+     ************************************************************************/
+    __attribute__((target("avx2")))
+    void copyAVX2(u1 *dst, const u1 *src, std::size_t bytes) {
+        if (dst > src && dst < src + bytes) {
+            while (bytes >= 32) {
+                bytes -= 32;
+                _mm256_storeu_si256((__m256i*)(dst + bytes), _mm256_loadu_si256((const __m256i*)(src + bytes)));
+            }
+            copyScalar(dst, src, bytes);
+            return;
+        }
+
+        std::size_t i = 0;
+        for (; i + 64 <= bytes; i += 64) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(src + i));
+            __m256i y = _mm256_loadu_si256((const __m256i*)(src + i + 32));
+            _mm256_storeu_si256((__m256i*)(dst + i), x);
+            _mm256_storeu_si256((__m256i*)(dst + i + 32), y);
+        }
+        for (; i + 32 <= bytes; i += 32) {
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_loadu_si256((const __m256i*)(src + i)));
+        }
+        copyScalar(dst + i, src + i, bytes - i);
+    }
+
+    __attribute__((target("avx2")))
+    void fillAVX2(u1 *dst, uint64_t value, std::size_t elementSize, std::size_t count) {
+        __m256i v;
+        switch (elementSize) {
+            case 1: v = _mm256_set1_epi8((char)value); break;
+            case 2: v = _mm256_set1_epi16((short)value); break;
+            case 4: v = _mm256_set1_epi32((int)value); break;
+            default: v = _mm256_set1_epi64x((long long)value); break;
+        }
+        std::size_t bytes = elementSize * count;
+        std::size_t i = 0;
+        for (; i + 32 <= bytes; i += 32) {
+            _mm256_storeu_si256((__m256i*)(dst + i), v);
+        }
+        fillScalar(dst + i, value, elementSize, (bytes - i) / elementSize);
+    }
+
+    __attribute__((target("avx2")))
+    int64_t mismatchAVX2(const u1 *a, const u1 *b, std::size_t bytes) {
+        std::size_t i = 0;
+        for (; i + 32 <= bytes; i += 32) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+            __m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+            unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+            if (mask != 0xFFFFFFFFu) {
+                return (int64_t)(i + __builtin_ctz(~mask));
+            }
+        }
+        int64_t tail = mismatchSSE2(a + i, b + i, bytes - i);
+        return tail < 0 ? -1 : (int64_t)i + tail;
+    }
+
+    /**
+     * h = 31 * h + e 逐个展开后，8 个元素一组：每个通道 acc = acc * 31^8 + e，
+     * 最后 h = h * 31^(8m) + sum(acc[k] * 31^(7-k))，全部按 32 位回绕计算
+     */
+    __attribute__((target("avx2")))
+    int32_t hashAVX2(u1 componentType, const u1 *data, int32_t length, uint32_t initial) {
+        if (componentType != ArrayOps::LATIN1_CHAR && componentType != T_BYTE && componentType != T_CHAR &&
+            componentType != T_SHORT && componentType != T_INT) {
+            return hashScalar(componentType, data, length, initial);
+        }
+
+        const uint32_t p8 = 31u * 31 * 31 * 31 * 31 * 31 * 31 * 31;
+        const __m256i mul = _mm256_set1_epi32((int)p8);
+        __m256i acc = _mm256_setzero_si256();
+        uint32_t h = initial;
+
+        int32_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            __m256i v;
+            switch (componentType) {
+                case ArrayOps::LATIN1_CHAR:
+                    v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(data + i)));
+                    break;
+                case T_BYTE:
+                    v = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(data + i)));
+                    break;
+                case T_CHAR:
+                    v = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(data + i * 2)));
+                    break;
+                case T_SHORT:
+                    v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(data + i * 2)));
+                    break;
+                default:
+                    v = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+                    break;
+            }
+            acc = _mm256_add_epi32(_mm256_mullo_epi32(acc, mul), v);
+            h *= p8;
+        }
+
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256((__m256i*)lanes, acc);
+        uint32_t weight = 1;
+        for (int k = 7; k >= 0; --k) {
+            h += lanes[k] * weight;
+            weight *= 31;
+        }
+        return (int32_t)hashTail(h, componentType, data, i, length);
+    }
+#endif
+}
+
+
+ArrayOps::Kernels ArrayOps::selectKernels() {
+#ifdef ARRAYOPS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernels{copyAVX2, fillAVX2, mismatchAVX2, hashAVX2};
+    }
+    return Kernels{copySSE2, fillSSE2, mismatchSSE2, hashScalar};
+#else
+    return Kernels{copyScalar, fillScalar, mismatchScalar, hashScalar};
+#endif
+}
+
+const ArrayOps::Kernels ArrayOps::kernels = ArrayOps::selectKernels();
+
+
+int32_t ArrayOps::compare(u1 componentType, const u1 *a, int32_t lengthA, const u1 *b, int32_t lengthB) {
+    std::size_t elementSize = componentType == T_BOOLEAN || componentType == T_BYTE ? 1
+            : componentType == T_CHAR || componentType == T_SHORT ? 2
+            : componentType == T_LONG || componentType == T_DOUBLE ? 8 : 4;
+    int32_t length = lengthA < lengthB ? lengthA : lengthB;
+
+    int64_t i = kernels.mismatch(a, b, length * elementSize);
+    if (i < 0) {
+        return lengthA - lengthB;
+    }
+    i /= elementSize;
+
+    switch (componentType) {
+        case T_BOOLEAN:
+            return (a[i] != 0) - (b[i] != 0);
+        case T_BYTE:
+            return (int8_t)a[i] - (int8_t)b[i];
+        case T_CHAR:
+            return ((const uint16_t*)a)[i] - ((const uint16_t*)b)[i];
+        case T_SHORT:
+            return ((const int16_t*)a)[i] - ((const int16_t*)b)[i];
+        case T_INT: {
+            int32_t x = ((const int32_t*)a)[i], y = ((const int32_t*)b)[i];
+            return x < y ? -1 : 1;
+        }
+        case T_LONG: {
+            int64_t x = ((const int64_t*)a)[i], y = ((const int64_t*)b)[i];
+            return x < y ? -1 : 1;
+        }
+        case T_FLOAT: {
+            // Float.compare：-0.0 小于 0.0，NaN 大于一切且等于自身
+            float x = ((const float*)a)[i], y = ((const float*)b)[i];
+            if (x < y) return -1;
+            if (x > y) return 1;
+            int32_t xb = loadElement(T_FLOAT, a, (int32_t)i), yb = loadElement(T_FLOAT, b, (int32_t)i);
+            return xb == yb ? 0 : (xb < yb ? -1 : 1);
+        }
+        default: {
+            double x = ((const double*)a)[i], y = ((const double*)b)[i];
+            if (x < y) return -1;
+            if (x > y) return 1;
+            int64_t xb, yb;
+            memcpy(&xb, &x, sizeof(xb));
+            memcpy(&yb, &y, sizeof(yb));
+            if (x != x) xb = 0x7ff8000000000000LL;
+            if (y != y) yb = 0x7ff8000000000000LL;
+            return xb == yb ? 0 : (xb < yb ? -1 : 1);
+        }
+    }
+}
+
+int32_t ArrayOps::hash(u1 componentType, const u1 *data, int32_t length) {
+    return kernels.hash(componentType, data, length, 1);
+}
+
+int32_t ArrayOps::hashString(const u1 *value, int32_t length, bool latin1) {
+    return kernels.hash(latin1 ? LATIN1_CHAR : (u1)T_CHAR, value, length, 0);
+}
+
+void ArrayOps::copyReferences(ConcurrentGC *gc, HeapRef *dst, const HeapRef *src, std::size_t count) {
+    if (gc && gc->isMarking()) {
+        gc->satbEnqueue(dst, count);
+    }
+    kernels.copy(reinterpret_cast<u1*>(dst), reinterpret_cast<const u1*>(src), count * sizeof(HeapRef));
+}
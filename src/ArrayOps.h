@@ -0,0 +1,71 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_ARRAYOPS_H
+#define CJVM_ARRAYOPS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Type.h"
+#include "JavaHeap.h"
+
+class ConcurrentGC;
+
+/**
+ * 数组批量操作，直接作用于堆上的数组元素
+ *
+ * 启动时检测 CPU，支持 AVX2 时用 256 位向量，否则用 x86-64 必备的 SSE2，其它平台退化为标量实现
+ */
+class ArrayOps {
+public:
+    // hash 的元素类型之外额外支持的一种：无符号扩展的字节，即 Latin-1 字符
+    static const u1 LATIN1_CHAR = 0;
+
+    // 按 memmove 的语义复制，源和目标可以重叠
+    static void copy(u1 *dst, const u1 *src, std::size_t bytes) {
+        kernels.copy(dst, src, bytes);
+    }
+
+    // 用 value 的低 elementSize 个字节填充 count 个元素，elementSize 为 1/2/4/8
+    static void fill(u1 *dst, uint64_t value, std::size_t elementSize, std::size_t count) {
+        kernels.fill(dst, value, elementSize, count);
+    }
+
+    static bool equals(const u1 *a, const u1 *b, std::size_t bytes) {
+        return kernels.mismatch(a, b, bytes) < 0;
+    }
+
+    // 返回第一个不同字节的下标，完全相同时返回 -1
+    static int64_t mismatch(const u1 *a, const u1 *b, std::size_t bytes) {
+        return kernels.mismatch(a, b, bytes);
+    }
+
+    // 按 java.util.Arrays.compare 的语义比较两个基本类型数组
+    static int32_t compare(u1 componentType, const u1 *a, int32_t lengthA, const u1 *b, int32_t lengthB);
+
+    // 按 java.util.Arrays.hashCode 的语义计算基本类型数组的哈希值
+    static int32_t hash(u1 componentType, const u1 *data, int32_t length);
+
+    // 按 java.lang.String.hashCode 的语义计算字符串内容的哈希值，latin1 为 false 时 value 为 UTF-16
+    static int32_t hashString(const u1 *value, int32_t length, bool latin1);
+
+    // 引用数组的复制：并发标记期间先把会被覆盖的引用整段交给 GC 的写屏障，再整段复制
+    static void copyReferences(ConcurrentGC *gc, HeapRef *dst, const HeapRef *src, std::size_t count);
+
+private:
+    class Kernels {
+    public:
+        void (*copy)(u1 *dst, const u1 *src, std::size_t bytes);
+        void (*fill)(u1 *dst, uint64_t value, std::size_t elementSize, std::size_t count);
+        int64_t (*mismatch)(const u1 *a, const u1 *b, std::size_t bytes);
+        // 4 字节以下的整数元素以 int32 累加，每个元素先按 componentType 扩展
+        int32_t (*hash)(u1 componentType, const u1 *data, int32_t length, uint32_t initial);
+    };
+
+    static Kernels selectKernels();
+    static const Kernels kernels;
+};
+
+
+#endif //CJVM_ARRAYOPS_H
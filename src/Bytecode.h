@@ -0,0 +1,95 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_BYTECODE_H
+#define CJVM_BYTECODE_H
+
+#include "Type.h"
+#include "Opcode.h"
+
+/**
+ * 字节码指令的长度(包含操作码)
+ *
+ * 定长指令查表，tableswitch/lookupswitch/wide 的长度取决于操作数，表中记为 0
+ */
+static const u1 BYTECODE_LENGTH[256] = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,     // nop - dconst_1
+        2, 3, 2, 3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,     // bipush - lload_1
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,     // lload_2 - laload
+        1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1,     // faload - lstore_0
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,     // lstore_1 - iastore
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,     // lastore - swap
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,     // iadd - ddiv
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,     // irem - land
+        1, 1, 1, 1, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,     // ior - d2l
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3, 3,     // d2f - if_icmpeq
+        3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 0, 0, 1, 1, 1, 1,     // if_icmpne - dreturn
+        1, 1, 3, 3, 3, 3, 3, 3, 3, 5, 5, 3, 2, 3, 1, 1,     // areturn - athrow
+        3, 3, 1, 1, 0, 4, 3, 3, 5, 5, 0, 0, 0, 0, 0, 0,     // checkcast - breakpoint
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+inline int32_t readBytecodeS4(const u1 *p) {
+    return (int32_t)(((u4)p[0] << 24) | ((u4)p[1] << 16) | ((u4)p[2] << 8) | (u4)p[3]);
+}
+
+inline int16_t readBytecodeS2(const u1 *p) {
+    return (int16_t)(((u2)p[0] << 8) | (u2)p[1]);
+}
+
+inline u2 readBytecodeU2(const u1 *p) {
+    return (u2)(((u2)p[0] << 8) | (u2)p[1]);
+}
+
+/**
+ * pc 处指令的长度，指令非法或者超出了 codeLength 时返回 0
+ */
+inline u4 bytecodeLength(const u1 *code, u4 pc, u4 codeLength) {
+    const u1 opcode = code[pc];
+    u4 length = BYTECODE_LENGTH[opcode];
+    if (length == 0) {
+        switch (opcode) {
+            case op_tableswitch: {
+                // 操作码之后填充到 4 字节对齐，然后是 default、low、high 和 high-low+1 个跳转偏移
+                u4 base = (pc + 4) & ~3u;
+                if (base + 12 > codeLength) {
+                    return 0;
+                }
+                int64_t low = readBytecodeS4(code + base + 4);
+                int64_t high = readBytecodeS4(code + base + 8);
+                if (high < low) {
+                    return 0;
+                }
+                length = (u4)(base - pc + 12 + (high - low + 1) * 4);
+                break;
+            }
+            case op_lookupswitch: {
+                // 填充之后是 default、npairs 和 npairs 个 match-offset 对
+                u4 base = (pc + 4) & ~3u;
+                if (base + 8 > codeLength) {
+                    return 0;
+                }
+                int32_t npairs = readBytecodeS4(code + base + 4);
+                if (npairs < 0) {
+                    return 0;
+                }
+                length = (u4)(base - pc + 8 + (int64_t)npairs * 8);
+                break;
+            }
+            case op_wide:
+                if (pc + 1 >= codeLength) {
+                    return 0;
+                }
+                length = code[pc + 1] == op_iinc ? 6 : 4;
+                break;
+            default:
+                return 0;
+        }
+    }
+    return (uint64_t)pc + length <= codeLength ? length : 0;
+}
+
+#endif //CJVM_BYTECODE_H
@@ -0,0 +1,348 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ClassArchive.h"
+#include "ClassPath.h"
+
+#define CLASS_ARCHIVE_MAGIC 0x43444A43   // "CJDC"
+#define CLASS_ARCHIVE_VERSION 3
+
+class ClassArchive::ArchiveHeader {
+public:
+    u4 magic;
+    u4 version;
+    u4 classCount;
+    u4 classPathHash;
+    u4 sourceCount;
+    u4 reserved;
+    // 整个文件的大小，用来发现被截断的归档
+    uint64_t archiveSize;
+};
+
+class ClassArchive::ArchiveEntry {
+public:
+    u4 nameHash;
+    u4 nameOffset;
+    u4 nameLength;
+    u4 flags;
+    uint64_t dataOffset;
+    uint64_t dataLength;
+    // 在 SourceStamp 表中的下标
+    u4 sourceIndex;
+    u4 reserved;
+};
+
+// 转储时文件的状态
+class ClassArchive::SourceStamp {
+public:
+    u4 pathOffset;
+    u4 pathLength;
+    // 转储时不存在的文件为 MISSING_SIZE
+    uint64_t size;
+    // 纳秒
+    int64_t mtime;
+};
+
+// FNV-1a
+u4 ClassArchive::hashName(const char *name, std::size_t length) {
+    u4 h = 2166136261u;
+    for (std::size_t i = 0; i < length; ++i) {
+        h = (h ^ (u1)name[i]) * 16777619u;
+    }
+    return h;
+}
+
+#define MISSING_SIZE UINT64_MAX
+
+static inline uint64_t alignTo8(uint64_t n) {
+    return (n + 7) & ~(uint64_t)7;
+}
+
+bool ClassArchive::statSource(const std::string &path, uint64_t &size, int64_t &mtime) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    size = (uint64_t)st.st_size;
+    mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    return true;
+}
+
+
+/****************************************************************************
+ * 转储
+ ****************************************************************************/
+bool ClassArchive::Writer::addSource(const std::string &path, bool allowMissing, u4 &index) {
+    auto pos = sourceIndex.find(path);
+    if (pos != sourceIndex.end()) {
+        index = pos->second;
+        return true;
+    }
+    PendingSource s;
+    s.path = path;
+    if (!statSource(path, s.size, s.mtime)) {
+        if (!allowMissing) {
+            return false;
+        }
+        s.size = MISSING_SIZE;
+        s.mtime = 0;
+    }
+    index = (u4)sources.size();
+    sourceIndex.emplace(path, index);
+    sources.push_back(std::move(s));
+    return true;
+}
+
+bool ClassArchive::Writer::add(const std::string &name, const u1 *bytes, std::size_t length, u4 flags,
+                               const std::string &source) {
+    u4 index;
+    if (!addSource(source, false, index)) {
+        return false;
+    }
+
+    PendingClass c;
+    c.name = name;
+    c.bytes.assign(bytes, bytes + length);
+    c.flags = flags;
+    c.sourceIndex = index;
+    classes.push_back(std::move(c));
+    return true;
+}
+
+bool ClassArchive::Writer::write(const std::string &path, const std::string &classPathString,
+                                 const ClassPath &classPath) {
+    // 类路径条目和目录条目下的包目录，映射时只需要 stat 它们就能发现类被前面的条目遮蔽
+    std::vector<std::string> packages;
+    for (const auto &c : classes) {
+        std::size_t slash = c.name.rfind('/');
+        if (slash != std::string::npos) {
+            packages.push_back(c.name.substr(0, slash));
+        }
+    }
+    std::sort(packages.begin(), packages.end());
+    packages.erase(std::unique(packages.begin(), packages.end()), packages.end());
+    u4 index;
+    for (const ClassPathEntry *entry : classPath.getEntries()) {
+        addSource(entry->getPath(), true, index);
+        if (dynamic_cast<const DirectoryEntry*>(entry)) {
+            for (const auto &package : packages) {
+                addSource(entry->getPath() + "/" + package, true, index);
+            }
+        }
+    }
+
+    std::sort(classes.begin(), classes.end(), [](const PendingClass &a, const PendingClass &b) {
+        u4 x = hashName(a.name.data(), a.name.size());
+        u4 y = hashName(b.name.data(), b.name.size());
+        return x != y ? x < y : a.name < b.name;
+    });
+
+    std::vector<ArchiveEntry> table(classes.size());
+    uint64_t nameOffset = sizeof(ArchiveHeader) + sizeof(ArchiveEntry) * classes.size() +
+                          sizeof(SourceStamp) * sources.size();
+    uint64_t namesEnd = nameOffset;
+    for (const auto &c : classes) {
+        namesEnd += c.name.size();
+    }
+    std::vector<SourceStamp> stamps(sources.size());
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        stamps[i].pathOffset = (u4)namesEnd;
+        stamps[i].pathLength = (u4)sources[i].path.size();
+        stamps[i].size = sources[i].size;
+        stamps[i].mtime = sources[i].mtime;
+        namesEnd += sources[i].path.size();
+    }
+    if (namesEnd > UINT32_MAX) {
+        std::cerr << __func__ << ":Too many classes for class archive " << path << "\n";
+        return false;
+    }
+
+    uint64_t dataOffset = alignTo8(namesEnd);
+    for (std::size_t i = 0; i < classes.size(); ++i) {
+        table[i].nameHash = hashName(classes[i].name.data(), classes[i].name.size());
+        table[i].nameOffset = (u4)nameOffset;
+        table[i].nameLength = (u4)classes[i].name.size();
+        table[i].flags = classes[i].flags;
+        table[i].dataOffset = dataOffset;
+        table[i].dataLength = classes[i].bytes.size();
+        table[i].sourceIndex = classes[i].sourceIndex;
+        nameOffset += classes[i].name.size();
+        dataOffset = alignTo8(dataOffset + classes[i].bytes.size());
+    }
+
+    ArchiveHeader h{};
+    h.magic = CLASS_ARCHIVE_MAGIC;
+    h.version = CLASS_ARCHIVE_VERSION;
+    h.classCount = (u4)classes.size();
+    h.classPathHash = hashName(classPathString.data(), classPathString.size());
+    h.sourceCount = (u4)sources.size();
+    h.archiveSize = dataOffset;
+
+    // 先写临时文件再改名，正在映射旧归档的进程不受影响
+    std::string tmpPath = path + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << __func__ << ":Can not create class archive " << path << "\n";
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(table.data()), sizeof(ArchiveEntry) * table.size());
+    out.write(reinterpret_cast<const char*>(stamps.data()), sizeof(SourceStamp) * stamps.size());
+    for (const auto &c : classes) {
+        out.write(c.name.data(), c.name.size());
+    }
+    for (const auto &s : sources) {
+        out.write(s.path.data(), s.path.size());
+    }
+    const char padding[8] = {0};
+    out.write(padding, alignTo8(namesEnd) - namesEnd);
+    for (const auto &c : classes) {
+        out.write(reinterpret_cast<const char*>(c.bytes.data()), c.bytes.size());
+        out.write(padding, alignTo8(c.bytes.size()) - c.bytes.size());
+    }
+    out.close();
+    if (!out) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+
+/****************************************************************************
+ * 加载
+ ****************************************************************************/
+ClassArchive::~ClassArchive() {
+    if (base) {
+        munmap(const_cast<u1*>(base), size);
+    }
+}
+
+const ClassArchive::ArchiveHeader* ClassArchive::header() const {
+    return reinterpret_cast<const ArchiveHeader*>(base);
+}
+
+const ClassArchive::ArchiveEntry* ClassArchive::entries() const {
+    return reinterpret_cast<const ArchiveEntry*>(base + sizeof(ArchiveHeader));
+}
+
+const ClassArchive::SourceStamp* ClassArchive::sources() const {
+    return reinterpret_cast<const SourceStamp*>(base + sizeof(ArchiveHeader) +
+                                                sizeof(ArchiveEntry) * header()->classCount);
+}
+
+u4 ClassArchive::getClassCount() const {
+    return base ? header()->classCount : 0;
+}
+
+bool ClassArchive::map(const std::string &path, const std::string &classPathString) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (std::size_t)st.st_size < sizeof(ArchiveHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void *p = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        return false;
+    }
+
+    const auto *h = static_cast<const ArchiveHeader*>(p);
+    bool valid = h->magic == CLASS_ARCHIVE_MAGIC && h->version == CLASS_ARCHIVE_VERSION &&
+                 h->archiveSize == (uint64_t)st.st_size &&
+                 sizeof(ArchiveHeader) + (uint64_t)h->classCount * sizeof(ArchiveEntry) +
+                 (uint64_t)h->sourceCount * sizeof(SourceStamp) <= h->archiveSize;
+    if (!valid || h->classPathHash != hashName(classPathString.data(), classPathString.size())) {
+        if (valid) {
+            std::cerr << __func__ << ":Class path mismatch, class archive " << path << " is ignored\n";
+        }
+        munmap(p, (std::size_t)st.st_size);
+        return false;
+    }
+
+    base = static_cast<const u1*>(p);
+    size = (std::size_t)st.st_size;
+    if (!validate(path)) {
+        munmap(p, size);
+        base = nullptr;
+        size = 0;
+        return false;
+    }
+    return true;
+}
+
+bool ClassArchive::validate(const std::string &path) const {
+    const u4 sourceCount = header()->sourceCount;
+    const SourceStamp *stamps = sources();
+    for (u4 i = 0; i < sourceCount; ++i) {
+        if (!inBounds(stamps[i].pathOffset, stamps[i].pathLength)) {
+            return false;
+        }
+        std::string source(reinterpret_cast<const char*>(base) + stamps[i].pathOffset, stamps[i].pathLength);
+        uint64_t sourceSize;
+        int64_t mtime;
+        const bool unchanged = statSource(source, sourceSize, mtime)
+                               ? sourceSize == stamps[i].size && mtime == stamps[i].mtime
+                               : stamps[i].size == MISSING_SIZE;
+        if (!unchanged) {
+            std::cerr << __func__ << ":" << source << " has changed, class archive " << path << " is ignored\n";
+            return false;
+        }
+    }
+
+    const u4 classCount = header()->classCount;
+    const ArchiveEntry *table = entries();
+    for (u4 i = 0; i < classCount; ++i) {
+        const ArchiveEntry &e = table[i];
+        if (!inBounds(e.nameOffset, e.nameLength) || !inBounds(e.dataOffset, e.dataLength) ||
+            e.sourceIndex >= sourceCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ClassArchive::find(const char *name, const u1 *&bytes, std::size_t &length, u4 &flags) const {
+    if (!base) {
+        return false;
+    }
+
+    const std::size_t nameLength = strlen(name);
+    const u4 hash = hashName(name, nameLength);
+    const ArchiveEntry *begin = entries();
+    const ArchiveEntry *end = begin + header()->classCount;
+    const ArchiveEntry *e = std::lower_bound(begin, end, hash, [](const ArchiveEntry &x, u4 h) {
+        return x.nameHash < h;
+    });
+
+    for (; e != end && e->nameHash == hash; ++e) {
+        if (e->nameLength != nameLength || !inBounds(e->nameOffset, e->nameLength)) {
+            continue;
+        }
+        if (memcmp(base + e->nameOffset, name, nameLength) == 0) {
+            if (!inBounds(e->dataOffset, e->dataLength)) {
+                return false;
+            }
+            bytes = base + e->dataOffset;
+            length = (std::size_t)e->dataLength;
+            flags = e->flags;
+            return true;
+        }
+    }
+    return false;
+}
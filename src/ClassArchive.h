@@ -0,0 +1,107 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_CLASSARCHIVE_H
+#define CJVM_CLASSARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Type.h"
+
+class ClassPath;
+
+/**
+ * class 文件缓存归档
+ *
+ * 转储时把本次运行加载过的类的 class 文件内容写入一个文件，之后启动的进程以只读方式 mmap 同一个文件，
+ * 同一主机上的多个进程共享页缓存中的同一份物理内存，不再逐个查找、读取和解压 class 文件。
+ * 归档里存的是原始字节而不是解析后的 JavaClass，每个进程仍然要解析一遍，省下的只是类路径的 I/O；
+ * 随类保存的只有校验结果(CLASS_VERIFIED)。
+ *
+ * 转储时记录一组文件的大小和修改时间，映射时只逐一 stat 核对它们，不再按类查找类路径，
+ * 任何一个不一致都放弃整个归档，避免用过期的类跳过校验：
+ *  - 每个类的来源文件(目录中的 class 文件或者 jar 文件)，发现类的内容变化
+ *  - 按顺序的每个类路径条目，以及目录条目下归档中每个包对应的子目录(不存在也记录下来)。
+ *    排在前面的条目新增同名的类时，jar 文件或者包目录的修改时间会变化，由此发现类被遮蔽
+ *
+ * 文件内部只使用相对文件头的偏移量，映射到任意地址都可以直接使用：
+ *
+ *   ArchiveHeader | ArchiveEntry[classCount] (按 nameHash、名字排序) | SourceStamp[sourceCount]
+ *   | 类名和文件路径 | class 文件内容(8 字节对齐)
+ */
+class ClassArchive {
+public:
+    // 随转储记录的每个类的标志位
+    enum : u4 {
+        // 类已经通过校验，加载时可以跳过校验
+        CLASS_VERIFIED = 1u << 0
+    };
+
+    class Writer {
+    public:
+        // source 为类路径中读出这个类的文件，读不到它的状态时不转储这个类
+        bool add(const std::string &name, const u1 *bytes, std::size_t length, u4 flags, const std::string &source);
+        // classPathString 和 classPath 的条目用于加载时确认类路径没有变化
+        bool write(const std::string &path, const std::string &classPathString, const ClassPath &classPath);
+
+    private:
+        class PendingClass {
+        public:
+            std::string name;
+            std::vector<u1> bytes;
+            u4 flags;
+            u4 sourceIndex;
+        };
+        class PendingSource {
+        public:
+            std::string path;
+            uint64_t size;
+            int64_t mtime;
+        };
+        // 记录 path 的状态，返回它在 SourceStamp 表中的下标；allowMissing 时不存在的路径也记录
+        bool addSource(const std::string &path, bool allowMissing, u4 &index);
+
+        std::vector<PendingClass> classes;
+        std::vector<PendingSource> sources;
+        std::unordered_map<std::string, u4> sourceIndex;
+    };
+
+    ClassArchive() = default;
+    ~ClassArchive();
+
+    ClassArchive(const ClassArchive&) = delete;
+    ClassArchive& operator=(const ClassArchive&) = delete;
+
+    // 映射归档，文件不存在、格式不对、类路径不一致或者记录的文件有变化时返回 false
+    bool map(const std::string &path, const std::string &classPathString);
+    bool isMapped() const { return base != nullptr; }
+
+    // 查找类，返回的内存在归档解除映射之前一直有效
+    bool find(const char *name, const u1 *&bytes, std::size_t &length, u4 &flags) const;
+
+    u4 getClassCount() const;
+
+private:
+    class ArchiveHeader;
+    class ArchiveEntry;
+    class SourceStamp;
+
+    static u4 hashName(const char *name, std::size_t length);
+    static bool statSource(const std::string &path, uint64_t &size, int64_t &mtime);
+
+    const ArchiveHeader* header() const;
+    const ArchiveEntry* entries() const;
+    const SourceStamp* sources() const;
+    bool validate(const std::string &path) const;
+    inline bool inBounds(uint64_t offset, uint64_t length) const {
+        return offset <= size && length <= size - offset;
+    }
+
+    const u1 *base = nullptr;
+    std::size_t size = 0;
+};
+
+
+#endif //CJVM_CLASSARCHIVE_H
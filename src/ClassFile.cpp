@@ -0,0 +1,107 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cstring>
+#include "ClassFile.h"
+
+namespace {
+    class AttributeName {
+    public:
+        const char *name;
+        u2 length;
+    };
+
+    // 顺序与 AttributeKind 一致，下标为 kind - 1
+    constexpr AttributeName attributeNames[] = {
+            {"ConstantValue", 13},
+            {"Code", 4},
+            {"StackMapTable", 13},
+            {"Exceptions", 10},
+            {"BootstrapMethods", 16},
+            {"InnerClasses", 12},
+            {"EnclosingMethod", 15},
+            {"Synthetic", 9},
+            {"Signature", 9},
+            {"RuntimeVisibleAnnotations", 25},
+            {"RuntimeInvisibleAnnotations", 27},
+            {"RuntimeVisibleParameterAnnotations", 34},
+            {"RuntimeInvisibleParameterAnnotations", 36},
+            {"RuntimeVisibleTypeAnnotations", 29},
+            {"RuntimeInvisibleTypeAnnotations", 31},
+            {"AnnotationDefault", 17},
+            {"MethodParameters", 16},
+            {"SourceFile", 10},
+            {"SourceDebugExtension", 20},
+            {"LineNumberTable", 15},
+            {"LocalVariableTable", 18},
+            {"LocalVariableTypeTable", 22},
+            {"Deprecated", 10},
+    };
+
+    constexpr int ATTRIBUTE_NAME_COUNT = sizeof(attributeNames) / sizeof(attributeNames[0]);
+    constexpr u4 ATTRIBUTE_TABLE_SIZE = 64;
+
+    // 只看长度、首字符、中间字符和尾字符，参数是离线搜索出来的，对上面 23 个名字没有冲突
+    constexpr u4 attributeNameHash(const char *name, u2 length) {
+        return ((u4)length * 2 + (u1)name[0] * 40u + (u1)name[length / 2] + (u1)name[length - 1]) &
+               (ATTRIBUTE_TABLE_SIZE - 1);
+    }
+
+    class AttributeTable {
+    public:
+        // 0 表示空槽位
+        u1 kinds[ATTRIBUTE_TABLE_SIZE];
+    };
+
+    constexpr AttributeTable buildAttributeTable() {
+        AttributeTable table{};
+        for (int i = 0; i < ATTRIBUTE_NAME_COUNT; ++i) {
+            table.kinds[attributeNameHash(attributeNames[i].name, attributeNames[i].length)] = (u1)(i + 1);
+        }
+        return table;
+    }
+
+    constexpr AttributeTable attributeTable = buildAttributeTable();
+
+    constexpr u2 nameLength(const char *name) {
+        u2 n = 0;
+        while (name[n]) {
+            ++n;
+        }
+        return n;
+    }
+
+    constexpr bool isPerfectHash() {
+        for (int i = 0; i < ATTRIBUTE_NAME_COUNT; ++i) {
+            if (nameLength(attributeNames[i].name) != attributeNames[i].length) {
+                return false;
+            }
+            if (attributeTable.kinds[attributeNameHash(attributeNames[i].name, attributeNames[i].length)] != i + 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(ATTRIBUTE_NAME_COUNT + 1 == (int)AttributeKind::KIND_COUNT,
+                  "attributeNames must list every AttributeKind");
+    static_assert(isPerfectHash(), "attribute name hash has collisions, search for new parameters");
+}
+
+AttributeKind attributeKindOf(const char *name, u2 length) {
+    if (length == 0) {
+        return AttributeKind::UNKNOWN;
+    }
+
+    u1 kind = attributeTable.kinds[attributeNameHash(name, length)];
+    if (kind == 0) {
+        return AttributeKind::UNKNOWN;
+    }
+    // 哈希只对已知名字无冲突，其它名字可能落到同一槽位，需要再比较一次
+    const AttributeName &candidate = attributeNames[kind - 1];
+    if (candidate.length != length || std::memcmp(candidate.name, name, length) != 0) {
+        return AttributeKind::UNKNOWN;
+    }
+    return static_cast<AttributeKind>(kind);
+}
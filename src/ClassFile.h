@@ -5,8 +5,15 @@
 #ifndef CJVM_CLASSFILE_H
 #define CJVM_CLASSFILE_H
 
+#include <atomic>
 #include "Util.h"
 #include "Type.h"
+#include "Descriptor.h"
+#include "NativeMethod.h"
+#include "Intrinsic.h"
+#include "HandlerTable.h"
+#include "EscapeAnalysis.h"
+#include "MethodData.h"
 
 /****************************************************************************
 * Constant tags
@@ -171,6 +178,23 @@ public:
     virtual ~AttributeInfo() = default;
 };
 
+/**
+ * 延迟解析的属性：调试信息、注解等运行时很少用到的属性只记录在 class 文件中的位置，
+ * 第一次通过 JavaClass::getAttribute 访问时才解码，不认识的属性也以这种形式保存
+ *
+ * offset:  attribute_length 在 class 文件中的偏移量
+ * decoded: 解码后的属性，不认识的属性始终为 nullptr
+ */
+class ATTR_Lazy : public AttributeInfo {
+public:
+    std::size_t offset;
+    std::atomic<AttributeInfo*> decoded{nullptr};
+
+    ~ATTR_Lazy() override {
+        delete decoded.load(std::memory_order_relaxed);
+    }
+};
+
 #define DEF_ATTR_START(name) \
 class ATTR_##name : public AttributeInfo
 
@@ -226,18 +250,20 @@ public:
 class VerificationTypeInfo {
 public:
     virtual ~VerificationTypeInfo() = default;
+    // VariableInfoTag
+    u1 tag;
 };
 
 #define DEF_VARIABLE_INFO_WITH_1_FIELDS(name) \
 class VariableInfo_##name : public VerificationTypeInfo { \
 public: \
-    static const u1 tag = VariableInfoTag::ITEM_##name; \
+    VariableInfo_##name() { tag = VariableInfoTag::ITEM_##name; } \
 };
 
 #define DEF_VARIABLE_INFO_WITH_2_FIELDS(name, type, field) \
 class VariableInfo_##name : public VerificationTypeInfo { \
 public: \
-    static const u1 tag = VariableInfoTag::ITEM_##name; \
+    VariableInfo_##name() { tag = VariableInfoTag::ITEM_##name; } \
     type field; \
 };
 
@@ -252,75 +278,61 @@ DEF_VARIABLE_INFO_WITH_1_FIELDS(Long);
 DEF_VARIABLE_INFO_WITH_1_FIELDS(Double);
 
 
+/**
+ * frameType:   帧类型，见 IS_STACKFRAME_*
+ * offsetDelta: 相对上一帧的字节码偏移量增量，same_frame 和 same_locals_1_stack_item_frame
+ *              的增量隐含在 frameType 中，解析时也填入这里
+ */
 class StackMapFrame {
 public:
     virtual ~StackMapFrame() = default;
+
+    u1 frameType;
+    u2 offsetDelta;
 };
 
 #define DEF_FRAME_TYPE_WITH_1_FIELDS(name)  \
-class Frame_##name : public StackMapFrame{    \
-public: \
-    u2 frameType;   \
-};
-#define DEF_FRAME_TYPE_WITH_2_FIELDS(name,type,field)  \
-class Frame_##name : public StackMapFrame{\
-public: \
-    u2 frameType;   \
-    type field;     \
-};
-#define DEF_FRAME_TYPE_WITH_3_FIELDS(name,type,field,type1,field1)  \
-class Frame_##name : public StackMapFrame{\
-    u2 frameType;   \
-    type field;     \
-    type1 field1;   \
-};
+class Frame_##name : public StackMapFrame{};
 
 DEF_FRAME_TYPE_WITH_1_FIELDS(Same);
-DEF_FRAME_TYPE_WITH_2_FIELDS(Chop,u2,offsetDelta);
-DEF_FRAME_TYPE_WITH_2_FIELDS(Same_frame_extended,u2,offsetDelta);
+DEF_FRAME_TYPE_WITH_1_FIELDS(Chop);
+DEF_FRAME_TYPE_WITH_1_FIELDS(Same_frame_extended);
 
 class Frame_Same_locals_1_stack_item : public StackMapFrame {
 public:
-    u2 frameType;
     VerificationTypeInfo **stack;
 
     ~Frame_Same_locals_1_stack_item() override {
         delete stack[0];
-        delete stack;
+        delete[] stack;
     }
 };
 
 class Frame_Same_locals_1_stack_item_extended : public StackMapFrame {
 public:
-    u2 frameType;
-    u2 offsetDelta;
     VerificationTypeInfo **stack;
 
     ~Frame_Same_locals_1_stack_item_extended() override {
         delete stack[0];
-        delete stack;
+        delete[] stack;
     }
 };
 
+// 在上一帧的基础上追加 frameType-251 个局部变量
 class Frame_Append : public StackMapFrame {
 public:
-    u2 frameType;
-    u2 offsetDelta;
-    VerificationTypeInfo **stack;
+    VerificationTypeInfo **locals;
 
     ~Frame_Append() override {
         FOR_EACH(i,frameType-251) {
-            delete stack[i];
+            delete locals[i];
         }
-        delete[] stack;
+        delete[] locals;
     }
 };
 
 class Frame_Full : public StackMapFrame {
 public:
-    u2 frameType;
-    u2 offsetDelta;
-
     u2 numberOfLocals;
     VerificationTypeInfo **locals;
 
@@ -803,6 +815,9 @@ public:
     u2 attributeCount;
     AttributeInfo **attributes;
 
+    // 链接时计算：实例字段相对对象起始地址(包含对象头)的偏移量，静态字段相对类的静态字段区的偏移量
+    u4 offset = 0;
+
     ~FieldInfo() {
         FOR_EACH(i, attributeCount) {
             delete attributes[i];
@@ -826,7 +841,31 @@ public:
     u2 attributeCount;
     AttributeInfo **attributes;
 
+    // 链接时由描述符预解析
+    MethodSignature signature;
+
+    // 链接时绑定的本地方法入口，内建方法(intrinsicId 不为 NONE)也经由它调用。链接之后不再修改
+    NativeEntry nativeEntry;
+    // 链接时还没有注册、第一次调用时才绑定的入口，发布之后不再修改
+    std::atomic<const NativeEntry*> lateNativeEntry{nullptr};
+    IntrinsicId intrinsicId = IntrinsicId::NONE;
+
+    // 链接时由异常表生成，没有异常处理器时为 nullptr
+    HandlerTable *handlers = nullptr;
+
+    // 第一次请求时由 EscapeAnalysis 计算
+    std::atomic<EscapeInfo*> escapeInfo{nullptr};
+
+    // 调用和循环回跳的次数，之和达到阈值后才分配 methodData
+    std::atomic<u4> invocationCount{0};
+    std::atomic<u4> backedgeCount{0};
+    std::atomic<MethodData*> methodData{nullptr};
+
     ~MethodInfo() {
+        delete handlers;
+        delete escapeInfo.load();
+        delete methodData.load();
+        delete lateNativeEntry.load();
         FOR_EACH(i, attributeCount) {
             delete attributes[i];
         }
@@ -902,29 +941,37 @@ public:
 /**
 *\brief  Utilities for parsing class file
 */
-#define IS_ATTR_ConstantValue(PTR) if(strcmp(PTR,"ConstantValue")==0)
-#define IS_ATTR_Code(PTR) if(strcmp(PTR,"Code")==0)
-#define IS_ATTR_StackMapTable(PTR) if(strcmp(PTR,"StackMapTable")==0)
-#define IS_ATTR_Exceptions(PTR) if(strcmp(PTR,"Exceptions")==0)
-#define IS_ATTR_BootstrapMethods(PTR) if(strcmp(PTR,"BootstrapMethods")==0)
-#define IS_ATTR_InnerClasses(PTR) if(strcmp(PTR,"InnerClasses")==0)
-#define IS_ATTR_EnclosingMethod(PTR) if(strcmp(PTR,"EnclosingMethod")==0)
-#define IS_ATTR_Synthetic(PTR) if(strcmp(PTR,"Synthetic")==0)
-#define IS_ATTR_Signature(PTR) if(strcmp(PTR,"Signature")==0)
-#define IS_ATTR_RuntimeVisibleAnnotations(PTR) if(strcmp(PTR,"RuntimeVisibleAnnotations")==0)
-#define IS_ATTR_RuntimeInvisibleAnnotations(PTR) if(strcmp(PTR,"RuntimeInvisibleAnnotations")==0)
-#define IS_ATTR_RuntimeVisibleParameterAnnotations(PTR) if(strcmp(PTR,"RuntimeVisibleParameterAnnotations")==0)
-#define IS_ATTR_RuntimeInvisibleParameterAnnotations(PTR) if(strcmp(PTR,"RuntimeInvisibleParameterAnnotations")==0)
-#define IS_ATTR_RuntimeVisibleTypeAnnotations(PTR) if(strcmp(PTR,"RuntimeVisibleTypeAnnotations")==0)
-#define IS_ATTR_RuntimeInvisibleTypeAnnotations(PTR) if(strcmp(PTR,"RuntimeInvisibleTypeAnnotations")==0)
-#define IS_ATTR_AnnotationDefault(PTR) if(strcmp(PTR,"AnnotationDefault")==0)
-#define IS_ATTR_MethodParameters(PTR) if(strcmp(PTR,"MethodParameters")==0)
-#define IS_ATTR_SourceFile(PTR) if(strcmp(PTR,"SourceFile")==0)
-#define IS_ATTR_SourceDebugExtension(PTR) if(strcmp(PTR,"SourceDebugExtension")==0)
-#define IS_ATTR_LineNumberTable(PTR) if(strcmp(PTR,"LineNumberTable")==0)
-#define IS_ATTR_LocalVariableTable(PTR) if(strcmp(PTR,"LocalVariableTable")==0)
-#define IS_ATTR_LocalVariableTypeTable(PTR) if(strcmp(PTR,"LocalVariableTypeTable")==0)
-#define IS_ATTR_Deprecated(PTR) if(strcmp(PTR,"Deprecated")==0)
+enum class AttributeKind : u1 {
+    UNKNOWN = 0,
+    ConstantValue,
+    Code,
+    StackMapTable,
+    Exceptions,
+    BootstrapMethods,
+    InnerClasses,
+    EnclosingMethod,
+    Synthetic,
+    Signature,
+    RuntimeVisibleAnnotations,
+    RuntimeInvisibleAnnotations,
+    RuntimeVisibleParameterAnnotations,
+    RuntimeInvisibleParameterAnnotations,
+    RuntimeVisibleTypeAnnotations,
+    RuntimeInvisibleTypeAnnotations,
+    AnnotationDefault,
+    MethodParameters,
+    SourceFile,
+    SourceDebugExtension,
+    LineNumberTable,
+    LocalVariableTable,
+    LocalVariableTypeTable,
+    Deprecated,
+
+    KIND_COUNT
+};
+
+// 属性名到 AttributeKind 的映射，基于编译期构造的完美哈希表，不认识的名字返回 UNKNOWN
+AttributeKind attributeKindOf(const char *name, u2 length);
 
 #define IS_STACKFRAME_same_frame(num) ((num) >= 0&& (num) <= 63)
 #define IS_STACKFRAME_same_locals_1_stack_item_frame(num) ((num) >= 64&& (num) <= 127)
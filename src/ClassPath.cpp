@@ -0,0 +1,169 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "ClassPath.h"
+#include "Option.h"
+
+static bool endsWith(const std::string &s, const char *suffix) {
+    std::size_t n = strlen(suffix);
+    return s.length() >= n && s.compare(s.length() - n, n, suffix) == 0;
+}
+
+bool DirectoryEntry::readClass(const std::string &fileName, ClassBytes &out) {
+    std::ifstream fin(path + "/" + fileName, std::ios::binary);
+    if (!fin.is_open()) {
+        return false;
+    }
+    out.buffer.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    out.data = out.buffer.data();
+    out.length = out.buffer.size();
+    return true;
+}
+
+bool DirectoryEntry::locateClass(const std::string &fileName, std::string &source) {
+    std::string file = path + "/" + fileName;
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    source = std::move(file);
+    return true;
+}
+
+void DirectoryEntry::scanPackages(std::unordered_set<std::string> &packages) {
+    scanDirectory(path, "", 0, packages);
+}
+
+void DirectoryEntry::scanDirectory(const std::string &dir, const std::string &package, int depth,
+                                   std::unordered_set<std::string> &packages) {
+    // 限制深度，防止符号链接成环
+    if (depth > YVM_CLASS_PATH_MAX_DEPTH) {
+        return;
+    }
+    DIR *d = opendir(dir.c_str());
+    if (!d) {
+        return;
+    }
+    while (dirent *e = readdir(d)) {
+        if (e->d_name[0] == '.') {
+            continue;
+        }
+        std::string name(e->d_name);
+        std::string child = dir + "/" + name;
+        bool isDir = e->d_type == DT_DIR;
+        if (e->d_type == DT_UNKNOWN || e->d_type == DT_LNK) {
+            struct stat st;
+            isDir = stat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+        }
+
+        if (isDir) {
+            scanDirectory(child, package.empty() ? name : package + "/" + name, depth + 1, packages);
+        } else if (endsWith(name, ".class")) {
+            packages.insert(package);
+        }
+    }
+    closedir(d);
+}
+
+void JarEntry::scanPackages(std::unordered_set<std::string> &packages) {
+    zip.forEachName([&packages](const std::string &name) {
+        if (!endsWith(name, ".class")) {
+            return;
+        }
+        std::size_t slash = name.rfind('/');
+        packages.insert(slash == std::string::npos ? std::string() : name.substr(0, slash));
+    });
+}
+
+bool JarEntry::readClass(const std::string &fileName, ClassBytes &out) {
+    // 先查中央目录的索引，不存在的类不会触发任何解压
+    if (!zip.contains(fileName)) {
+        return false;
+    }
+    return zip.read(fileName, out.data, out.length, out.buffer);
+}
+
+bool JarEntry::locateClass(const std::string &fileName, std::string &source) {
+    if (!zip.contains(fileName)) {
+        return false;
+    }
+    source = path;
+    return true;
+}
+
+
+ClassPath::ClassPath(const std::vector<std::string> &paths) {
+    for (const auto &path : paths) {
+        if (endsWith(path, ".jar") || endsWith(path, ".zip")) {
+            auto *jar = new JarEntry(path);
+            if (!jar->open()) {
+                std::cerr << __func__ << ":Can not open " << path << "\n";
+                delete jar;
+                continue;
+            }
+            entries.push_back(jar);
+        } else {
+            entries.push_back(new DirectoryEntry(path));
+        }
+    }
+
+    // 按类路径的顺序加入索引，同一个包在多个条目中时保持查找顺序不变
+    for (auto *entry : entries) {
+        std::unordered_set<std::string> packages;
+        entry->scanPackages(packages);
+        for (const auto &package : packages) {
+            packageIndex[package].push_back(entry);
+        }
+    }
+}
+
+ClassPath::~ClassPath() {
+    for (auto *entry : entries) {
+        delete entry;
+    }
+}
+
+bool ClassPath::readClass(const char *className, ClassBytes &out) {
+    std::string fileName(className);
+    if (missingClasses.find(fileName) != missingClasses.end()) {
+        return false;
+    }
+
+    std::size_t slash = fileName.rfind('/');
+    auto pos = packageIndex.find(slash == std::string::npos ? std::string() : fileName.substr(0, slash));
+    if (pos != packageIndex.end()) {
+        fileName.append(".class");
+        for (auto *entry : pos->second) {
+            if (entry->readClass(fileName, out)) {
+                return true;
+            }
+        }
+        fileName.resize(fileName.length() - strlen(".class"));
+    }
+
+    missingClasses.insert(std::move(fileName));
+    return false;
+}
+
+bool ClassPath::locateClass(const char *className, std::string &source) {
+    std::string fileName(className);
+    std::size_t slash = fileName.rfind('/');
+    auto pos = packageIndex.find(slash == std::string::npos ? std::string() : fileName.substr(0, slash));
+    if (pos == packageIndex.end()) {
+        return false;
+    }
+    fileName.append(".class");
+    for (auto *entry : pos->second) {
+        if (entry->locateClass(fileName, source)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,104 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_CLASSPATH_H
+#define CJVM_CLASSPATH_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "Type.h"
+#include "ZipFile.h"
+
+/**
+ * 从类路径读出的 class 文件内容
+ *
+ * data 指向 buffer，或者直接指向映射的 jar 文件(未压缩条目)，此时 buffer 为空
+ */
+class ClassBytes {
+public:
+    const u1 *data = nullptr;
+    std::size_t length = 0;
+    std::vector<u1> buffer;
+};
+
+class ClassPathEntry {
+public:
+    explicit ClassPathEntry(const std::string &path) : path(path) {}
+    virtual ~ClassPathEntry() = default;
+
+    // fileName 形如 java/lang/Object.class
+    virtual bool readClass(const std::string &fileName, ClassBytes &out) = 0;
+    // 只确认类是否存在，不读取内容；source 为 class 文件或者 jar 文件的路径
+    virtual bool locateClass(const std::string &fileName, std::string &source) = 0;
+    // 收集含有 class 文件的所有包名，形如 java/lang，默认包为空串
+    virtual void scanPackages(std::unordered_set<std::string> &packages) = 0;
+
+    const std::string& getPath() const { return path; }
+
+protected:
+    std::string path;
+};
+
+// 目录
+class DirectoryEntry : public ClassPathEntry {
+public:
+    explicit DirectoryEntry(const std::string &path) : ClassPathEntry(path) {}
+
+    bool readClass(const std::string &fileName, ClassBytes &out) override;
+    bool locateClass(const std::string &fileName, std::string &source) override;
+    void scanPackages(std::unordered_set<std::string> &packages) override;
+
+private:
+    void scanDirectory(const std::string &dir, const std::string &package, int depth,
+                       std::unordered_set<std::string> &packages);
+};
+
+// jar/zip 文件
+class JarEntry : public ClassPathEntry {
+public:
+    explicit JarEntry(const std::string &path) : ClassPathEntry(path) {}
+
+    bool open() { return zip.open(path); }
+    bool readClass(const std::string &fileName, ClassBytes &out) override;
+    bool locateClass(const std::string &fileName, std::string &source) override;
+    void scanPackages(std::unordered_set<std::string> &packages) override;
+
+private:
+    ZipFile zip;
+};
+
+/**
+ * 类路径：按顺序在各个目录和 jar 文件中查找 class 文件
+ *
+ * 以 .jar 或 .zip 结尾的路径当作 jar 文件，其余当作目录
+ *
+ * 构造时扫描一遍所有条目，建立 包名 -> 含有该包的条目 的索引，查找时只访问索引中列出的条目；
+ * 查找失败的类名记入否定缓存，之后重复的查找直接返回。索引是构造时的快照，之后新增到目录中的类不可见。
+ * 不是线程安全的，由调用者(MethodArea)加锁
+ */
+class ClassPath {
+public:
+    explicit ClassPath(const std::vector<std::string> &paths);
+    ~ClassPath();
+
+    ClassPath(const ClassPath&) = delete;
+    ClassPath& operator=(const ClassPath&) = delete;
+
+    // className 形如 java/lang/Object
+    bool readClass(const char *className, ClassBytes &out);
+    // readClass 会从哪个文件读出这个类，用于确认 class 文件缓存是否过期
+    bool locateClass(const char *className, std::string &source);
+
+    const std::vector<ClassPathEntry*>& getEntries() const { return entries; }
+
+private:
+    std::vector<ClassPathEntry*> entries;
+    std::unordered_map<std::string, std::vector<ClassPathEntry*>> packageIndex;
+    std::unordered_set<std::string> missingClasses;
+};
+
+
+#endif //CJVM_CLASSPATH_H
@@ -0,0 +1,111 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_CONSTANTPOOLCACHE_H
+#define CJVM_CONSTANTPOOLCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include "Type.h"
+#include "Opcode.h"
+
+class JavaClass;
+class FieldInfo;
+class MethodInfo;
+
+/**
+ * 字段和方法引用解析的结果：声明它的类和它本身
+ */
+class ResolvedField {
+public:
+    JavaClass *jc;
+    FieldInfo *field;
+};
+
+class ResolvedMethod {
+public:
+    JavaClass *jc;
+    MethodInfo *method;
+};
+
+/**
+ * 数组类常量解析的结果，数组类没有对应的 JavaClass，由最内层元素类型和维数描述
+ *
+ * elementClass:    最内层元素的类，基本类型数组为 nullptr
+ * elementType:     最内层元素的类型，T_INT 等基本类型或 T_EXTRA_OBJECT
+ * dimensions:      维数，[[I 为 2
+ */
+class ArrayClass {
+public:
+    // 创建这个数组类的实例时 ArrayHeader 中的 componentType 和 componentClass
+    u1 componentType() const { return dimensions > 1 ? (u1)T_EXTRA_OBJECT : elementType; }
+    JavaClass* componentClass() const { return dimensions > 1 ? nullptr : elementClass; }
+
+    JavaClass *elementClass;
+    u1 elementType;
+    u1 dimensions;
+};
+
+/**
+ * 常量池缓存：与常量池一一对应的原子槽位，保存符号引用解析后的结果
+ *
+ *  - CONSTANT_Class                                JavaClass*，数组类为 ArrayClass* | ARRAY_CLASS_TAG
+ *  - CONSTANT_FieldRef                             ResolvedField*
+ *  - CONSTANT_MethodRef/InterfaceMethodRef         ResolvedMethod*
+ *  - CONSTANT_String                               String 在堆上的偏移量
+ *
+ * 槽位为 0 表示尚未解析。解析结果通过 CAS 发布，只有第一个发布的结果生效，
+ * 之后每个使用点只是一次 acquire 读取
+ */
+class ConstantPoolCache {
+public:
+    // ArrayClass 至少按指针对齐，用最低位区分它和 JavaClass
+    enum : std::uintptr_t { ARRAY_CLASS_TAG = 1 };
+
+    explicit ConstantPoolCache(u2 count) : count(count), slots(new std::atomic<std::uintptr_t>[count]) {
+        for (u2 i = 0; i < count; ++i) {
+            slots[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~ConstantPoolCache() {
+        delete[] slots;
+    }
+
+    ConstantPoolCache(const ConstantPoolCache&) = delete;
+    ConstantPoolCache& operator=(const ConstantPoolCache&) = delete;
+
+    inline std::uintptr_t get(u2 index) const {
+        return slots[index].load(std::memory_order_acquire);
+    }
+
+    // 发布解析结果，返回最终生效的值；输给其它线程时返回对方发布的值
+    inline std::uintptr_t publish(u2 index, std::uintptr_t resolved) {
+        std::uintptr_t expected = 0;
+        if (slots[index].compare_exchange_strong(expected, resolved, std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+            return resolved;
+        }
+        return expected;
+    }
+
+    // 只用于 GC 在安全点修改已经发布的堆引用(对象移动之后)
+    inline void update(u2 index, std::uintptr_t value) {
+        slots[index].store(value, std::memory_order_release);
+    }
+
+    template<typename T>
+    inline T* getPointer(u2 index) const {
+        return reinterpret_cast<T*>(get(index));
+    }
+
+    u2 size() const { return count; }
+
+private:
+    u2 count;
+    std::atomic<std::uintptr_t> *slots;
+};
+
+
+#endif //CJVM_CONSTANTPOOLCACHE_H
@@ -48,121 +48,90 @@ std::string peelArrayComponentTypeFrom(const char *descriptor) {
     return arrayComponentTypeName.substr(i, arrayComponentTypeName.length() - i);
 }
 
-std::tuple<int ,std::vector<int>> peelMethodParameterAndType(const char *descriptor) {
-    std::vector<int> parameters;
-
-    int i = 0;
-    while (descriptor[i] != ')') {
-        switch (descriptor[i]) {
-            case 'B':
-                parameters.push_back(T_BYTE);
-                break;
-            case 'C':
-                parameters.push_back(T_CHAR);
-                break;
-            case 'D':
-                parameters.push_back(T_DOUBLE);
-                break;
-            case 'F':
-                parameters.push_back(T_FLOAT);
-                break;
-            case 'I':
-                parameters.push_back(T_INT);
-                break;
-            case 'J':
-                parameters.push_back(T_LONG);
-                break;
-            case 'S':
-                parameters.push_back(T_SHORT);
-                break;
-            case 'Z':
-                parameters.push_back(T_BOOLEAN);
-                break;
-            case '[': {
-                int arrayComponentType = i++;
-                while (descriptor[arrayComponentType] == '[') {
-                    ++arrayComponentType;
-                }
-
-                i = arrayComponentType;
-                parameters.push_back(T_EXTRA_ARRAY);
-                break;
+/**
+ * 跳过一个字段描述符，返回它的类型，descriptor 指向下一个描述符的开始
+ */
+static int skipFieldType(const char *&descriptor) {
+    switch (*descriptor++) {
+        case 'B': return T_BYTE;
+        case 'C': return T_CHAR;
+        case 'D': return T_DOUBLE;
+        case 'F': return T_FLOAT;
+        case 'I': return T_INT;
+        case 'J': return T_LONG;
+        case 'S': return T_SHORT;
+        case 'Z': return T_BOOLEAN;
+        case 'L':
+            while (*descriptor && *descriptor != ';') {
+                ++descriptor;
             }
-            case 'L': {
-                int objectType = i++;
-                while (descriptor[objectType] != ';') {
-                    objectType++;
-                }
-                i = objectType;
-                parameters.push_back(T_EXTRA_OBJECT);
-                break;
+            if (*descriptor != ';') {
+                return -1;
             }
-        }
-        ++i;
+            ++descriptor;
+            return T_EXTRA_OBJECT;
+        case '[':
+            while (*descriptor == '[') {
+                ++descriptor;
+            }
+            return skipFieldType(descriptor) < 0 ? -1 : T_EXTRA_ARRAY;
+        default:
+            return -1;
     }
+}
 
-    while (descriptor[i]) {
-        switch (descriptor[i]) {
-            case 'B':
-                return std::make_tuple(T_BYTE, parameters);
-            case 'C':
-                return std::make_tuple(T_CHAR, parameters);
-            case 'D':
-                return std::make_tuple(T_DOUBLE, parameters);
-            case 'F':
-                return std::make_tuple(T_FLOAT, parameters);
-            case 'I':
-                return std::make_tuple(T_INT, parameters);
-            case 'J':
-                return std::make_tuple(T_LONG, parameters);
-            case 'S':
-                return std::make_tuple(T_SHORT, parameters);
-            case 'Z':
-                return std::make_tuple(T_BOOLEAN, parameters);
-            case 'V':
-                return std::make_tuple(T_EXTRA_VOID, parameters);
-            case '[': {
-                int arrayComponentType = i++;
-                while (descriptor[arrayComponentType] != '[') {
-                    arrayComponentType++;
-                }
-                i = arrayComponentType;
-
-                return std::make_tuple(T_EXTRA_OBJECT, parameters);
-            }
-            case 'L': {
-                int objectType = i++;
-                while (descriptor[objectType] != ';') {
-                    objectType++;
-                }
-                i = objectType;
+bool parseMethodSignature(const char *descriptor, MethodSignature &signature) {
+    if (*descriptor++ != '(') {
+        return false;
+    }
 
-                return std::make_tuple(T_EXTRA_OBJECT, parameters);
-            }
+    // 参数最多 255 个槽，先放在栈上，最后一次性分配
+    u1 types[256];
+    memset(signature.refMap, 0, sizeof(signature.refMap));
+    int count = 0;
+    int slots = 0;
+    while (*descriptor != ')') {
+        int type = skipFieldType(descriptor);
+        if (type < 0 || slots >= 255) {
+            return false;
         }
-        ++i;
+        if (type == T_EXTRA_OBJECT || type == T_EXTRA_ARRAY) {
+            signature.refMap[slots >> 6] |= (uint64_t)1 << (slots & 63);
+        }
+        types[count++] = (u1)type;
+        slots += (type == T_LONG || type == T_DOUBLE) ? 2 : 1;
+    }
+    ++descriptor;
+
+    int returnType;
+    if (*descriptor == 'V') {
+        returnType = T_EXTRA_VOID;
+        ++descriptor;
+    } else {
+        returnType = skipFieldType(descriptor);
+        // 返回数组时和 peelMethodParameterAndType 一样按对象处理
+        if (returnType == T_EXTRA_ARRAY) {
+            returnType = T_EXTRA_OBJECT;
+        }
+    }
+    if (returnType < 0 || *descriptor != '\0') {
+        return false;
     }
-};
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
 
+    delete[] signature.argTypes;
+    signature.argTypes = new u1[count];
+    memcpy(signature.argTypes, types, count);
+    signature.argCount = (u1)count;
+    signature.argSlots = (u2)slots;
+    signature.returnType = (u1)returnType;
+    return true;
+}
 
+std::tuple<int ,std::vector<int>> peelMethodParameterAndType(const char *descriptor) {
+    MethodSignature signature;
+    if (!parseMethodSignature(descriptor, signature)) {
+        return std::make_tuple(T_EXTRA_VOID, std::vector<int>());
+    }
+    return std::make_tuple((int)signature.returnType,
+                           std::vector<int>(signature.argTypes, signature.argTypes + signature.argCount));
+}
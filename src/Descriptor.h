@@ -9,6 +9,7 @@
 #include <vector>
 #include <tuple>
 #include <string.h>
+#include "Type.h"
 #include "JavaType.h"
 
 
@@ -50,6 +51,36 @@ std::string peelArrayComponentTypeFrom(const char *descriptor);
 
 std::tuple<int ,std::vector<int>> peelMethodParameterAndType(const char *descriptor);
 
+/**
+ * 预解析的方法描述符，链接时每个方法只解析一次，调用时直接按它拷贝参数
+ *
+ * argTypes:    每个参数的类型(T_INT、T_EXTRA_OBJECT 等)，不包含 this
+ * argSlots:    参数占用的局部变量槽数，long/double 占两个槽
+ * returnType:  返回值类型，void 为 T_EXTRA_VOID
+ * refMap:      按槽位记录哪些参数是引用(对象或数组)，供 GC 扫描参数
+ */
+class MethodSignature {
+public:
+    MethodSignature() = default;
+    ~MethodSignature() { delete[] argTypes; }
+
+    MethodSignature(const MethodSignature&) = delete;
+    MethodSignature& operator=(const MethodSignature&) = delete;
+
+    bool isReference(u2 slot) const {
+        return (refMap[slot >> 6] >> (slot & 63)) & 1;
+    }
+
+    u1 argCount = 0;
+    u2 argSlots = 0;
+    u1 returnType = 0;
+    u1 *argTypes = nullptr;
+    uint64_t refMap[4] = {0, 0, 0, 0};
+};
+
+// 描述符非法时返回 false
+bool parseMethodSignature(const char *descriptor, MethodSignature &signature);
+
 #define IS_SIGNATURE_POLYMORPHIC_METHOD(className, methodName) \
 (strcmp(className, "java/lang/invoke/MethodHandle") == 0 && \
 (strcmp(method, "invokeExtract") == 0 || strcmp(methodName, "invoke") ==0))
@@ -0,0 +1,769 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <algorithm>
+#include "EscapeAnalysis.h"
+#include "JavaClass.h"
+#include "AccessFlag.h"
+#include "Bytecode.h"
+#include "Descriptor.h"
+#include "RuntimeEnv.h"
+
+/**
+ * 不涉及引用的指令弹出和压入的槽数，-1 表示需要单独处理
+ */
+static const int8_t STACK_POP[256] = {
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+         0,  0, -1, -1,  0,  0,  0,  0,  0, -1,  0,  0,  0,  0,  0,  0,
+         0,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1, -1, -1, -1,  2,  2,
+         2,  2, -1,  2,  2,  2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  3,
+         4,  3,  4, -1,  3,  3,  3,  1,  2, -1, -1, -1, -1, -1, -1, -1,
+         2,  4,  2,  4,  2,  4,  2,  4,  2,  4,  2,  4,  2,  4,  2,  4,
+         2,  4,  2,  4,  1,  2,  1,  2,  2,  3,  2,  3,  2,  3,  2,  4,
+         2,  4,  2,  4,  0,  1,  1,  1,  2,  2,  2,  1,  1,  1,  2,  2,
+         2,  1,  1,  1,  4,  2,  2,  4,  4, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  1, -1,
+        -1,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static const int8_t STACK_PUSH[256] = {
+         0,  1,  1,  1,  1,  1,  1,  1,  1,  2,  2,  1,  1,  1,  2,  2,
+         1,  1, -1, -1,  2,  1,  2,  1,  2, -1,  1,  1,  1,  1,  2,  2,
+         2,  2,  1,  1,  1,  1,  2,  2,  2,  2, -1, -1, -1, -1,  1,  2,
+         1,  2, -1,  1,  1,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,
+         0,  0,  0, -1,  0,  0,  0,  0,  0, -1, -1, -1, -1, -1, -1, -1,
+         1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,
+         1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,
+         1,  2,  1,  2,  0,  2,  1,  2,  1,  1,  2,  1,  2,  2,  1,  2,
+         1,  1,  1,  1,  1,  1,  1,  1,  1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  1, -1,
+        -1,  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+// 局部变量的 load/store 指令操作的槽数，按 i/l/f/d/a 的顺序
+static const int LOCAL_SLOTS[5] = {1, 2, 1, 2, 1};
+
+static inline bool isBranch(u1 opcode) {
+    return (opcode >= op_ifeq && opcode <= op_if_acmpne) || opcode == op_ifnull || opcode == op_ifnonnull;
+}
+
+const int EscapeAnalysis::MAX_SITES;
+const uint64_t EscapeAnalysis::UNKNOWN;
+
+EscapeState EscapeInfo::allocationState(u4 pc) const {
+    auto it = std::lower_bound(allocations.cbegin(), allocations.cend(), pc,
+                               [](const AllocationSite &site, u4 value) { return site.pc < value; });
+    return it != allocations.cend() && it->pc == pc ? it->state : EscapeState::GLOBAL_ESCAPE;
+}
+
+bool EscapeInfo::isMonitorElidable(u4 pc) const {
+    return std::binary_search(elidableMonitors.cbegin(), elidableMonitors.cend(), pc);
+}
+
+const EscapeInfo* EscapeAnalysis::analyze(JavaClass *jc, MethodInfo *method) {
+    std::vector<const MethodInfo*> active;
+    return analyze(jc, method, 0, active);
+}
+
+const EscapeInfo* EscapeAnalysis::analyze(JavaClass *jc, MethodInfo *method, int depth,
+                                          std::vector<const MethodInfo*> &active) {
+    EscapeInfo *info = method->escapeInfo.load(std::memory_order_acquire);
+    if (info) {
+        return info;
+    }
+    auto *code = static_cast<ATTR_Code*>(jc->findAttribute(method->attributes, method->attributeCount,
+                                                           AttributeKind::Code));
+    // 递归调用和过深的调用链不再分析，调用方按参数全局逃逸处理
+    if (!code || depth > YVM_ESCAPE_ANALYSIS_MAX_DEPTH ||
+        std::find(active.cbegin(), active.cend(), method) != active.cend()) {
+        return nullptr;
+    }
+
+    active.push_back(method);
+    info = EscapeAnalysis(jc, method, code, depth, active).run();
+    active.pop_back();
+
+    EscapeInfo *expected = nullptr;
+    if (!method->escapeInfo.compare_exchange_strong(expected, info, std::memory_order_acq_rel)) {
+        delete info;
+        return expected;
+    }
+    return info;
+}
+
+EscapeAnalysis::EscapeAnalysis(JavaClass *jc, MethodInfo *method, ATTR_Code *code, int depth,
+                               std::vector<const MethodInfo*> &active)
+        : jc(jc), method(method), code(code), depth(depth), active(active) {
+}
+
+EscapeInfo* EscapeAnalysis::run() {
+    // 引用参数各占一个伪分配点
+    u2 slot = 0;
+    if (!IS_METHOD_STATIC(method->accessFlags)) {
+        paramSlots.push_back(slot++);
+    }
+    FOR_EACH(i, method->signature.argSlots) {
+        if (method->signature.isReference(i)) {
+            paramSlots.push_back((u2)(slot + i));
+        }
+    }
+    paramSites = (int)paramSlots.size();
+    siteCount = paramSites;
+    if (paramSites > MAX_SITES || slot + method->signature.argSlots > code->maxLocals) {
+        return conservativeResult();
+    }
+
+    if (!computeBlocks()) {
+        return conservativeResult();
+    }
+    states.assign(siteCount, EscapeState::NO_ESCAPE);
+    edges.assign(siteCount, 0);
+
+    std::vector<uint64_t> entry(code->maxLocals, 0);
+    FOR_EACH(i, paramSites) {
+        entry[paramSlots[i]] = (uint64_t)1 << i;
+    }
+    merge(0, entry, std::vector<uint64_t>());
+
+    // 读取字段得到的集合依赖于 edges，edges 在一轮迭代中有变化时所有基本块重新计算一遍
+    std::vector<uint64_t> lastEdges;
+    do {
+        lastEdges = edges;
+        while (!worklist.empty()) {
+            const u4 pc = worklist.back();
+            worklist.pop_back();
+            if (!interpret(pc) || failed) {
+                return conservativeResult();
+            }
+        }
+        for (u4 pc = 0; pc < code->codeLength; pc++) {
+            if (blockIndex[pc] >= 0 && blocks[blockIndex[pc]].reached) {
+                worklist.push_back(pc);
+            }
+        }
+    } while (edges != lastEdges);
+
+    // 存入逃逸对象的对象至少和容器一样逃逸
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        FOR_EACH(s, siteCount) {
+            FOR_EACH(v, siteCount) {
+                if (((edges[s] >> v) & 1) && states[v] < states[s]) {
+                    states[v] = states[s];
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    auto *info = new EscapeInfo;
+    info->parameters.assign(code->maxLocals, EscapeState::NO_ESCAPE);
+    FOR_EACH(i, paramSites) {
+        info->parameters[paramSlots[i]] = states[i];
+    }
+    for (u4 pc = 0; pc < code->codeLength; pc++) {
+        if (siteIndex[pc] == -2) {
+            info->allocations.push_back(AllocationSite{pc, EscapeState::GLOBAL_ESCAPE});
+        } else if (siteIndex[pc] >= 0) {
+            info->allocations.push_back(AllocationSite{pc, states[siteIndex[pc]]});
+        }
+    }
+    // 参数和来源未知的对象可能已经被其它线程看到
+    for (const auto &monitor : monitors) {
+        uint64_t objects = monitor.second;
+        bool elidable = objects != 0 && (objects & (UNKNOWN | paramMask())) == 0;
+        for (int s = paramSites; elidable && s < siteCount; s++) {
+            elidable = !((objects >> s) & 1) || states[s] != EscapeState::GLOBAL_ESCAPE;
+        }
+        if (elidable) {
+            info->elidableMonitors.push_back(monitor.first);
+        }
+    }
+    return info;
+}
+
+EscapeInfo* EscapeAnalysis::conservativeResult() {
+    auto *info = new EscapeInfo;
+    info->parameters.assign(code->maxLocals, EscapeState::NO_ESCAPE);
+    for (u2 slot : paramSlots) {
+        if (slot < code->maxLocals) {
+            info->parameters[slot] = EscapeState::GLOBAL_ESCAPE;
+        }
+    }
+    u4 pc = 0;
+    while (pc < code->codeLength) {
+        const u1 opcode = code->code[pc];
+        if (opcode == op_new || opcode == op_newarray || opcode == op_anewarray || opcode == op_multianewarray) {
+            info->allocations.push_back(AllocationSite{pc, EscapeState::GLOBAL_ESCAPE});
+        }
+        const u4 length = bytecodeLength(code->code, pc, code->codeLength);
+        if (length == 0) {
+            break;
+        }
+        pc += length;
+    }
+    return info;
+}
+
+bool EscapeAnalysis::computeBlocks() {
+    const u1 *bc = code->code;
+    const u4 codeLength = code->codeLength;
+    // siteIndex: 分配点的编号，-1 表示不是分配指令，-2 表示超出了能跟踪的个数
+    siteIndex.assign(codeLength, -1);
+    blockIndex.assign(codeLength, -1);
+    std::vector<bool> leaders(codeLength, false);
+    leaders[0] = true;
+
+    auto markTarget = [&](int64_t target) {
+        if (target < 0 || target >= codeLength) {
+            return false;
+        }
+        leaders[target] = true;
+        return true;
+    };
+
+    u4 pc = 0;
+    while (pc < codeLength) {
+        const u4 length = bytecodeLength(bc, pc, codeLength);
+        if (length == 0) {
+            return false;
+        }
+        const u1 opcode = bc[pc];
+        bool endsBlock = true;
+        if (opcode == op_new || opcode == op_newarray || opcode == op_anewarray || opcode == op_multianewarray) {
+            if (siteCount < MAX_SITES) {
+                sitePCs.push_back(pc);
+                siteIndex[pc] = siteCount++;
+            } else {
+                siteIndex[pc] = -2;
+            }
+            endsBlock = false;
+        } else if (isBranch(opcode) || opcode == op_goto) {
+            if (!markTarget((int64_t)pc + readBytecodeS2(bc + pc + 1))) {
+                return false;
+            }
+        } else if (opcode == op_goto_w) {
+            if (!markTarget((int64_t)pc + readBytecodeS4(bc + pc + 1))) {
+                return false;
+            }
+        } else if (opcode == op_tableswitch || opcode == op_lookupswitch) {
+            const u4 base = (pc + 4) & ~3u;
+            if (!markTarget((int64_t)pc + readBytecodeS4(bc + base))) {
+                return false;
+            }
+            if (opcode == op_tableswitch) {
+                const int64_t count = (int64_t)readBytecodeS4(bc + base + 8) - readBytecodeS4(bc + base + 4) + 1;
+                for (int64_t i = 0; i < count; i++) {
+                    if (!markTarget((int64_t)pc + readBytecodeS4(bc + base + 12 + i * 4))) {
+                        return false;
+                    }
+                }
+            } else {
+                const int32_t npairs = readBytecodeS4(bc + base + 4);
+                for (int32_t i = 0; i < npairs; i++) {
+                    if (!markTarget((int64_t)pc + readBytecodeS4(bc + base + 12 + (int64_t)i * 8))) {
+                        return false;
+                    }
+                }
+            }
+        } else if (opcode == op_jsr || opcode == op_jsr_w || opcode == op_ret) {
+            // 子程序里局部变量的合并需要区分调用点，不值得为旧版本的 class 文件实现
+            return false;
+        } else if (!((opcode >= op_ireturn && opcode <= op_return) || opcode == op_athrow)) {
+            endsBlock = false;
+        }
+        if (endsBlock && pc + length < codeLength) {
+            leaders[pc + length] = true;
+        }
+        pc += length;
+    }
+
+    FOR_EACH(i, code->exceptionTableLength) {
+        const auto &entry = code->exceptionTable[i];
+        if (entry.startPC >= entry.endPC || entry.endPC > codeLength || !markTarget(entry.handlerPC)) {
+            return false;
+        }
+    }
+
+    for (u4 i = 0; i < codeLength; i++) {
+        if (leaders[i]) {
+            blockIndex[i] = (int)blocks.size();
+            blocks.emplace_back();
+        }
+    }
+    return true;
+}
+
+void EscapeAnalysis::merge(u4 pc, const std::vector<uint64_t> &fromLocals, const std::vector<uint64_t> &fromStack) {
+    BlockState &block = blocks[blockIndex[pc]];
+    if (!block.reached) {
+        block.reached = true;
+        block.locals = fromLocals;
+        block.stack = fromStack;
+        worklist.push_back(pc);
+        return;
+    }
+    // 经过校验的代码在汇合点的栈深度一致
+    if (block.stack.size() != fromStack.size()) {
+        failed = true;
+        return;
+    }
+    bool changed = false;
+    FOR_EACH(i, fromLocals.size()) {
+        const uint64_t merged = block.locals[i] | fromLocals[i];
+        changed |= merged != block.locals[i];
+        block.locals[i] = merged;
+    }
+    FOR_EACH(i, fromStack.size()) {
+        const uint64_t merged = block.stack[i] | fromStack[i];
+        changed |= merged != block.stack[i];
+        block.stack[i] = merged;
+    }
+    if (changed) {
+        worklist.push_back(pc);
+    }
+}
+
+bool EscapeAnalysis::interpret(u4 start) {
+    const BlockState &block = blocks[blockIndex[start]];
+    locals = block.locals;
+    stack = block.stack;
+
+    const std::vector<uint64_t> exceptionStack(1, UNKNOWN);
+    u4 pc = start;
+    while (true) {
+        // 抛出异常时局部变量是指令执行前的状态
+        FOR_EACH(i, code->exceptionTableLength) {
+            const auto &entry = code->exceptionTable[i];
+            if (entry.startPC <= pc && pc < entry.endPC) {
+                merge(entry.handlerPC, locals, exceptionStack);
+            }
+        }
+
+        const u1 *bc = code->code + pc;
+        const u4 length = bytecodeLength(code->code, pc, code->codeLength);
+        if (!execute(pc)) {
+            return false;
+        }
+
+        const u1 opcode = bc[0];
+        if (isBranch(opcode)) {
+            merge((u4)((int64_t)pc + readBytecodeS2(bc + 1)), locals, stack);
+        } else if (opcode == op_goto) {
+            merge((u4)((int64_t)pc + readBytecodeS2(bc + 1)), locals, stack);
+            return true;
+        } else if (opcode == op_goto_w) {
+            merge((u4)((int64_t)pc + readBytecodeS4(bc + 1)), locals, stack);
+            return true;
+        } else if (opcode == op_tableswitch || opcode == op_lookupswitch) {
+            const u4 base = (pc + 4) & ~3u;
+            const u1 *p = code->code + base;
+            merge((u4)((int64_t)pc + readBytecodeS4(p)), locals, stack);
+            if (opcode == op_tableswitch) {
+                const int64_t count = (int64_t)readBytecodeS4(p + 8) - readBytecodeS4(p + 4) + 1;
+                for (int64_t i = 0; i < count; i++) {
+                    merge((u4)((int64_t)pc + readBytecodeS4(p + 12 + i * 4)), locals, stack);
+                }
+            } else {
+                const int32_t npairs = readBytecodeS4(p + 4);
+                for (int32_t i = 0; i < npairs; i++) {
+                    merge((u4)((int64_t)pc + readBytecodeS4(p + 12 + (int64_t)i * 8)), locals, stack);
+                }
+            }
+            return true;
+        } else if ((opcode >= op_ireturn && opcode <= op_return) || opcode == op_athrow) {
+            return true;
+        }
+
+        pc += length;
+        if (pc >= code->codeLength) {
+            return false;
+        }
+        if (blockIndex[pc] >= 0) {
+            merge(pc, locals, stack);
+            return true;
+        }
+    }
+}
+
+bool EscapeAnalysis::push(uint64_t value, int slots) {
+    if (stack.size() + slots > code->maxStack) {
+        return false;
+    }
+    stack.push_back(value);
+    for (int i = 1; i < slots; i++) {
+        stack.push_back(0);
+    }
+    return true;
+}
+
+bool EscapeAnalysis::pop(uint64_t &value, int slots) {
+    if (stack.size() < (std::size_t)slots) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < slots; i++) {
+        value |= stack.back();
+        stack.pop_back();
+    }
+    return true;
+}
+
+bool EscapeAnalysis::store(u2 index, uint64_t value, int slots) {
+    if (index + slots > code->maxLocals) {
+        return false;
+    }
+    locals[index] = value;
+    if (slots == 2) {
+        locals[index + 1] = 0;
+    }
+    return true;
+}
+
+bool EscapeAnalysis::dup(int n, int m) {
+    if (stack.size() < (std::size_t)(n + m) || stack.size() + n > code->maxStack) {
+        return false;
+    }
+    std::vector<uint64_t> top(stack.end() - n, stack.end());
+    stack.insert(stack.end() - n - m, top.begin(), top.end());
+    return true;
+}
+
+void EscapeAnalysis::escape(uint64_t value, EscapeState state) {
+    FOR_EACH(s, siteCount) {
+        if (((value >> s) & 1) && states[s] < state) {
+            states[s] = state;
+        }
+    }
+}
+
+void EscapeAnalysis::storeInto(uint64_t container, uint64_t value) {
+    if (value == 0) {
+        return;
+    }
+    // 存入参数或者来源未知的对象，之后可能被任何代码读到
+    if (container & (UNKNOWN | paramMask())) {
+        escape(value, EscapeState::GLOBAL_ESCAPE);
+    }
+    for (int s = paramSites; s < siteCount; s++) {
+        if ((container >> s) & 1) {
+            edges[s] |= value & ~UNKNOWN;
+        }
+    }
+}
+
+uint64_t EscapeAnalysis::paramMask() const {
+    return paramSites == 0 ? 0 : ((uint64_t)1 << paramSites) - 1;
+}
+
+uint64_t EscapeAnalysis::loadFrom(uint64_t container) const {
+    // 对象可能被传给过其它方法，字段中还可能有来源未知的对象
+    uint64_t result = UNKNOWN;
+    for (int s = paramSites; s < siteCount; s++) {
+        if ((container >> s) & 1) {
+            result |= edges[s];
+        }
+    }
+    return result;
+}
+
+uint64_t EscapeAnalysis::reachable(uint64_t value) const {
+    uint64_t result = value;
+    uint64_t last;
+    do {
+        last = result;
+        for (int s = paramSites; s < siteCount; s++) {
+            if ((result >> s) & 1) {
+                result |= edges[s];
+            }
+        }
+    } while (result != last);
+    return result;
+}
+
+bool EscapeAnalysis::accessField(u1 opcode, u2 index) {
+    auto *ref = index < jc->raw.constPoolCount ? dynamic_cast<CONSTANT_FieldRef*>(jc->raw.constPoolInfo[index])
+                                                : nullptr;
+    if (!ref) {
+        return false;
+    }
+    auto *nameAndType = dynamic_cast<CONSTANT_NameAndType*>(jc->raw.constPoolInfo[ref->nameAndTypeIndex]);
+    const char *descriptor = jc->getString(nameAndType->descriptorIndex);
+    const int slots = descriptor[0] == 'J' || descriptor[0] == 'D' ? 2 : 1;
+    const bool isReference = descriptor[0] == 'L' || descriptor[0] == '[';
+
+    uint64_t value, object;
+    switch (opcode) {
+        case op_getstatic:
+            return push(isReference ? UNKNOWN : 0, slots);
+        case op_putstatic:
+            if (!pop(value, slots)) {
+                return false;
+            }
+            if (isReference) {
+                escape(value, EscapeState::GLOBAL_ESCAPE);
+            }
+            return true;
+        case op_getfield:
+            return pop(object) && push(isReference ? loadFrom(object) : 0, slots);
+        default:
+            if (!pop(value, slots) || !pop(object)) {
+                return false;
+            }
+            if (isReference) {
+                storeInto(object, value);
+            }
+            return true;
+    }
+}
+
+bool EscapeAnalysis::invoke(u4 pc, u1 opcode) {
+    const u2 index = readBytecodeU2(code->code + pc + 1);
+    if (index == 0 || index >= jc->raw.constPoolCount) {
+        return false;
+    }
+    ConstantPoolInfo *cp = jc->raw.constPoolInfo[index];
+    u2 nameAndTypeIndex;
+    if (auto *ref = dynamic_cast<CONSTANT_MethodRef*>(cp)) {
+        nameAndTypeIndex = ref->nameAndTypeIndex;
+    } else if (auto *interfaceRef = dynamic_cast<CONSTANT_InterfaceMethodRef*>(cp)) {
+        nameAndTypeIndex = interfaceRef->nameAndTypeIndex;
+    } else if (auto *indy = dynamic_cast<CONSTANT_InvokeDynamic*>(cp)) {
+        nameAndTypeIndex = indy->nameAndTypeIndex;
+    } else {
+        return false;
+    }
+    auto *nameAndType = dynamic_cast<CONSTANT_NameAndType*>(jc->raw.constPoolInfo[nameAndTypeIndex]);
+    MethodSignature signature;
+    if (!parseMethodSignature(jc->getString(nameAndType->descriptorIndex), signature)) {
+        return false;
+    }
+
+    // 实参按被调用方法的局部变量槽位排列，下标 0 是接收者
+    const int receiver = opcode == op_invokestatic || opcode == op_invokedynamic ? 0 : 1;
+    std::size_t argSlots = signature.argSlots + receiver;
+    if (stack.size() < argSlots) {
+        return false;
+    }
+    std::vector<uint64_t> args(stack.end() - argSlots, stack.end());
+    stack.resize(stack.size() - argSlots);
+
+    JavaClass *owner = nullptr;
+    MethodInfo *target = jc->findStaticTarget(opcode, index, owner);
+    const EscapeInfo *info = target ? analyze(owner, target, depth + 1, active) : nullptr;
+    bool inlinable = false;
+    if (info) {
+        auto *targetCode = static_cast<ATTR_Code*>(owner->findAttribute(target->attributes, target->attributeCount,
+                                                                        AttributeKind::Code));
+        inlinable = targetCode->codeLength <= YVM_ESCAPE_ANALYSIS_INLINE_SIZE;
+    }
+
+    uint64_t passed = 0;
+    FOR_EACH(i, argSlots) {
+        if (args[i] == 0) {
+            continue;
+        }
+        passed |= args[i];
+        EscapeState state = EscapeState::GLOBAL_ESCAPE;
+        if (info && i < info->parameters.size()) {
+            state = info->parameters[i];
+            // 不会被内联的方法需要一个真实的对象作为参数
+            if (state == EscapeState::NO_ESCAPE && !inlinable) {
+                state = EscapeState::ARG_ESCAPE;
+            }
+        }
+        escape(args[i], state);
+    }
+
+    switch (signature.returnType) {
+        case T_EXTRA_VOID:
+            return true;
+        case T_LONG:
+        case T_DOUBLE:
+            return push(0, 2);
+        case T_EXTRA_OBJECT:
+            // 返回值可能是某个实参，或者实参的字段中的对象
+            return push(UNKNOWN | reachable(passed));
+        default:
+            return push(0);
+    }
+}
+
+bool EscapeAnalysis::execute(u4 pc) {
+    const u1 *bc = code->code + pc;
+    const u1 opcode = bc[0];
+    uint64_t value, index, array;
+
+    if (STACK_POP[opcode] >= 0) {
+        return pop(value, STACK_POP[opcode]) && (STACK_PUSH[opcode] == 0 || push(0, STACK_PUSH[opcode]));
+    }
+
+    switch (opcode) {
+        case op_ldc:
+        case op_ldc_w: {
+            const u2 cpIndex = opcode == op_ldc ? bc[1] : readBytecodeU2(bc + 1);
+            if (cpIndex == 0 || cpIndex >= jc->raw.constPoolCount) {
+                return false;
+            }
+            ConstantPoolInfo *cp = jc->raw.constPoolInfo[cpIndex];
+            const bool primitive = dynamic_cast<CONSTANT_Integer*>(cp) || dynamic_cast<CONSTANT_Float*>(cp);
+            return push(primitive ? 0 : UNKNOWN);
+        }
+
+        case op_aload:
+            return bc[1] < code->maxLocals && push(locals[bc[1]]);
+        case op_aload_0:
+        case op_aload_1:
+        case op_aload_2:
+        case op_aload_3:
+            return (u2)(opcode - op_aload_0) < code->maxLocals && push(locals[opcode - op_aload_0]);
+
+        case op_istore:
+        case op_lstore:
+        case op_fstore:
+        case op_dstore:
+        case op_astore: {
+            const int slots = LOCAL_SLOTS[opcode - op_istore];
+            return pop(value, slots) && store(bc[1], value, slots);
+        }
+        case op_istore_0: case op_istore_1: case op_istore_2: case op_istore_3:
+        case op_lstore_0: case op_lstore_1: case op_lstore_2: case op_lstore_3:
+        case op_fstore_0: case op_fstore_1: case op_fstore_2: case op_fstore_3:
+        case op_dstore_0: case op_dstore_1: case op_dstore_2: case op_dstore_3:
+        case op_astore_0: case op_astore_1: case op_astore_2: case op_astore_3: {
+            const int slots = LOCAL_SLOTS[(opcode - op_istore_0) / 4];
+            return pop(value, slots) && store((u2)((opcode - op_istore_0) % 4), value, slots);
+        }
+
+        case op_aaload:
+            return pop(index) && pop(array) && push(loadFrom(array));
+        case op_aastore:
+            if (!pop(value) || !pop(index) || !pop(array)) {
+                return false;
+            }
+            storeInto(array, value);
+            return true;
+
+        case op_dup:
+            return dup(1, 0);
+        case op_dup_x1:
+            return dup(1, 1);
+        case op_dup_x2:
+            return dup(1, 2);
+        case op_dup2:
+            return dup(2, 0);
+        case op_dup2_x1:
+            return dup(2, 1);
+        case op_dup2_x2:
+            return dup(2, 2);
+        case op_swap:
+            if (stack.size() < 2) {
+                return false;
+            }
+            std::swap(stack[stack.size() - 1], stack[stack.size() - 2]);
+            return true;
+
+        case op_ifeq: case op_ifne: case op_iflt: case op_ifge: case op_ifgt: case op_ifle:
+        case op_ifnull: case op_ifnonnull:
+        case op_tableswitch:
+        case op_lookupswitch:
+            return pop(value);
+        case op_if_icmpeq: case op_if_icmpne: case op_if_icmplt: case op_if_icmpge: case op_if_icmpgt:
+        case op_if_icmple: case op_if_acmpeq: case op_if_acmpne:
+            return pop(value, 2);
+        case op_goto:
+        case op_goto_w:
+        case op_return:
+            return true;
+        case op_ireturn:
+        case op_freturn:
+            return pop(value);
+        case op_lreturn:
+        case op_dreturn:
+            return pop(value, 2);
+        case op_areturn:
+            // 返回给调用方，是否逃逸出线程由调用方决定
+            if (!pop(value)) {
+                return false;
+            }
+            escape(value, EscapeState::ARG_ESCAPE);
+            return true;
+
+        case op_getstatic:
+        case op_putstatic:
+        case op_getfield:
+        case op_putfield:
+            return accessField(opcode, readBytecodeU2(bc + 1));
+        case op_invokevirtual:
+        case op_invokespecial:
+        case op_invokestatic:
+        case op_invokeinterface:
+        case op_invokedynamic:
+            return invoke(pc, opcode);
+
+        case op_new:
+            return push(siteIndex[pc] >= 0 ? (uint64_t)1 << siteIndex[pc] : UNKNOWN);
+        case op_newarray:
+        case op_anewarray:
+            return pop(value) && push(siteIndex[pc] >= 0 ? (uint64_t)1 << siteIndex[pc] : UNKNOWN);
+        case op_multianewarray:
+            return pop(value, bc[3]) && push(siteIndex[pc] >= 0 ? (uint64_t)1 << siteIndex[pc] : UNKNOWN);
+
+        case op_athrow:
+            if (!pop(value)) {
+                return false;
+            }
+            escape(value, EscapeState::GLOBAL_ESCAPE);
+            return true;
+        case op_checkcast:
+            return !stack.empty();
+        case op_monitorenter:
+        case op_monitorexit:
+            if (!pop(value)) {
+                return false;
+            }
+            monitors[pc] |= value;
+            return true;
+
+        case op_wide: {
+            const u2 local = readBytecodeU2(bc + 2);
+            switch (bc[1]) {
+                case op_iload:
+                case op_fload:
+                    return push(0);
+                case op_lload:
+                case op_dload:
+                    return push(0, 2);
+                case op_aload:
+                    return local < code->maxLocals && push(locals[local]);
+                case op_istore:
+                case op_lstore:
+                case op_fstore:
+                case op_dstore:
+                case op_astore: {
+                    const int slots = LOCAL_SLOTS[bc[1] - op_istore];
+                    return pop(value, slots) && store(local, value, slots);
+                }
+                case op_iinc:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,140 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_ESCAPEANALYSIS_H
+#define CJVM_ESCAPEANALYSIS_H
+
+#include <map>
+#include <vector>
+#include "Type.h"
+
+class JavaClass;
+class MethodInfo;
+class ATTR_Code;
+
+/**
+ * 对象的逃逸状态，按逃逸程度从低到高排列
+ *
+ * NO_ESCAPE:       只在方法内使用，可以标量替换，对它的加锁可以省略
+ * ARG_ESCAPE:      作为参数传给了无法内联的方法或者作为返回值返回，但不会被其它线程看到，可以栈上分配，加锁可以省略
+ * GLOBAL_ESCAPE:   存入了静态字段、逃逸对象的字段或者被抛出，必须在堆上分配
+ */
+enum class EscapeState : u1 {
+    NO_ESCAPE,
+    ARG_ESCAPE,
+    GLOBAL_ESCAPE
+};
+
+class AllocationSite {
+public:
+    // new/newarray/anewarray/multianewarray 指令的位置
+    u4 pc;
+    EscapeState state;
+};
+
+/**
+ * 一个方法的逃逸分析结果，供编译器做标量替换、栈上分配和锁消除
+ */
+class EscapeInfo {
+public:
+    // 按 pc 升序
+    std::vector<AllocationSite> allocations;
+    // 按局部变量槽位记录每个参数(包括 this)在方法内的逃逸状态，非引用参数为 NO_ESCAPE
+    std::vector<EscapeState> parameters;
+    // 加锁对象不会逃逸出当前线程的 monitorenter/monitorexit 的位置，按 pc 升序
+    std::vector<u4> elidableMonitors;
+
+    // pc 不是分配指令时返回 GLOBAL_ESCAPE
+    EscapeState allocationState(u4 pc) const;
+    bool isMonitorElidable(u4 pc) const;
+};
+
+/**
+ * 基于字节码的过程内逃逸分析
+ *
+ * 把局部变量表和操作数栈上的每个槽抽象为它可能指向的分配点集合(64 位的位图)，
+ * 参数也各自占一个伪分配点，无法跟踪来源的引用(字段、数组元素、调用的返回值等)记为 UNKNOWN。
+ * 在基本块之间迭代到不动点，同时记录每个分配点的逃逸事件，以及对象之间"存入字段"的关系，
+ * 最后容器对象的逃逸状态沿这些关系传递给被存入的对象。
+ *
+ * 静态绑定的调用(invokestatic、invokespecial 以及 private/final 方法)递归分析被调用方法的参数逃逸状态，
+ * 代替内联之后的分析：参数在被调用方法中不逃逸且被调用方法足够小、会被内联时，实参不因调用而逃逸
+ */
+class EscapeAnalysis {
+public:
+    // 分析结果缓存在 MethodInfo 中，没有字节码的方法(native/abstract)返回 nullptr
+    static const EscapeInfo* analyze(JavaClass *jc, MethodInfo *method);
+
+private:
+    // 位图中最多跟踪的分配点个数，最高位表示 UNKNOWN
+    static const int MAX_SITES = 63;
+    static const uint64_t UNKNOWN = (uint64_t)1 << 63;
+
+    class BlockState {
+    public:
+        bool reached = false;
+        std::vector<uint64_t> locals;
+        std::vector<uint64_t> stack;
+    };
+
+    EscapeAnalysis(JavaClass *jc, MethodInfo *method, ATTR_Code *code, int depth,
+                   std::vector<const MethodInfo*> &active);
+
+    static const EscapeInfo* analyze(JavaClass *jc, MethodInfo *method, int depth,
+                                     std::vector<const MethodInfo*> &active);
+
+    EscapeInfo* run();
+    bool computeBlocks();
+    void merge(u4 pc, const std::vector<uint64_t> &locals, const std::vector<uint64_t> &stack);
+    bool interpret(u4 start);
+    bool execute(u4 pc);
+    bool invoke(u4 pc, u1 opcode);
+    bool accessField(u1 opcode, u2 index);
+
+    bool push(uint64_t value, int slots = 1);
+    bool pop(uint64_t &value, int slots = 1);
+    bool store(u2 index, uint64_t value, int slots = 1);
+    bool dup(int n, int m);
+
+    uint64_t paramMask() const;
+    // 从 container 中的对象的字段和数组元素读到的对象
+    uint64_t loadFrom(uint64_t container) const;
+    // value 以及从它的字段能间接到达的对象
+    uint64_t reachable(uint64_t value) const;
+    void escape(uint64_t value, EscapeState state);
+    // value 被存入 container 的字段或者数组元素中
+    void storeInto(uint64_t container, uint64_t value);
+    EscapeInfo* conservativeResult();
+
+private:
+    JavaClass *jc;
+    MethodInfo *method;
+    ATTR_Code *code;
+    int depth;
+    std::vector<const MethodInfo*> &active;
+
+    // 参数占用的伪分配点个数，之后是真正的分配点
+    int paramSites = 0;
+    int siteCount = 0;
+    std::vector<u2> paramSlots;
+    std::vector<u4> sitePCs;
+    std::vector<int> siteIndex;
+
+    std::vector<EscapeState> states;
+    // edges[s] 为存入过分配点 s 的字段或元素的对象集合
+    std::vector<uint64_t> edges;
+    // monitor 指令的位置到加锁对象可能的集合
+    std::map<u4, uint64_t> monitors;
+
+    // 基本块的入口 pc 到 blocks 的下标，不是入口为 -1
+    std::vector<int> blockIndex;
+    std::vector<BlockState> blocks;
+    std::vector<u4> worklist;
+    std::vector<uint64_t> locals;
+    std::vector<uint64_t> stack;
+    bool failed = false;
+};
+
+
+#endif //CJVM_ESCAPEANALYSIS_H
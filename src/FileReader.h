@@ -6,54 +6,130 @@
 #define CJVM_FILEREADER_H
 
 #include <fstream>
+#include <vector>
+#include <cstring>
+#include <iterator>
 #include "Type.h"
 
+/**
+ * class 文件一次性读入内存，之后的读取只是移动游标。
+ * 也可以直接读取调用者提供的一段内存(如 jar 中解压出的数据)，此时不拷贝，由调用者保证其生命周期
+ *
+ * 内容在类的整个生命周期内保留，延迟解析的属性记下偏移量，需要时再回来解码
+ */
 class FileReader {
 public:
     FileReader() = default;
 
-    FileReader(const std::string filePath) : fin(filePath, std::ios::binary) {
-        this->filePath = filePath;
+    FileReader(const std::string filePath) {
+        openFile(filePath);
     }
 
-    ~FileReader() {
-        fin.close();
+    FileReader(const u1 *data, std::size_t size) : buf(data), size(size) {}
+
+    // 接管调用者读出的内容(如从 jar 中解压出的数据)
+    explicit FileReader(std::vector<u1> &&bytes) : storage(std::move(bytes)) {
+        buf = storage.data();
+        size = storage.size();
     }
 
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+
     bool openFile(const std::string filePath) {
+        if (buf) {
+            return true;
+        }
+
+        std::ifstream fin(filePath, std::ios::binary);
         if (!fin.is_open()) {
-            fin.open(filePath, std::ios::binary);
-            return fin.is_open();
+            return false;
         }
+        this->filePath = filePath;
+        storage.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        buf = storage.data();
+        size = storage.size();
+        pos = 0;
         return true;
     }
 
     bool hasNoExtraBytes() {
-        return fin.peek() == EOF;
+        return pos == size;
     }
 
+    // 读取越过了末尾，说明 class 文件被截断
+    bool isTruncated() const {
+        return truncated;
+    }
+
+    // 整个 class 文件的内容
+    const u1* data() const { return buf; }
+    std::size_t length() const { return size; }
+
+    std::size_t tell() const { return pos; }
+    void seek(std::size_t offset) { pos = offset; }
+
+    void skip(std::size_t bytes) {
+        if (!require(bytes)) {
+            return;
+        }
+        pos += bytes;
+    }
+
+    // 当前位置的原始字节，调用者需要先检查剩余长度
+    const u1* current() const { return buf + pos; }
+
+    void readBytes(u1 *dst, std::size_t bytes) {
+        if (!require(bytes)) {
+            return;
+        }
+        std::memcpy(dst, buf + pos, bytes);
+        pos += bytes;
+    }
 
     u4 readU4() {
-        fin.read(u4buf, 4);
-        return getu4(u4buf);
+        if (!require(4)) {
+            return 0;
+        }
+        const u1 *p = buf + pos;
+        u4 v = getu4(p);
+        pos += 4;
+        return v;
     }
 
     u2 readU2() {
-        fin.read(u2buf, 2);
-        return getu2(u2buf);
+        if (!require(2)) {
+            return 0;
+        }
+        const u1 *p = buf + pos;
+        u2 v = getu2(p);
+        pos += 2;
+        return v;
     }
 
     u1 readU1() {
-        fin.read(u1buf, 1);
-        return getu1(u1buf);
+        if (!require(1)) {
+            return 0;
+        }
+        return buf[pos++];
     }
 
 private:
-    std::ifstream fin;
+    inline bool require(std::size_t bytes) {
+        if (bytes > size - pos) {
+            truncated = true;
+            pos = size;
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<u1> storage;
+    const u1 *buf = nullptr;
+    std::size_t size = 0;
+    std::size_t pos = 0;
+    bool truncated = false;
     std::string filePath;
-    char u4buf[4];
-    char u2buf[2];
-    char u1buf[1];
 };
 
 #endif //CJVM_FILEREADER_H
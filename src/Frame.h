@@ -8,6 +8,7 @@
 #include <deque>
 #include <mutex>
 #include <atomic>
+#include "Type.h"
 #include "JavaType.h"
 #include "Concurrent.hpp"
 
@@ -18,6 +19,9 @@ public:
     std::deque<JType*> locals;
     std::deque<JType*> stack;
 
+    // 虚拟线程挂起时保存的字节码位置，恢复执行时从这里继续
+    u4 pc = 0;
+
     ~Frame() {
         while (!locals.empty()) {
             auto *temp = locals.back();
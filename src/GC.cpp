@@ -3,3 +3,12 @@
 //
 
 #include "GC.h"
+
+void ConcurrentGC::satbEnqueue(const HeapRef *refs, size_t count) {
+    std::lock_guard<SpinLock> lock(satbSpin);
+    for (size_t i = 0; i < count; ++i) {
+        if (refs[i] != 0) {
+            satbQueue.push_back(decodeReference(refs[i]));
+        }
+    }
+}
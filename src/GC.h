@@ -6,10 +6,12 @@
 #define CJVM_GC_H
 
 #include <unordered_set>
+#include <vector>
 #include <memory>
 
 #include "Option.h"
 #include "RuntimeEnv.h"
+#include "JavaHeap.h"
 #include "Concurrent.hpp"
 
 class JType;
@@ -21,7 +23,7 @@ enum class GCPolicy {
 class ConcurrentGC {
 
 public:
-    ConcurrentGC() : overMemoryThreshold(false), safepointWaitCnt(0) {
+    ConcurrentGC() : overMemoryThreshold(false), marking(false), safepointWaitCnt(0) {
         gcThreadPool.initialize(std::thread::hardware_concurrency());
     }
 
@@ -32,6 +34,10 @@ public:
 
     void terminateGC() { gcThreadPool.finalize(); }
 
+    // 写屏障(SATB)：并发标记期间被覆盖的引用先记录下来，保证标记开始时可达的对象不会漏标
+    bool isMarking() const { return marking.load(std::memory_order_acquire); }
+    void satbEnqueue(const HeapRef *refs, size_t count);
+
 private:
     inline void pushObjectBitmap(size_t offset) {
         objectBitmap.insert(offset);
@@ -49,6 +55,10 @@ private:
     std::atomic_bool overMemoryThreshold;
     std::mutex overMemoryThresholdMtx;
 
+    std::atomic_bool marking;
+    std::vector<size_t> satbQueue;
+    SpinLock satbSpin;
+
     int safepointWaitCnt;
     std::mutex safepointWaitMtx;
     std::condition_variable safepointWaitCond;
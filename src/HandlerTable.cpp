@@ -0,0 +1,94 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <algorithm>
+#include "HandlerTable.h"
+#include "ClassFile.h"
+#include "JavaClass.h"
+
+HandlerTable* HandlerTable::build(const ATTR_Code *code, bool &valid) {
+    valid = true;
+    u2 length = code->exceptionTableLength;
+    if (length == 0) {
+        return nullptr;
+    }
+
+    std::vector<u2> bounds;
+    bounds.reserve(length * 2);
+    FOR_EACH(i, length) {
+        const auto &entry = code->exceptionTable[i];
+        if (entry.startPC >= entry.endPC || entry.endPC > code->codeLength || entry.handlerPC >= code->codeLength) {
+            valid = false;
+            return nullptr;
+        }
+        bounds.push_back(entry.startPC);
+        bounds.push_back(entry.endPC);
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    auto *table = new HandlerTable;
+    table->handlers = new ExceptionHandler[length];
+    FOR_EACH(i, length) {
+        table->handlers[i].handlerPC = code->exceptionTable[i].handlerPC;
+        table->handlers[i].catchType = code->exceptionTable[i].catchType;
+    }
+
+    for (std::size_t k = 0; k < bounds.size(); k++) {
+        Range range{bounds[k], 0, (u4)table->indices.size()};
+        FOR_EACH(i, length) {
+            const auto &entry = code->exceptionTable[i];
+            if (entry.startPC <= bounds[k] && bounds[k] < entry.endPC) {
+                table->indices.push_back(i);
+                range.count++;
+            }
+        }
+
+        // 和前一个区间的处理器完全相同时合并
+        if (!table->ranges.empty()) {
+            const Range &prev = table->ranges.back();
+            if (prev.count == range.count &&
+                std::equal(table->indices.begin() + range.first, table->indices.end(),
+                           table->indices.begin() + prev.first)) {
+                table->indices.resize(range.first);
+                continue;
+            }
+        }
+        table->ranges.push_back(range);
+    }
+    return table;
+}
+
+int32_t HandlerTable::findHandler(JavaClass *jc, u4 pc, const JavaClass *exceptionClass) {
+    // 最后一个 startPC <= pc 的区间
+    auto it = std::upper_bound(ranges.cbegin(), ranges.cend(), pc,
+                               [](u4 value, const Range &range) { return value < range.startPC; });
+    if (it == ranges.cbegin()) {
+        return -1;
+    }
+    const Range &range = *(it - 1);
+
+    FOR_EACH(i, range.count) {
+        ExceptionHandler &handler = handlers[indices[range.first + i]];
+        if (handler.catchType == 0) {
+            return handler.handlerPC;
+        }
+        // 数组类不是 Throwable 的子类，不会匹配任何异常
+        if (jc->isArrayClass(handler.catchType)) {
+            continue;
+        }
+        JavaClass *catchClass = handler.catchClass.load(std::memory_order_acquire);
+        if (!catchClass) {
+            catchClass = jc->resolveClass(handler.catchType);
+            if (!catchClass) {
+                return -1;
+            }
+            handler.catchClass.store(catchClass, std::memory_order_release);
+        }
+        if (exceptionClass->isSubtypeOf(catchClass)) {
+            return handler.handlerPC;
+        }
+    }
+    return -1;
+}
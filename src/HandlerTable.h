@@ -0,0 +1,69 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_HANDLERTABLE_H
+#define CJVM_HANDLERTABLE_H
+
+#include <atomic>
+#include <vector>
+#include "Type.h"
+
+class JavaClass;
+class ATTR_Code;
+
+/**
+ * 异常处理器
+ *
+ * catchType:   捕获的异常类在常量池中的下标，0 表示捕获所有异常(finally)
+ * catchClass:  第一次匹配时解析出的异常类，之后直接比较
+ */
+class ExceptionHandler {
+public:
+    u2 handlerPC = 0;
+    u2 catchType = 0;
+    std::atomic<JavaClass*> catchClass{nullptr};
+};
+
+/**
+ * 方法的异常处理表，链接时由 Code 属性的 exception_table 生成
+ *
+ * 把所有处理器的 [startPC, endPC) 端点排序后，字节码被切分成若干互不相交的区间，
+ * 每个区间记录覆盖它的处理器(保持异常表中的原有顺序，即匹配的优先级)。
+ * 抛出异常时二分查找 pc 所在的区间，只依次比较覆盖该 pc 的处理器，不必扫描整个异常表
+ */
+class HandlerTable {
+public:
+    // 异常表为空时返回 nullptr，异常表中的范围非法时 valid 置为 false
+    static HandlerTable* build(const ATTR_Code *code, bool &valid);
+
+    ~HandlerTable() {
+        delete[] handlers;
+    }
+
+    /**
+     * 查找 pc 处抛出的 exceptionClass 异常的处理器，返回处理器的 pc，没有找到返回 -1。
+     * jc 为方法所在的类，用来解析 catchType。异常类解析失败时在当前线程上标记异常并返回 -1
+     */
+    int32_t findHandler(JavaClass *jc, u4 pc, const JavaClass *exceptionClass);
+
+private:
+    class Range {
+    public:
+        u2 startPC;
+        // 覆盖该区间的处理器个数，不超过异常表的长度
+        u2 count;
+        // 它们在 indices 中的位置。indices 最长为区间数(不超过 65536)乘以异常表长度，超出 u2 但不会超出 u4
+        u4 first;
+    };
+
+    HandlerTable() = default;
+
+    ExceptionHandler *handlers = nullptr;
+    // 按 startPC 升序，相邻区间首尾相接，最后一个区间的 count 为 0
+    std::vector<Range> ranges;
+    std::vector<u2> indices;
+};
+
+
+#endif //CJVM_HANDLERTABLE_H
@@ -0,0 +1,445 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include "Intrinsic.h"
+#include "ArrayOps.h"
+#include "JavaString.h"
+#include "GC.h"
+#include "NativeMethod.h"
+#include "JavaClass.h"
+#include "JavaHeap.h"
+#include "JavaThread.h"
+#include "RuntimeEnv.h"
+
+static inline void throwJavaException(const char *exceptionClassName, const char *message = nullptr) {
+    currentThread->exception.throwNew(exceptionClassName, message);
+}
+
+static inline JArray* asArray(jobject obj) {
+    return dynamic_cast<JArray*>(obj);
+}
+
+static inline bool isPrimitiveArray(const ArrayHeader *header) {
+    return header->componentType != T_EXTRA_OBJECT;
+}
+
+
+// 数组对象没有 JavaClass，只能存入 Object、Cloneable 和 Serializable 数组
+static bool isArraySupertype(const JavaClass *jc) {
+    return !jc->getSuperClass() || std::strcmp(jc->getClassName(), "java/lang/Cloneable") == 0 ||
+           std::strcmp(jc->getClassName(), "java/io/Serializable") == 0;
+}
+
+// src 中从头开始连续多少个元素可以存入元素类型为 componentClass 的数组，
+// componentClass 为 nullptr 表示目标数组的元素本身是数组，只能存入数组
+static std::size_t storablePrefix(JavaHeap *heap, const HeapRef *src, std::size_t count,
+                                  const JavaClass *componentClass) {
+    FOR_EACH(i, count) {
+        std::size_t obj = decodeReference(src[i]);
+        if (obj == 0) {
+            continue;
+        }
+        const ObjectHeader *header = heap->at<ObjectHeader>(obj);
+        const bool isArray = (header->mark & ObjectHeader::MARK_ARRAY) != 0;
+        const bool storable = !componentClass ? isArray
+                : isArray ? isArraySupertype(componentClass) : header->jc->isSubtypeOf(componentClass);
+        if (!storable) {
+            return i;
+        }
+    }
+    return count;
+}
+
+
+/****************************************************************************
+ * java.lang.System
+ ****************************************************************************/
+static void java_lang_System_arraycopy(RuntimeEnv *env, jobject src, jint srcPos, jobject dst, jint dstPos,
+                                       jint length) {
+    JArray *srcArray = asArray(src);
+    JArray *dstArray = asArray(dst);
+    if (!src || !dst || (srcArray && srcArray->offset == 0) || (dstArray && dstArray->offset == 0)) {
+        throwJavaException("java/lang/NullPointerException");
+        return;
+    }
+    if (!srcArray || !dstArray) {
+        throwJavaException("java/lang/ArrayStoreException", "arraycopy: argument type mismatch");
+        return;
+    }
+
+    const ArrayHeader *srcHeader = env->jheap->arrayHeader(srcArray->offset);
+    const ArrayHeader *dstHeader = env->jheap->arrayHeader(dstArray->offset);
+    if (srcHeader->componentType != dstHeader->componentType) {
+        throwJavaException("java/lang/ArrayStoreException", "arraycopy: type mismatch");
+        return;
+    }
+    if (srcPos < 0 || dstPos < 0 || length < 0 ||
+        (int64_t)srcPos + length > srcHeader->length || (int64_t)dstPos + length > dstHeader->length) {
+        throwJavaException("java/lang/ArrayIndexOutOfBoundsException", "arraycopy: last index out of bounds");
+        return;
+    }
+
+    std::size_t elementSize = arrayElementSize(srcHeader->componentType);
+    u1 *to = env->jheap->arrayElements(dstArray->offset) + dstPos * elementSize;
+    const u1 *from = env->jheap->arrayElements(srcArray->offset) + srcPos * elementSize;
+    if (isPrimitiveArray(srcHeader)) {
+        ArrayOps::copy(to, from, length * elementSize);
+        return;
+    }
+
+    // 源数组的元素类型不是目标元素类型的子类型时逐个检查元素，
+    // 遇到不能存入的元素时只复制它之前的部分，然后抛出 ArrayStoreException。
+    // 元素是数组时 componentClass 为 nullptr，只有一边为 nullptr 时也要检查；
+    // 两边都是数组的数组时堆上没有记录维数和最内层的元素类型，无法进一步检查
+    std::size_t count = (std::size_t)length;
+    const JavaClass *srcComponent = srcHeader->componentClass;
+    const JavaClass *dstComponent = dstHeader->componentClass;
+    const bool subtype = srcComponent && dstComponent ? srcComponent->isSubtypeOf(dstComponent)
+                                                      : srcComponent == dstComponent;
+    if (!subtype) {
+        count = storablePrefix(env->jheap, reinterpret_cast<const HeapRef*>(from), count, dstComponent);
+    }
+    if (env->jheap->isPublished(dstArray->offset) && !env->jheap->isPublished(srcArray->offset)) {
+        for (std::size_t i = 0; i < count; ++i) {
+            env->jheap->publishOnStore(dstArray->offset, decodeReference(reinterpret_cast<const HeapRef*>(from)[i]));
+        }
+    }
+    ArrayOps::copyReferences(env->gc, reinterpret_cast<HeapRef*>(to), reinterpret_cast<const HeapRef*>(from), count);
+    if (count < (std::size_t)length) {
+        throwJavaException("java/lang/ArrayStoreException", "arraycopy: element type mismatch");
+    }
+}
+
+
+/****************************************************************************
+ * java.lang.Math
+ ****************************************************************************/
+static jint java_lang_Math_abs_I(RuntimeEnv *env, jint a) { return a < 0 ? (jint)(0u - (uint32_t)a) : a; }
+static jlong java_lang_Math_abs_J(RuntimeEnv *env, jlong a) { return a < 0 ? (jlong)(0ull - (uint64_t)a) : a; }
+static jfloat java_lang_Math_abs_F(RuntimeEnv *env, jfloat a) { return std::fabs(a); }
+static jdouble java_lang_Math_abs_D(RuntimeEnv *env, jdouble a) { return std::fabs(a); }
+static jint java_lang_Math_min_I(RuntimeEnv *env, jint a, jint b) { return a <= b ? a : b; }
+static jlong java_lang_Math_min_J(RuntimeEnv *env, jlong a, jlong b) { return a <= b ? a : b; }
+static jint java_lang_Math_max_I(RuntimeEnv *env, jint a, jint b) { return a >= b ? a : b; }
+static jlong java_lang_Math_max_J(RuntimeEnv *env, jlong a, jlong b) { return a >= b ? a : b; }
+static jdouble java_lang_Math_sqrt(RuntimeEnv *env, jdouble a) { return std::sqrt(a); }
+static jdouble java_lang_Math_sin(RuntimeEnv *env, jdouble a) { return std::sin(a); }
+static jdouble java_lang_Math_cos(RuntimeEnv *env, jdouble a) { return std::cos(a); }
+static jdouble java_lang_Math_tan(RuntimeEnv *env, jdouble a) { return std::tan(a); }
+static jdouble java_lang_Math_log(RuntimeEnv *env, jdouble a) { return std::log(a); }
+static jdouble java_lang_Math_log10(RuntimeEnv *env, jdouble a) { return std::log10(a); }
+static jdouble java_lang_Math_exp(RuntimeEnv *env, jdouble a) { return std::exp(a); }
+
+static jdouble java_lang_Math_pow(RuntimeEnv *env, jdouble a, jdouble b) {
+    // 与 C 不同，Java 中 pow(1.0, NaN) 为 NaN
+    if (std::isnan(b)) {
+        return b;
+    }
+    return std::pow(a, b);
+}
+
+
+/****************************************************************************
+ * java.lang.Integer / java.lang.Long
+ ****************************************************************************/
+static jint java_lang_Integer_bitCount(RuntimeEnv *env, jint i) {
+    return __builtin_popcount((uint32_t)i);
+}
+
+static jint java_lang_Integer_numberOfLeadingZeros(RuntimeEnv *env, jint i) {
+    return i == 0 ? 32 : __builtin_clz((uint32_t)i);
+}
+
+static jint java_lang_Integer_numberOfTrailingZeros(RuntimeEnv *env, jint i) {
+    return i == 0 ? 32 : __builtin_ctz((uint32_t)i);
+}
+
+static jint java_lang_Integer_reverseBytes(RuntimeEnv *env, jint i) {
+    return (jint)__builtin_bswap32((uint32_t)i);
+}
+
+static jint java_lang_Long_bitCount(RuntimeEnv *env, jlong i) {
+    return __builtin_popcountll((uint64_t)i);
+}
+
+static jint java_lang_Long_numberOfLeadingZeros(RuntimeEnv *env, jlong i) {
+    return i == 0 ? 64 : __builtin_clzll((uint64_t)i);
+}
+
+static jint java_lang_Long_numberOfTrailingZeros(RuntimeEnv *env, jlong i) {
+    return i == 0 ? 64 : __builtin_ctzll((uint64_t)i);
+}
+
+static jlong java_lang_Long_reverseBytes(RuntimeEnv *env, jlong i) {
+    return (jlong)__builtin_bswap64((uint64_t)i);
+}
+
+
+/****************************************************************************
+ * java.util.Arrays
+ ****************************************************************************/
+template<typename T>
+static void arraysFill(RuntimeEnv *env, jobject a, T val) {
+    JArray *array = asArray(a);
+    if (!array || array->offset == 0) {
+        throwJavaException("java/lang/NullPointerException");
+        return;
+    }
+    uint64_t pattern = 0;
+    std::memcpy(&pattern, &val, sizeof(T));
+    ArrayOps::fill(env->jheap->arrayElements(array->offset), pattern, sizeof(T),
+                   (std::size_t)env->jheap->arrayHeader(array->offset)->length);
+}
+
+template<typename T>
+static jboolean arraysEquals(RuntimeEnv *env, jobject a, jobject b) {
+    JArray *x = asArray(a);
+    JArray *y = asArray(b);
+    std::size_t xOffset = x ? x->offset : 0;
+    std::size_t yOffset = y ? y->offset : 0;
+    if (xOffset == yOffset) {
+        return 1;
+    }
+    if (xOffset == 0 || yOffset == 0) {
+        return 0;
+    }
+
+    int32_t length = env->jheap->arrayHeader(xOffset)->length;
+    if (length != env->jheap->arrayHeader(yOffset)->length) {
+        return 0;
+    }
+    return (jboolean)ArrayOps::equals(env->jheap->arrayElements(xOffset), env->jheap->arrayElements(yOffset),
+                                      length * sizeof(T));
+}
+
+static jint arraysHashCode(RuntimeEnv *env, jobject a) {
+    JArray *array = asArray(a);
+    if (!array || array->offset == 0) {
+        return 0;
+    }
+    const ArrayHeader *header = env->jheap->arrayHeader(array->offset);
+    return ArrayOps::hash(header->componentType, env->jheap->arrayElements(array->offset), header->length);
+}
+
+static jint arraysCompare(RuntimeEnv *env, jobject a, jobject b) {
+    JArray *x = asArray(a);
+    JArray *y = asArray(b);
+    std::size_t xOffset = x ? x->offset : 0;
+    std::size_t yOffset = y ? y->offset : 0;
+    if (xOffset == yOffset) {
+        return 0;
+    }
+    // null 小于任何非 null 数组
+    if (xOffset == 0 || yOffset == 0) {
+        return xOffset == 0 ? -1 : 1;
+    }
+
+    const ArrayHeader *xHeader = env->jheap->arrayHeader(xOffset);
+    const ArrayHeader *yHeader = env->jheap->arrayHeader(yOffset);
+    return ArrayOps::compare(xHeader->componentType, env->jheap->arrayElements(xOffset), xHeader->length,
+                             env->jheap->arrayElements(yOffset), yHeader->length);
+}
+
+template<typename T>
+static jobject arraysCopyOf(RuntimeEnv *env, jobject original, jint newLength) {
+    JArray *array = asArray(original);
+    if (!array || array->offset == 0) {
+        throwJavaException("java/lang/NullPointerException");
+        return nullptr;
+    }
+    if (newLength < 0) {
+        throwJavaException("java/lang/NegativeArraySizeException", std::to_string(newLength).c_str());
+        return nullptr;
+    }
+
+    const ArrayHeader *header = env->jheap->arrayHeader(array->offset);
+    std::size_t copy = env->jheap->allocateArray(currentThread->tlab, header->componentType, newLength,
+                                                 header->componentClass);
+    if (copy == 0) {
+        throwJavaException("java/lang/OutOfMemoryError", "Java heap space");
+        return nullptr;
+    }
+    int32_t length = header->length < newLength ? header->length : newLength;
+    ArrayOps::copy(env->jheap->arrayElements(copy), env->jheap->arrayElements(array->offset), length * sizeof(T));
+
+    currentThread->localArray.offset = copy;
+    currentThread->localArray.length = newLength;
+    return &currentThread->localArray;
+}
+
+static void java_util_Arrays_fill_B(RuntimeEnv *env, jobject a, jbyte val) { arraysFill<jbyte>(env, a, val); }
+static void java_util_Arrays_fill_C(RuntimeEnv *env, jobject a, jchar val) { arraysFill<jchar>(env, a, val); }
+static void java_util_Arrays_fill_I(RuntimeEnv *env, jobject a, jint val) { arraysFill<jint>(env, a, val); }
+static void java_util_Arrays_fill_J(RuntimeEnv *env, jobject a, jlong val) { arraysFill<jlong>(env, a, val); }
+
+static jboolean java_util_Arrays_equals_B(RuntimeEnv *env, jobject a, jobject b) {
+    return arraysEquals<jbyte>(env, a, b);
+}
+static jboolean java_util_Arrays_equals_C(RuntimeEnv *env, jobject a, jobject b) {
+    return arraysEquals<jchar>(env, a, b);
+}
+static jboolean java_util_Arrays_equals_I(RuntimeEnv *env, jobject a, jobject b) {
+    return arraysEquals<jint>(env, a, b);
+}
+static jboolean java_util_Arrays_equals_J(RuntimeEnv *env, jobject a, jobject b) {
+    return arraysEquals<jlong>(env, a, b);
+}
+
+static jobject java_util_Arrays_copyOf_B(RuntimeEnv *env, jobject a, jint n) { return arraysCopyOf<jbyte>(env, a, n); }
+static jobject java_util_Arrays_copyOf_C(RuntimeEnv *env, jobject a, jint n) { return arraysCopyOf<jchar>(env, a, n); }
+static jobject java_util_Arrays_copyOf_I(RuntimeEnv *env, jobject a, jint n) { return arraysCopyOf<jint>(env, a, n); }
+static jobject java_util_Arrays_copyOf_J(RuntimeEnv *env, jobject a, jint n) { return arraysCopyOf<jlong>(env, a, n); }
+
+static jint java_util_Arrays_hashCode(RuntimeEnv *env, jobject a) { return arraysHashCode(env, a); }
+static jint java_util_Arrays_compare(RuntimeEnv *env, jobject a, jobject b) { return arraysCompare(env, a, b); }
+
+
+/****************************************************************************
+ * java.lang.String
+ *
+ * 虚拟机创建的字符串都采用 StringObject 的布局，这些方法直接操作 value，不执行字节码
+ ****************************************************************************/
+static inline std::size_t stringOffset(jobject str) {
+    JObject *obj = dynamic_cast<JObject*>(str);
+    return obj ? obj->offset : 0;
+}
+
+static jboolean java_lang_String_equals(RuntimeEnv *env, jobject self, jobject other) {
+    std::size_t a = stringOffset(self);
+    std::size_t b = stringOffset(other);
+    if (b == 0) {
+        return 0;
+    }
+    const JObject *x = dynamic_cast<JObject*>(self);
+    const JObject *y = dynamic_cast<JObject*>(other);
+    // 只有两个都是 String 才比较内容
+    if (x->jc != y->jc) {
+        return 0;
+    }
+    return (jboolean)JavaString::equals(env->jheap, a, b);
+}
+
+static jint java_lang_String_hashCode(RuntimeEnv *env, jobject self) {
+    return JavaString::hashCode(env->jheap, stringOffset(self));
+}
+
+static jint java_lang_String_length(RuntimeEnv *env, jobject self) {
+    return JavaString::length(env->jheap, stringOffset(self));
+}
+
+static jchar java_lang_String_charAt(RuntimeEnv *env, jobject self, jint index) {
+    std::size_t str = stringOffset(self);
+    if (index < 0 || index >= JavaString::length(env->jheap, str)) {
+        throwJavaException("java/lang/StringIndexOutOfBoundsException",
+                           ("index " + std::to_string(index)).c_str());
+        return 0;
+    }
+    return JavaString::charAt(env->jheap, str, index);
+}
+
+static jint java_lang_String_indexOf(RuntimeEnv *env, jobject self, jint ch) {
+    return JavaString::indexOf(env->jheap, stringOffset(self), ch, 0);
+}
+
+
+/****************************************************************************
+ * Intrinsic table
+ ****************************************************************************/
+class IntrinsicInfo {
+public:
+    const char *className;
+    IntrinsicId id;
+    JNINativeMethod method;
+};
+
+#define INTRINSIC(className, id, name, signature, function) \
+    {className, IntrinsicId::id, makeNativeMethod(name, signature, function)}
+
+static const IntrinsicInfo intrinsics[] = {
+        INTRINSIC("java/lang/System", SYSTEM_ARRAYCOPY, "arraycopy", "(Ljava/lang/Object;ILjava/lang/Object;II)V",
+                  java_lang_System_arraycopy),
+
+        INTRINSIC("java/lang/Math", MATH_ABS_I, "abs", "(I)I", java_lang_Math_abs_I),
+        INTRINSIC("java/lang/Math", MATH_ABS_J, "abs", "(J)J", java_lang_Math_abs_J),
+        INTRINSIC("java/lang/Math", MATH_ABS_F, "abs", "(F)F", java_lang_Math_abs_F),
+        INTRINSIC("java/lang/Math", MATH_ABS_D, "abs", "(D)D", java_lang_Math_abs_D),
+        INTRINSIC("java/lang/Math", MATH_MIN_I, "min", "(II)I", java_lang_Math_min_I),
+        INTRINSIC("java/lang/Math", MATH_MIN_J, "min", "(JJ)J", java_lang_Math_min_J),
+        INTRINSIC("java/lang/Math", MATH_MAX_I, "max", "(II)I", java_lang_Math_max_I),
+        INTRINSIC("java/lang/Math", MATH_MAX_J, "max", "(JJ)J", java_lang_Math_max_J),
+        INTRINSIC("java/lang/Math", MATH_SQRT, "sqrt", "(D)D", java_lang_Math_sqrt),
+        INTRINSIC("java/lang/Math", MATH_SIN, "sin", "(D)D", java_lang_Math_sin),
+        INTRINSIC("java/lang/Math", MATH_COS, "cos", "(D)D", java_lang_Math_cos),
+        INTRINSIC("java/lang/Math", MATH_TAN, "tan", "(D)D", java_lang_Math_tan),
+        INTRINSIC("java/lang/Math", MATH_LOG, "log", "(D)D", java_lang_Math_log),
+        INTRINSIC("java/lang/Math", MATH_LOG10, "log10", "(D)D", java_lang_Math_log10),
+        INTRINSIC("java/lang/Math", MATH_EXP, "exp", "(D)D", java_lang_Math_exp),
+        INTRINSIC("java/lang/Math", MATH_POW, "pow", "(DD)D", java_lang_Math_pow),
+
+        INTRINSIC("java/lang/Integer", INTEGER_BITCOUNT, "bitCount", "(I)I", java_lang_Integer_bitCount),
+        INTRINSIC("java/lang/Integer", INTEGER_NUMBER_OF_LEADING_ZEROS, "numberOfLeadingZeros", "(I)I",
+                  java_lang_Integer_numberOfLeadingZeros),
+        INTRINSIC("java/lang/Integer", INTEGER_NUMBER_OF_TRAILING_ZEROS, "numberOfTrailingZeros", "(I)I",
+                  java_lang_Integer_numberOfTrailingZeros),
+        INTRINSIC("java/lang/Integer", INTEGER_REVERSE_BYTES, "reverseBytes", "(I)I", java_lang_Integer_reverseBytes),
+        INTRINSIC("java/lang/Long", LONG_BITCOUNT, "bitCount", "(J)I", java_lang_Long_bitCount),
+        INTRINSIC("java/lang/Long", LONG_NUMBER_OF_LEADING_ZEROS, "numberOfLeadingZeros", "(J)I",
+                  java_lang_Long_numberOfLeadingZeros),
+        INTRINSIC("java/lang/Long", LONG_NUMBER_OF_TRAILING_ZEROS, "numberOfTrailingZeros", "(J)I",
+                  java_lang_Long_numberOfTrailingZeros),
+        INTRINSIC("java/lang/Long", LONG_REVERSE_BYTES, "reverseBytes", "(J)J", java_lang_Long_reverseBytes),
+
+        INTRINSIC("java/util/Arrays", ARRAYS_FILL_B, "fill", "([BB)V", java_util_Arrays_fill_B),
+        INTRINSIC("java/util/Arrays", ARRAYS_FILL_C, "fill", "([CC)V", java_util_Arrays_fill_C),
+        INTRINSIC("java/util/Arrays", ARRAYS_FILL_I, "fill", "([II)V", java_util_Arrays_fill_I),
+        INTRINSIC("java/util/Arrays", ARRAYS_FILL_J, "fill", "([JJ)V", java_util_Arrays_fill_J),
+        INTRINSIC("java/util/Arrays", ARRAYS_EQUALS_B, "equals", "([B[B)Z", java_util_Arrays_equals_B),
+        INTRINSIC("java/util/Arrays", ARRAYS_EQUALS_C, "equals", "([C[C)Z", java_util_Arrays_equals_C),
+        INTRINSIC("java/util/Arrays", ARRAYS_EQUALS_I, "equals", "([I[I)Z", java_util_Arrays_equals_I),
+        INTRINSIC("java/util/Arrays", ARRAYS_EQUALS_J, "equals", "([J[J)Z", java_util_Arrays_equals_J),
+        INTRINSIC("java/util/Arrays", ARRAYS_COPYOF_B, "copyOf", "([BI)[B", java_util_Arrays_copyOf_B),
+        INTRINSIC("java/util/Arrays", ARRAYS_COPYOF_C, "copyOf", "([CI)[C", java_util_Arrays_copyOf_C),
+        INTRINSIC("java/util/Arrays", ARRAYS_COPYOF_I, "copyOf", "([II)[I", java_util_Arrays_copyOf_I),
+        INTRINSIC("java/util/Arrays", ARRAYS_COPYOF_J, "copyOf", "([JI)[J", java_util_Arrays_copyOf_J),
+        INTRINSIC("java/util/Arrays", ARRAYS_HASHCODE_B, "hashCode", "([B)I", java_util_Arrays_hashCode),
+        INTRINSIC("java/util/Arrays", ARRAYS_HASHCODE_C, "hashCode", "([C)I", java_util_Arrays_hashCode),
+        INTRINSIC("java/util/Arrays", ARRAYS_HASHCODE_I, "hashCode", "([I)I", java_util_Arrays_hashCode),
+        INTRINSIC("java/util/Arrays", ARRAYS_COMPARE_B, "compare", "([B[B)I", java_util_Arrays_compare),
+        INTRINSIC("java/util/Arrays", ARRAYS_COMPARE_C, "compare", "([C[C)I", java_util_Arrays_compare),
+        INTRINSIC("java/util/Arrays", ARRAYS_COMPARE_I, "compare", "([I[I)I", java_util_Arrays_compare),
+
+        INTRINSIC("java/lang/String", STRING_EQUALS, "equals", "(Ljava/lang/Object;)Z", java_lang_String_equals),
+        INTRINSIC("java/lang/String", STRING_HASHCODE, "hashCode", "()I", java_lang_String_hashCode),
+        INTRINSIC("java/lang/String", STRING_LENGTH, "length", "()I", java_lang_String_length),
+        INTRINSIC("java/lang/String", STRING_CHARAT, "charAt", "(I)C", java_lang_String_charAt),
+        INTRINSIC("java/lang/String", STRING_INDEXOF, "indexOf", "(I)I", java_lang_String_indexOf),
+};
+
+#undef INTRINSIC
+
+bool bindIntrinsic(const JavaClass *jc, MethodInfo *method) {
+    // 只在第一次链接时构造一次，之后只读
+    static const std::unordered_map<std::string, const IntrinsicInfo*> table = [] {
+        std::unordered_map<std::string, const IntrinsicInfo*> t;
+        for (const auto &x : intrinsics) {
+            t[std::string(x.className) + "." + x.method.name + x.method.signature] = &x;
+        }
+        return t;
+    }();
+
+    std::string key(jc->getClassName());
+    key.append(".").append(jc->getString(method->nameIndex)).append(jc->getString(method->descriptorIndex));
+    auto pos = table.find(key);
+    if (pos == table.end()) {
+        return false;
+    }
+
+    method->intrinsicId = pos->second->id;
+    method->nativeEntry = pos->second->method.entry;
+    return true;
+}
@@ -0,0 +1,81 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_INTRINSIC_H
+#define CJVM_INTRINSIC_H
+
+#include "Type.h"
+
+class JavaClass;
+class MethodInfo;
+
+/**
+ * 热点 JDK 方法的内建实现
+ *
+ * 链接时按 类名.方法名描述符 识别出这些方法，不论是否为本地方法，都把它们的
+ * nativeEntry 绑定为手写的 C++ 实现，调用时不再解释执行字节码
+ */
+enum class IntrinsicId : u1 {
+    NONE = 0,
+
+    SYSTEM_ARRAYCOPY,
+
+    MATH_ABS_I,
+    MATH_ABS_J,
+    MATH_ABS_F,
+    MATH_ABS_D,
+    MATH_MIN_I,
+    MATH_MIN_J,
+    MATH_MAX_I,
+    MATH_MAX_J,
+    MATH_SQRT,
+    MATH_SIN,
+    MATH_COS,
+    MATH_TAN,
+    MATH_LOG,
+    MATH_LOG10,
+    MATH_EXP,
+    MATH_POW,
+
+    INTEGER_BITCOUNT,
+    INTEGER_NUMBER_OF_LEADING_ZEROS,
+    INTEGER_NUMBER_OF_TRAILING_ZEROS,
+    INTEGER_REVERSE_BYTES,
+    LONG_BITCOUNT,
+    LONG_NUMBER_OF_LEADING_ZEROS,
+    LONG_NUMBER_OF_TRAILING_ZEROS,
+    LONG_REVERSE_BYTES,
+
+    ARRAYS_FILL_B,
+    ARRAYS_FILL_C,
+    ARRAYS_FILL_I,
+    ARRAYS_FILL_J,
+    ARRAYS_EQUALS_B,
+    ARRAYS_EQUALS_C,
+    ARRAYS_EQUALS_I,
+    ARRAYS_EQUALS_J,
+    ARRAYS_COPYOF_B,
+    ARRAYS_COPYOF_C,
+    ARRAYS_COPYOF_I,
+    ARRAYS_COPYOF_J,
+    ARRAYS_HASHCODE_B,
+    ARRAYS_HASHCODE_C,
+    ARRAYS_HASHCODE_I,
+    ARRAYS_COMPARE_B,
+    ARRAYS_COMPARE_C,
+    ARRAYS_COMPARE_I,
+
+    STRING_EQUALS,
+    STRING_HASHCODE,
+    STRING_LENGTH,
+    STRING_CHARAT,
+    STRING_INDEXOF,
+
+    INTRINSIC_COUNT
+};
+
+// 识别并绑定内建实现，返回 true 表示该方法已被替换
+bool bindIntrinsic(const JavaClass *jc, MethodInfo *method);
+
+#endif //CJVM_INTRINSIC_H
@@ -4,10 +4,17 @@
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <cassert>
 #include "JavaClass.h"
 #include "MethodArea.h"
 #include "Debug.h"
+#include "AccessFlag.h"
+#include "JavaString.h"
+#include "StringTable.h"
+#include "JavaThread.h"
+#include "RuntimeEnv.h"
+#include "JavaHeap.h"
 
 JavaClass::JavaClass(const char *classFilePath) : reader(classFilePath) {
     raw.constPoolInfo = nullptr;
@@ -16,10 +23,42 @@ JavaClass::JavaClass(const char *classFilePath) : reader(classFilePath) {
     raw.attributes = nullptr;
 }
 
+JavaClass::JavaClass(const u1 *data, std::size_t size) : reader(data, size) {
+    raw.constPoolInfo = nullptr;
+    raw.fields = nullptr;
+    raw.methods = nullptr;
+    raw.attributes = nullptr;
+}
+
+JavaClass::JavaClass(std::vector<u1> &&bytes) : reader(std::move(bytes)) {
+    raw.constPoolInfo = nullptr;
+    raw.fields = nullptr;
+    raw.methods = nullptr;
+    raw.attributes = nullptr;
+}
+
 JavaClass::~JavaClass() {
-    for (auto &v : sfield) {
-        delete v.second;
+    delete[] staticFields;
+
+    if (cpCache) {
+        for (u2 i = 1; i < cpCache->size(); ++i) {
+            const ConstantPoolInfo *cp = raw.constPoolInfo[i];
+            if (!cp) {
+                continue;
+            }
+            if (typeid(*cp) == typeid(CONSTANT_FieldRef)) {
+                delete cpCache->getPointer<ResolvedField>(i);
+            } else if (typeid(*cp) == typeid(CONSTANT_MethodRef) ||
+                       typeid(*cp) == typeid(CONSTANT_InterfaceMethodRef)) {
+                delete cpCache->getPointer<ResolvedMethod>(i);
+            } else if (typeid(*cp) == typeid(CONSTANT_Class) &&
+                       (cpCache->get(i) & ConstantPoolCache::ARRAY_CLASS_TAG)) {
+                delete reinterpret_cast<ArrayClass*>(cpCache->get(i) & ~(std::uintptr_t)ConstantPoolCache::ARRAY_CLASS_TAG);
+            }
+        }
+        delete cpCache;
     }
+    delete[] attributeKinds;
 }
 
 std::vector<u2> JavaClass::getInterfacesIndex() const {
@@ -29,7 +68,7 @@ std::vector<u2> JavaClass::getInterfacesIndex() const {
 
     std::vector<u2> v;
     FOR_EACH(i, raw.interfacesCount) {
-        v.push_back(dynamic_cast<CONSTANT_Class*>(raw.constPoolInfo[i])->nameIndex);
+        v.push_back(dynamic_cast<CONSTANT_Class*>(raw.constPoolInfo[raw.interfaces[i]])->nameIndex);
     }
     return v;
 }
@@ -38,16 +77,255 @@ MethodInfo* JavaClass::getMethod(const char *methodName, const char *methodDescr
     FOR_EACH(i, raw.methodsCount) {
         assert(typeid(*raw.constPoolInfo[raw.methods[i].nameIndex]) == typeid(CONSTANT_Utf8));
 
-        const char *methodNameIndex = (char*)getString(raw.methods[i].nameIndex);
-        const char *methodDescriptor = (char*)getString(raw.methods[i].descriptorIndex);
-        if (strcmp(methodNameIndex, methodName) == 0 &&
-            strcmp(methodDescriptor, methodDescriptor) == 0) {
+        const char *name = getString(raw.methods[i].nameIndex);
+        const char *descriptor = getString(raw.methods[i].descriptorIndex);
+        if (strcmp(name, methodName) == 0 && strcmp(descriptor, methodDescriptor) == 0) {
             return &raw.methods[i];
         }
     }
     return nullptr;
 }
 
+FieldInfo* JavaClass::getField(const char *fieldName, const char *fieldDescriptor) const {
+    FOR_EACH(i, raw.fieldsCount) {
+        const char *name = getString(raw.fields[i].nameIndex);
+        const char *descriptor = getString(raw.fields[i].descriptorIndex);
+        if (strcmp(name, fieldName) == 0 && strcmp(descriptor, fieldDescriptor) == 0) {
+            return &raw.fields[i];
+        }
+    }
+    return nullptr;
+}
+
+bool JavaClass::lookupField(const char *fieldName, const char *fieldDescriptor, ResolvedField &result) {
+    // 本类 -> 直接实现的接口(递归) -> 父类(递归)
+    FieldInfo *field = getField(fieldName, fieldDescriptor);
+    if (field) {
+        result.jc = this;
+        result.field = field;
+        return true;
+    }
+
+    FOR_EACH(i, raw.interfacesCount) {
+        JavaClass *interface = resolveClass(raw.interfaces[i]);
+        if (interface && interface->lookupField(fieldName, fieldDescriptor, result)) {
+            return true;
+        }
+    }
+
+    JavaClass *super = hasSuperClass() ? resolveClass(raw.superClass) : nullptr;
+    return super && super->lookupField(fieldName, fieldDescriptor, result);
+}
+
+bool JavaClass::lookupMethod(const char *methodName, const char *methodDescriptor, ResolvedMethod &result) {
+    // 本类及父类 -> 父接口(递归)
+    for (JavaClass *jc = this; jc; jc = jc->hasSuperClass() ? jc->resolveClass(jc->raw.superClass) : nullptr) {
+        MethodInfo *method = jc->getMethod(methodName, methodDescriptor);
+        if (method) {
+            result.jc = jc;
+            result.method = method;
+            return true;
+        }
+    }
+
+    for (JavaClass *jc = this; jc; jc = jc->hasSuperClass() ? jc->resolveClass(jc->raw.superClass) : nullptr) {
+        FOR_EACH(i, jc->raw.interfacesCount) {
+            JavaClass *interface = jc->resolveClass(jc->raw.interfaces[i]);
+            if (interface && interface->lookupMethod(methodName, methodDescriptor, result)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+JavaClass* JavaClass::resolveClassSlow(u2 index) {
+    const char *name = getString(dynamic_cast<CONSTANT_Class*>(raw.constPoolInfo[index])->nameIndex);
+    if (name[0] == '[') {
+        currentThread->exception.throwNew("java/lang/IncompatibleClassChangeError", name);
+        return nullptr;
+    }
+
+    JavaClass *jc = crt.ma ? crt.ma->loadAndLinkClassIfAbsent(name) : nullptr;
+    if (!jc) {
+        // 链接失败时已经抛出了 VerifyError 等异常
+        if (!currentThread->exception.hasUnhandledException()) {
+            currentThread->exception.throwNew("java/lang/NoClassDefFoundError", name);
+        }
+        return nullptr;
+    }
+    return reinterpret_cast<JavaClass*>(cpCache->publish(index, reinterpret_cast<std::uintptr_t>(jc)));
+}
+
+const ArrayClass* JavaClass::resolveArrayClassSlow(u2 index) {
+    const char *name = getString(dynamic_cast<CONSTANT_Class*>(raw.constPoolInfo[index])->nameIndex);
+    if (name[0] != '[') {
+        currentThread->exception.throwNew("java/lang/IncompatibleClassChangeError", name);
+        return nullptr;
+    }
+
+    // JVM 规范 4.4.1：数组类最多 255 维
+    const char *element = name;
+    while (*element == '[') {
+        element++;
+    }
+    const std::ptrdiff_t dimensions = element - name;
+    int elementType = -1;
+    JavaClass *elementClass = nullptr;
+    if (*element == 'L') {
+        std::string elementName(element + 1);
+        if (!elementName.empty() && elementName.back() == ';') {
+            elementName.pop_back();
+            elementClass = crt.ma ? crt.ma->loadAndLinkClassIfAbsent(elementName.c_str()) : nullptr;
+            if (!elementClass) {
+                if (!currentThread->exception.hasUnhandledException()) {
+                    currentThread->exception.throwNew("java/lang/NoClassDefFoundError", elementName.c_str());
+                }
+                return nullptr;
+            }
+            elementType = T_EXTRA_OBJECT;
+        }
+    } else if (element[0] != '\0' && element[1] == '\0') {
+        switch (*element) {
+            case 'B': elementType = T_BYTE; break;
+            case 'C': elementType = T_CHAR; break;
+            case 'D': elementType = T_DOUBLE; break;
+            case 'F': elementType = T_FLOAT; break;
+            case 'I': elementType = T_INT; break;
+            case 'J': elementType = T_LONG; break;
+            case 'S': elementType = T_SHORT; break;
+            case 'Z': elementType = T_BOOLEAN; break;
+            default: break;
+        }
+    }
+    if (elementType < 0 || dimensions > 255) {
+        currentThread->exception.throwNew("java/lang/NoClassDefFoundError", name);
+        return nullptr;
+    }
+
+    auto *array = new ArrayClass{elementClass, (u1)elementType, (u1)dimensions};
+    std::uintptr_t tagged = reinterpret_cast<std::uintptr_t>(array) | ConstantPoolCache::ARRAY_CLASS_TAG;
+    std::uintptr_t published = cpCache->publish(index, tagged);
+    if (published != tagged) {
+        delete array;
+    }
+    return reinterpret_cast<const ArrayClass*>(published & ~(std::uintptr_t)ConstantPoolCache::ARRAY_CLASS_TAG);
+}
+
+ResolvedField* JavaClass::resolveFieldSlow(u2 index) {
+    auto *ref = dynamic_cast<CONSTANT_FieldRef*>(raw.constPoolInfo[index]);
+    auto *nameAndType = dynamic_cast<CONSTANT_NameAndType*>(raw.constPoolInfo[ref->nameAndTypeIndex]);
+    // 数组没有字段，length 由 arraylength 指令读取
+    const char *fieldName = getString(nameAndType->nameIndex);
+    if (isArrayClass(ref->classIndex)) {
+        if (resolveArrayClass(ref->classIndex)) {
+            currentThread->exception.throwNew("java/lang/NoSuchFieldError", fieldName);
+        }
+        return nullptr;
+    }
+    JavaClass *owner = resolveClass(ref->classIndex);
+    if (!owner) {
+        return nullptr;
+    }
+
+    auto *field = new ResolvedField;
+    if (!owner->lookupField(fieldName, getString(nameAndType->descriptorIndex), *field)) {
+        delete field;
+        currentThread->exception.throwNew("java/lang/NoSuchFieldError", fieldName);
+        return nullptr;
+    }
+
+    auto *published = reinterpret_cast<ResolvedField*>(
+            cpCache->publish(index, reinterpret_cast<std::uintptr_t>(field)));
+    if (published != field) {
+        delete field;
+    }
+    return published;
+}
+
+ResolvedMethod* JavaClass::resolveMethodSlow(u2 index) {
+    u2 classIndex, nameAndTypeIndex;
+    const ConstantPoolInfo *cp = raw.constPoolInfo[index];
+    if (typeid(*cp) == typeid(CONSTANT_InterfaceMethodRef)) {
+        classIndex = static_cast<const CONSTANT_InterfaceMethodRef*>(cp)->classIndex;
+        nameAndTypeIndex = static_cast<const CONSTANT_InterfaceMethodRef*>(cp)->nameAndTypeIndex;
+    } else {
+        classIndex = dynamic_cast<const CONSTANT_MethodRef*>(cp)->classIndex;
+        nameAndTypeIndex = dynamic_cast<const CONSTANT_MethodRef*>(cp)->nameAndTypeIndex;
+    }
+
+    auto *nameAndType = dynamic_cast<CONSTANT_NameAndType*>(raw.constPoolInfo[nameAndTypeIndex]);
+    JavaClass *owner;
+    if (isArrayClass(classIndex)) {
+        // 数组类的方法都继承自 Object(clone 由执行引擎特殊处理)
+        if (!resolveArrayClass(classIndex)) {
+            return nullptr;
+        }
+        owner = crt.ma ? crt.ma->loadAndLinkClassIfAbsent("java/lang/Object") : nullptr;
+        if (!owner) {
+            if (!currentThread->exception.hasUnhandledException()) {
+                currentThread->exception.throwNew("java/lang/NoClassDefFoundError", "java/lang/Object");
+            }
+            return nullptr;
+        }
+    } else {
+        owner = resolveClass(classIndex);
+    }
+    if (!owner) {
+        return nullptr;
+    }
+
+    const char *methodName = getString(nameAndType->nameIndex);
+    const char *methodDescriptor = getString(nameAndType->descriptorIndex);
+    auto *method = new ResolvedMethod;
+    if (!owner->lookupMethod(methodName, methodDescriptor, *method)) {
+        delete method;
+        std::string message(owner->getClassName());
+        message.append(".").append(methodName).append(methodDescriptor);
+        currentThread->exception.throwNew("java/lang/NoSuchMethodError", message.c_str());
+        return nullptr;
+    }
+
+    auto *published = reinterpret_cast<ResolvedMethod*>(
+            cpCache->publish(index, reinterpret_cast<std::uintptr_t>(method)));
+    if (published != method) {
+        delete method;
+    }
+    return published;
+}
+
+std::size_t JavaClass::resolveStringSlow(u2 index) {
+    auto *cp = static_cast<CONSTANT_String*>(raw.constPoolInfo[index]);
+    auto *utf8 = dynamic_cast<CONSTANT_Utf8*>(raw.constPoolInfo[cp->stringIndex]);
+    // ldc 可能早于任何 String 的创建，这里按需加载 String 类
+    const JavaClass *stringClass = crt.ma ? crt.ma->loadAndLinkClassIfAbsent("java/lang/String") : nullptr;
+
+    std::size_t str = crt.stringTable->intern(currentThread->tlab, utf8->bytes, utf8->length, stringClass);
+    if (str == 0) {
+        currentThread->exception.throwNew("java/lang/OutOfMemoryError", "Java heap space");
+        return 0;
+    }
+    // 并发解析时从字符串常量池拿到的是同一个对象，CAS 失败也不影响结果
+    return cpCache->publish(index, str);
+}
+
+void JavaClass::forEachStringRoot(const std::function<void(std::size_t&)> &func) {
+    if (!cpCache) {
+        return;
+    }
+    for (u2 i = 1; i < cpCache->size(); ++i) {
+        if (!raw.constPoolInfo[i] || typeid(*raw.constPoolInfo[i]) != typeid(CONSTANT_String)) {
+            continue;
+        }
+        std::size_t str = cpCache->get(i);
+        if (str == 0) {
+            continue;
+        }
+        func(str);
+        cpCache->update(i, str);
+    }
+}
+
 /**
  * 魔数、版本号、常量池、访问限制、this/super/interface、字段、方法、属性表
  *
@@ -82,8 +360,8 @@ void JavaClass::parseClassFile() {
     }
 
     // 版本号
-    raw.majorVersion = reader.readU2();
     raw.minorVersion = reader.readU2();
+    raw.majorVersion = reader.readU2();
 #ifdef CJVM_DEBUG_SHOW_VERSION
     Inspector::printClassFileVersion(*this);
 #endif
@@ -162,8 +440,8 @@ void JavaClass::parseClassFile() {
 
 
 bool JavaClass::parseConstantPool(u2 cpCount) {
-    raw.constPoolInfo = new ConstantPoolInfo*[cpCount];
-    raw.constPoolInfo[0] = nullptr;
+    raw.constPoolInfo = new ConstantPoolInfo*[cpCount]();
+    cpCache = new ConstantPoolCache(cpCount);
 
     if (!raw.constPoolInfo) {
         std::cerr << "Can not allocate memory to load class file\n";
@@ -171,7 +449,7 @@ bool JavaClass::parseConstantPool(u2 cpCount) {
     }
 
     // JVM8 规范说明：常量池中常量的索引从 1 开始，到 constant_pool_count - 1
-    for (int i = 1; i < cpCount - 1; ++i) {
+    for (int i = 1; i < cpCount; ++i) {
         // 常量池的常量都是一个 tag 和一个表数据结构组成
         u1 tag = reader.readU1();
         ConstantPoolInfo *slot;
@@ -223,7 +501,7 @@ bool JavaClass::parseConstantPool(u2 cpCount) {
             }
             case TAG_Long: {
                 slot = new CONSTANT_Long();
-                dynamic_cast<CONSTANT_Long*>(slot)->highBytes = reader.readU2();
+                dynamic_cast<CONSTANT_Long*>(slot)->highBytes = reader.readU4();
                 dynamic_cast<CONSTANT_Long*>(slot)->lowBytes = reader.readU4();
 
                 dynamic_cast<CONSTANT_Long*>(slot)->val = (((int64_t)dynamic_cast<CONSTANT_Long*>(slot)->highBytes) << 32)
@@ -259,19 +537,25 @@ bool JavaClass::parseConstantPool(u2 cpCount) {
                 dynamic_cast<CONSTANT_Utf8*>(slot)->length = len;
                 dynamic_cast<CONSTANT_Utf8*>(slot)->bytes = static_cast<u1*>(new uint8_t[len + 1]);
                 //The utf8 string is not end with '\0' since we do not need to reserve extra 1 byte
-                for (int k = 0; k < len; k++) {
-                    dynamic_cast<CONSTANT_Utf8*>(slot)->bytes[k] = reader.readU1();
-                }
+                reader.readBytes(dynamic_cast<CONSTANT_Utf8*>(slot)->bytes, len);
                 dynamic_cast<CONSTANT_Utf8*>(slot)->bytes[len] = '\0'; //End with '\0' for simplicity
 
                 raw.constPoolInfo[i] = dynamic_cast<CONSTANT_Utf8*>(slot);
-                // Todo: support unicode string ; here we just add null-char at the end of char array
+                // 字符串对象在 ldc 时才按需创建(见 JavaString)，这里只做编码校验
+                int32_t utf16Length;
+                bool latin1;
+                if (!ModifiedUtf8::validate(dynamic_cast<CONSTANT_Utf8*>(slot)->bytes, len, utf16Length, latin1)) {
+                    // ClassFormatError，和其他格式错误一样让 parseClassFile 失败
+                    std::cerr << __func__ << ":ClassFormatError: malformed modified UTF-8 in constant pool #" << i
+                              << "\n";
+                    return false;
+                }
                 break;
             }
             case TAG_MethodHandle: {
                 slot = new CONSTANT_MethodHandle();
                 dynamic_cast<CONSTANT_MethodHandle*>(slot)->referenceKind = reader.readU1();
-                dynamic_cast<CONSTANT_MethodHandle*>(slot)->referenceIndex = reader.readU1();
+                dynamic_cast<CONSTANT_MethodHandle*>(slot)->referenceIndex = reader.readU2();
                 raw.constPoolInfo[i] = dynamic_cast<CONSTANT_MethodHandle*>(slot);
                 break;
             }
@@ -293,6 +577,15 @@ bool JavaClass::parseConstantPool(u2 cpCount) {
                 return false;
         }
     }
+
+    // 每个 Utf8 常量只算一次它对应的属性类型，之后解析属性时直接查表
+    attributeKinds = new u1[cpCount]();
+    for (int i = 1; i < cpCount; ++i) {
+        auto *utf8 = dynamic_cast<CONSTANT_Utf8*>(raw.constPoolInfo[i]);
+        if (utf8) {
+            attributeKinds[i] = (u1)attributeKindOf(reinterpret_cast<const char*>(utf8->bytes), utf8->length);
+        }
+    }
     return true;
 }
 
@@ -385,8 +678,8 @@ bool JavaClass::parseMethod(u2 methodCount) {
  * @param attributeCount
  * @return
  */
-bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
-    attrs = new AttributeInfo*[attributeCount];
+bool JavaClass::parseAttribute(AttributeInfo **&attrs, u2 attributeCount) {
+    attrs = new AttributeInfo*[attributeCount]();
     if (!attrs) {
         std::cerr << __func__ << ":Can not allocate memory to load class file\n";
         return false;
@@ -394,21 +687,105 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
 
     FOR_EACH(i, attributeCount) {
         const u2 attrStrIndex = reader.readU2();
-        if (typeid(*raw.constPoolInfo[attrStrIndex]) == typeid(CONSTANT_Utf8)) {
+        if (attrStrIndex >= raw.constPoolCount || !raw.constPoolInfo[attrStrIndex] ||
+            typeid(*raw.constPoolInfo[attrStrIndex]) != typeid(CONSTANT_Utf8)) {
+            return false;
+        }
+
+        const AttributeKind kind = static_cast<AttributeKind>(attributeKinds[attrStrIndex]);
+        const std::size_t offset = reader.tell();
+#ifdef YVM_LAZY_ATTRIBUTES
+        if (isDeferredAttribute(kind)) {
+            auto *attr = new ATTR_Lazy;
+            attr->attributeNameIndex = attrStrIndex;
+            attr->attributeLength = reader.readU4();
+            attr->offset = offset;
+            reader.skip(attr->attributeLength);
+            attrs[i] = attr;
+            continue;
+        }
+#endif
+
+        attrs[i] = parseAttributeBody(attrStrIndex, kind);
+        if (!attrs[i]) {
+            // 不认识的属性按规范忽略其内容
+            auto *attr = new ATTR_Lazy;
+            attr->attributeNameIndex = attrStrIndex;
+            reader.seek(offset);
+            attr->attributeLength = reader.readU4();
+            attr->offset = offset;
+            reader.skip(attr->attributeLength);
+            attrs[i] = attr;
+        }
+    }
+    return !reader.isTruncated();
+}
+
+bool JavaClass::isDeferredAttribute(AttributeKind kind) {
+    switch (kind) {
+        case AttributeKind::StackMapTable:
+        case AttributeKind::SourceDebugExtension:
+        case AttributeKind::LineNumberTable:
+        case AttributeKind::LocalVariableTable:
+        case AttributeKind::LocalVariableTypeTable:
+        case AttributeKind::RuntimeVisibleAnnotations:
+        case AttributeKind::RuntimeInvisibleAnnotations:
+        case AttributeKind::RuntimeVisibleParameterAnnotations:
+        case AttributeKind::RuntimeInvisibleParameterAnnotations:
+        case AttributeKind::RuntimeVisibleTypeAnnotations:
+        case AttributeKind::RuntimeInvisibleTypeAnnotations:
+        case AttributeKind::AnnotationDefault:
+        case AttributeKind::MethodParameters:
+            return true;
+        default:
             return false;
+    }
+}
+
+AttributeInfo* JavaClass::decodeAttribute(ATTR_Lazy *lazy) {
+    // 类解析完成后 reader 只在这里使用，加锁后临时移动游标
+    std::lock_guard<std::mutex> lock(lazyAttrMtx);
+    AttributeInfo *attr = lazy->decoded.load(std::memory_order_relaxed);
+    if (attr) {
+        return attr;
+    }
+
+    const std::size_t pos = reader.tell();
+    reader.seek(lazy->offset);
+    attr = parseAttributeBody(lazy->attributeNameIndex,
+                              static_cast<AttributeKind>(attributeKinds[lazy->attributeNameIndex]));
+    reader.seek(pos);
+
+    lazy->decoded.store(attr, std::memory_order_release);
+    return attr;
+}
+
+const char* JavaClass::getSourceFile() {
+    auto *attr = static_cast<ATTR_SourceFile*>(findAttribute(raw.attributes, raw.attributesCount,
+                                                             AttributeKind::SourceFile));
+    return attr ? getString(attr->sourceFileIndex) : nullptr;
+}
+
+AttributeInfo* JavaClass::findAttribute(AttributeInfo **attrs, u2 attributeCount, AttributeKind kind) {
+    FOR_EACH(i, attributeCount) {
+        if (attributeKinds[attrs[i]->attributeNameIndex] == (u1)kind) {
+            return getAttribute(attrs[i]);
         }
+    }
+    return nullptr;
+}
 
-        char *attrName = (char*) dynamic_cast<CONSTANT_Utf8*>(raw.constPoolInfo[attrStrIndex])->bytes;
-        IS_ATTR_ConstantValue(attrName) {
+AttributeInfo* JavaClass::parseAttributeBody(u2 attrStrIndex, AttributeKind kind) {
+    switch (kind) {
+        case AttributeKind::ConstantValue: {
             auto *attr = new ATTR_ConstantValue;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
             attr->constantValueIndex = reader.readU2();
 
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_Code(attrName) {
+        case AttributeKind::Code: {
             auto *attr = new ATTR_Code;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -417,9 +794,7 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
             attr->codeLength = reader.readU4();
 
             attr->code = new uint8_t[attr->codeLength];
-            FOR_EACH(k, attr->codeLength) {
-                attr->code[k] = reader.readU1();
-            }
+            reader.readBytes(attr->code, attr->codeLength);
 
             attr->exceptionTableLength = reader.readU2();
             attr->exceptionTable = new ATTR_Code::_ExceptionTable[attr->exceptionTableLength];
@@ -433,10 +808,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
             attr->attributeCount = reader.readU2();
             parseAttribute(attr->attributes, attr->attributeCount);
 
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_StackMapTable(attrName) {
+        case AttributeKind::StackMapTable: {
             auto *attr = new ATTR_StackMapTable;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -444,61 +818,62 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
             attr->entries = new StackMapFrame*[attr->numberOfEntries];
             FOR_EACH(k, attr->numberOfEntries) {
                 u1 frameType = reader.readU1();
+                StackMapFrame *frame = nullptr;
                 if (IS_STACKFRAME_same_frame(frameType)) {
-                    auto *frame = new Frame_Same();
-                    attr->entries[k] = frame;
+                    frame = new Frame_Same;
+                    frame->offsetDelta = frameType;
                 } else if (IS_STACKFRAME_same_locals_1_stack_item_frame(frameType)) {
-                    auto *frame = new Frame_Same_locals_1_stack_item;
-                    frame->stack = new VerificationTypeInfo*[1];
-                    frame->stack[0] = determineVerificationType(reader.readU1());
-                    attr->entries[k] = frame;
+                    auto *f = new Frame_Same_locals_1_stack_item;
+                    f->offsetDelta = frameType - 64;
+                    f->stack = new VerificationTypeInfo*[1];
+                    f->stack[0] = determineVerificationType(reader.readU1());
+                    frame = f;
                 } else if (IS_STACKFRAME_same_locals_1_stack_item_frame_extended(frameType)) {
-                    auto *frame = new Frame_Same_locals_1_stack_item_extended;
-                    frame->offsetDelta = reader.readU2();
-                    frame->stack = new VerificationTypeInfo*[1];
-                    frame->stack[0] = determineVerificationType(reader.readU1());
-                    attr->entries[k] = frame;
+                    auto *f = new Frame_Same_locals_1_stack_item_extended;
+                    f->offsetDelta = reader.readU2();
+                    f->stack = new VerificationTypeInfo*[1];
+                    f->stack[0] = determineVerificationType(reader.readU1());
+                    frame = f;
                 } else if (IS_STACKFRAME_chop_frame(frameType)) {
-                    auto* frame = new Frame_Chop;
+                    frame = new Frame_Chop;
                     frame->offsetDelta = reader.readU2();
-                    attr->entries[k] = frame;
                 } else if (IS_STACKFRAME_same_frame_extended(frameType)) {
-                    auto* frame = new Frame_Same_frame_extended;
+                    frame = new Frame_Same_frame_extended;
                     frame->offsetDelta = reader.readU2();
-                    attr->entries[k] = frame;
                 } else if (IS_STACKFRAME_append_frame(frameType)) {
-                    auto* frame = new Frame_Append;
-                    frame->frameType = frameType;
-                    // It's important to store current frame type since ~Frame_Append need it to release memory
-                    frame->offsetDelta = reader.readU2();
-                    frame->stack = new VerificationTypeInfo*[frameType - 251];
+                    auto *f = new Frame_Append;
+                    f->offsetDelta = reader.readU2();
+                    f->locals = new VerificationTypeInfo*[frameType - 251];
                     FOR_EACH(p, frameType - 251) {
-                        frame->stack[p] = determineVerificationType(reader.readU1());
+                        f->locals[p] = determineVerificationType(reader.readU1());
                     }
-                    attr->entries[k] = frame;
+                    frame = f;
                 } else if (IS_STACKFRAME_full_frame(frameType)) {
-                    auto* frame = new Frame_Full;
-                    frame->offsetDelta = reader.readU2();
-                    frame->numberOfLocals = reader.readU2();
-                    frame->locals = new VerificationTypeInfo*[frame->numberOfLocals];
-                    FOR_EACH(p, frame->numberOfLocals) {
-                        frame->locals[p] = determineVerificationType(reader.readU1());
+                    auto *f = new Frame_Full;
+                    f->offsetDelta = reader.readU2();
+                    f->numberOfLocals = reader.readU2();
+                    f->locals = new VerificationTypeInfo*[f->numberOfLocals];
+                    FOR_EACH(p, f->numberOfLocals) {
+                        f->locals[p] = determineVerificationType(reader.readU1());
                     }
-                    frame->numberOfStackItems = reader.readU2();
-                    frame->stack = new VerificationTypeInfo*[frame->numberOfStackItems];
-                    FOR_EACH(p, frame->numberOfStackItems) {
-                        frame->stack[p] = determineVerificationType(reader.readU1());
+                    f->numberOfStackItems = reader.readU2();
+                    f->stack = new VerificationTypeInfo*[f->numberOfStackItems];
+                    FOR_EACH(p, f->numberOfStackItems) {
+                        f->stack[p] = determineVerificationType(reader.readU1());
                     }
-                    attr->entries[k] = frame;
+                    frame = f;
                 } else {
-                    // TODO
-                    // shouldn't reach here
+                    // 128-246 是保留的帧类型，记为空的 same_frame，由验证器拒绝
+                    frame = new Frame_Same;
+                    frame->offsetDelta = 0;
                 }
+                // 析构 Frame_Append 时需要 frameType 来确定局部变量的个数
+                frame->frameType = frameType;
+                attr->entries[k] = frame;
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_Exceptions(attrName) {
+        case AttributeKind::Exceptions: {
             auto *attr = new ATTR_Exception;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -507,11 +882,10 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
             FOR_EACH(k, attr->numberOfExceptions) {
                 attr->exceptionIndexTable[k] = reader.readU2();
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
 
-        IS_ATTR_InnerClasses(attrName) {
+        case AttributeKind::InnerClasses: {
             auto *attr = new ATTR_InnerClasses;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -523,42 +897,37 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                 attr->classes[k].innerNameIndex = reader.readU2();
                 attr->classes[k].innerClassAccessFlags = reader.readU2();
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_EnclosingMethod(attrName) {
+        case AttributeKind::EnclosingMethod: {
             auto *attr = new ATTR_EnclosingMethod;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
             attr->classIndex = reader.readU2();
             attr->methodIndex = reader.readU2();
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_Synthetic(attrName) {
+        case AttributeKind::Synthetic: {
             auto *attr = new ATTR_Synthetic;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_Signature(attrName) {
+        case AttributeKind::Signature: {
             auto *attr = new ATTR_Signature;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
             attr->signatureIndex = reader.readU2();
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_SourceFile(attrName) {
+        case AttributeKind::SourceFile: {
             auto* attr = new ATTR_SourceFile;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
             attr->sourceFileIndex = reader.readU2();
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_SourceDebugExtension(attrName) {
+        case AttributeKind::SourceDebugExtension: {
             auto* attr = new ATTR_SourceDebugExtension;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -566,10 +935,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
             FOR_EACH(k, attr->attributeLength) {
                 attr->debugExtension[k] = reader.readU1();
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_LineNumberTable(attrName) {
+        case AttributeKind::LineNumberTable: {
             auto* attr = new ATTR_LineNumberTable;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -579,10 +947,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                 attr->lineNumberTable[k].startPC = reader.readU2();
                 attr->lineNumberTable[k].lineNumber = reader.readU2();
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_LocalVariableTable(attrName) {
+        case AttributeKind::LocalVariableTable: {
             auto* attr = new ATTR_LocalVariableTable;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -595,10 +962,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                 attr->localVariableTable[k].descriptorIndex = reader.readU2();
                 attr->localVariableTable[k].index = reader.readU2();
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_LocalVariableTypeTable(attrName) {
+        case AttributeKind::LocalVariableTypeTable: {
             auto* attr = new ATTR_LocalVariableTypeTable;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -612,17 +978,15 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                 attr->localVariableTypeTable[k].signatureIndex = reader.readU2();
                 attr->localVariableTypeTable[k].index = reader.readU2();
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_Deprecated(attrName) {
+        case AttributeKind::Deprecated: {
             auto* attr = new ATTR_Deprecated;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_RuntimeVisibleAnnotations(attrName) {
+        case AttributeKind::RuntimeVisibleAnnotations: {
             auto* attr = new ATTR_RuntimeVisibleAnnotations;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -631,10 +995,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
             FOR_EACH(k, attr->numAnnotations) {
                 attr->annotations[k] = readToAnnotationStructure();
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_RuntimeInvisibleAnnotations(attrName) {
+        case AttributeKind::RuntimeInvisibleAnnotations: {
             auto* attr = new ATTR_RuntimeInvisibleAnnotations;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -643,10 +1006,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
             FOR_EACH(k, attr->numAnnotations) {
                 attr->annotations[k] = readToAnnotationStructure();
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_RuntimeVisibleParameterAnnotations(attrName) {
+        case AttributeKind::RuntimeVisibleParameterAnnotations: {
             auto* attr = new ATTR_RuntimeVisibleParameterAnnotations;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -661,10 +1023,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                     attr->parameterAnnotations[k].annotations[p] = readToAnnotationStructure();
                 }
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_RuntimeInvisibleParameterAnnotations(attrName) {
+        case AttributeKind::RuntimeInvisibleParameterAnnotations: {
             auto* attr = new ATTR_RuntimeInvisibleParameterAnnotations;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -679,10 +1040,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                     attr->parameterAnnotations[k].annotations[p] = readToAnnotationStructure();
                 }
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_RuntimeVisibleTypeAnnotations(attrName) {
+        case AttributeKind::RuntimeVisibleTypeAnnotations: {
             auto* attr = new ATTR_RuntimeVisibleTypeAnnotations;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -710,10 +1070,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                     attr->annotations[k].elementValuePairs[p].value = readToElementValueStructure();
                 }
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_RuntimeInvisibleTypeAnnotations(attrName) {
+        case AttributeKind::RuntimeInvisibleTypeAnnotations: {
             auto* attr = new ATTR_RuntimeInvisibleTypeAnnotations;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -741,18 +1100,16 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                     attr->annotations[k].elementValuePairs[p].value = readToElementValueStructure();
                 }
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_AnnotationDefault(attrName) {
+        case AttributeKind::AnnotationDefault: {
             auto* attr = new ATTR_AnnotationDefault;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
             attr->defaultValue = readToElementValueStructure();
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_BootstrapMethods(attrName) {
+        case AttributeKind::BootstrapMethods: {
             auto* attr = new ATTR_BootstrapMethods;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -767,10 +1124,9 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                     attr->bootstrapMethod[k].bootstrapArguments[p] = reader.readU2();
                 }
             }
-            attrs[i] = attr;
-            continue;
+            return attr;
         }
-        IS_ATTR_MethodParameters(attrName) {
+        case AttributeKind::MethodParameters: {
             auto* attr = new ATTR_MethodParameter;
             attr->attributeNameIndex = attrStrIndex;
             attr->attributeLength = reader.readU4();
@@ -780,9 +1136,232 @@ bool JavaClass::parseAttribute(AttributeInfo **attrs, u2 attributeCount) {
                 attr->parameters[k].nameIndex = reader.readU2();
                 attr->parameters[k].accessFlags = reader.readU2();
             }
-            attrs[i] = attr;
+            return attr;
+        }
+        default:
+            // 不认识的属性，由调用者跳过
+            return nullptr;
+    }
+}
+
+
+// 字段按大小分组，依次是引用、long/double、int/float、short/char、byte/boolean
+#define FIELD_GROUP_COUNT 5
+
+static int fieldGroup(const char *descriptor) {
+    switch (descriptor[0]) {
+        case 'J':
+        case 'D':
+            return 1;
+        case 'I':
+        case 'F':
+            return 2;
+        case 'S':
+        case 'C':
+            return 3;
+        case 'B':
+        case 'Z':
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * 每组内的字段按声明顺序连续排列，每个字段按自身大小对齐，对齐留下的空隙用后面更小的字段填上。
+ * 引用放在最前面，紧跟在父类的字段之后，StringObject 等按固定结构访问的对象依赖这一点
+ */
+u4 JavaClass::packFields(std::vector<FieldInfo*> *groups, u4 offset, ReferenceFieldBlock &refs) {
+    const u4 sizes[FIELD_GROUP_COUNT] = {(u4)arrayElementSize(T_EXTRA_OBJECT), 8, 4, 2, 1};
+    std::size_t next[FIELD_GROUP_COUNT] = {0};
+
+    FOR_EACH(g, FIELD_GROUP_COUNT) {
+        if (next[g] == groups[g].size()) {
+            continue;
+        }
+        const u4 align = sizes[g];
+        // 每次选能放进空隙的最大的字段
+        bool filled = true;
+        while (offset % align != 0 && filled) {
+            filled = false;
+            for (int h = g + 1; h < FIELD_GROUP_COUNT; ++h) {
+                if (sizes[h] < align && offset % sizes[h] == 0 && next[h] < groups[h].size()) {
+                    groups[h][next[h]++]->offset = offset;
+                    offset += sizes[h];
+                    filled = true;
+                    break;
+                }
+            }
+        }
+        offset = (offset + align - 1) & ~(align - 1);
+
+        if (g == 0) {
+            refs.offset = offset;
+            refs.count = (u4)groups[g].size();
+        }
+        for (; next[g] < groups[g].size(); ++next[g]) {
+            groups[g][next[g]]->offset = offset;
+            offset += align;
+        }
+    }
+    return offset;
+}
+
+void JavaClass::linkSupers(const std::vector<JavaClass*> &interfaces) {
+    u1 depth = 0;
+    if (superClass) {
+        std::copy(superClass->primarySupers, superClass->primarySupers + YVM_PRIMARY_SUPER_DEPTH, primarySupers);
+        secondarySupers = superClass->secondarySupers;
+        // 父类已经在显示表之外时子类也在显示表之外
+        depth = (u1)std::min(superClass->primaryDepth + 1, YVM_PRIMARY_SUPER_DEPTH);
+    }
+
+    auto addSecondary = [this](const JavaClass *jc) {
+        if (std::find(secondarySupers.cbegin(), secondarySupers.cend(), jc) == secondarySupers.cend()) {
+            secondarySupers.push_back(jc);
+        }
+    };
+    if (IS_CLASS_INTERFACE(raw.accessFlags) || depth == YVM_PRIMARY_SUPER_DEPTH) {
+        primaryDepth = YVM_PRIMARY_SUPER_DEPTH;
+        addSecondary(this);
+    } else {
+        primaryDepth = depth;
+        primarySupers[depth] = this;
+    }
+    for (const JavaClass *interface : interfaces) {
+        for (const JavaClass *jc : interface->secondarySupers) {
+            addSecondary(jc);
+        }
+    }
+}
+
+bool JavaClass::isSecondarySubtypeOf(const JavaClass *target) const {
+    if (secondarySuperCache.load(std::memory_order_relaxed) == target) {
+        return true;
+    }
+    for (const JavaClass *jc : secondarySupers) {
+        if (jc == target) {
+            secondarySuperCache.store(target, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JavaClass::layoutFields() {
+    std::vector<FieldInfo*> instanceGroups[FIELD_GROUP_COUNT];
+    std::vector<FieldInfo*> staticGroups[FIELD_GROUP_COUNT];
+    FOR_EACH(i, raw.fieldsCount) {
+        FieldInfo *field = &raw.fields[i];
+        const int g = fieldGroup(getString(field->descriptorIndex));
+        if (IS_FIELD_STATIC(field->accessFlags)) {
+            staticGroups[g].push_back(field);
+        } else {
+            instanceGroups[g].push_back(field);
+        }
+    }
+
+    // 父类的字段原样保留在前面，子类的字段从父类实例的末尾开始排列
+    u4 start = sizeof(ObjectHeader);
+    if (superClass) {
+        start = superClass->instanceSize;
+        referenceFields = superClass->referenceFields;
+    }
+    ReferenceFieldBlock refs;
+    instanceSize = packFields(instanceGroups, start, refs);
+    if (refs.count > 0) {
+        referenceFields.push_back(refs);
+    }
+
+    const u4 staticSize = packFields(staticGroups, 0, staticReferenceFields);
+    if (staticSize > 0) {
+        staticFields = new u1[staticSize]();
+    }
+}
+
+bool JavaClass::linkMethodSignatures() {
+    FOR_EACH(i, raw.methodsCount) {
+        if (!parseMethodSignature(getString(raw.methods[i].descriptorIndex), raw.methods[i].signature)) {
+            std::cerr << __func__ << ":Malformed method descriptor " << getString(raw.methods[i].descriptorIndex)
+                      << "\n";
+            return false;
         }
+    }
+    return true;
+}
 
+MethodInfo* JavaClass::findStaticTarget(u1 opcode, u2 index, JavaClass *&owner) {
+    if (opcode == op_invokeinterface || opcode == op_invokedynamic || !crt.ma || index == 0 ||
+        index >= raw.constPoolCount) {
+        return nullptr;
+    }
+    u2 classIndex, nameAndTypeIndex;
+    ConstantPoolInfo *cp = raw.constPoolInfo[index];
+    if (auto *ref = dynamic_cast<CONSTANT_MethodRef*>(cp)) {
+        classIndex = ref->classIndex;
+        nameAndTypeIndex = ref->nameAndTypeIndex;
+    } else if (auto *interfaceRef = dynamic_cast<CONSTANT_InterfaceMethodRef*>(cp)) {
+        classIndex = interfaceRef->classIndex;
+        nameAndTypeIndex = interfaceRef->nameAndTypeIndex;
+    } else {
+        return nullptr;
+    }
+    const char *className = getString(dynamic_cast<CONSTANT_Class*>(raw.constPoolInfo[classIndex])->nameIndex);
+    auto *nameAndType = dynamic_cast<CONSTANT_NameAndType*>(raw.constPoolInfo[nameAndTypeIndex]);
+
+    JavaClass *target = className[0] == '[' ? nullptr : crt.ma->findJavaClass(className);
+    if (!target) {
+        return nullptr;
+    }
+    if (!crt.ma->linkClassIfAbsent(className)) {
+        return nullptr;
+    }
+
+    const char *name = getString(nameAndType->nameIndex);
+    const char *descriptor = getString(nameAndType->descriptorIndex);
+    MethodInfo *m = nullptr;
+    for (JavaClass *c = target; c && !m; c = c->getSuperClass()) {
+        m = c->getMethod(name, descriptor);
+        owner = c;
+    }
+    if (!m || IS_METHOD_NATIVE(m->accessFlags) || IS_METHOD_ABSTRACT(m->accessFlags)) {
+        return nullptr;
+    }
+    // invokevirtual 只有在目标方法不能被覆盖时才是静态绑定的
+    if (opcode == op_invokevirtual && !IS_METHOD_PRIVATE(m->accessFlags) && !IS_METHOD_FINAL(m->accessFlags) &&
+        !IS_CLASS_FINAL(target->raw.accessFlags)) {
+        return nullptr;
+    }
+    return m;
+}
+
+bool JavaClass::linkExceptionHandlers() {
+    FOR_EACH(i, raw.methodsCount) {
+        MethodInfo *method = &raw.methods[i];
+        auto *code = static_cast<ATTR_Code*>(findAttribute(method->attributes, method->attributeCount,
+                                                           AttributeKind::Code));
+        if (!code) {
+            continue;
+        }
+        bool valid;
+        method->handlers = HandlerTable::build(code, valid);
+        if (!valid) {
+            std::cerr << __func__ << ":Malformed exception table in method " << getString(method->nameIndex) << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+void JavaClass::linkNativeMethods(NativeRegistry &natives) {
+    FOR_EACH(i, raw.methodsCount) {
+        if (bindIntrinsic(this, &raw.methods[i])) {
+            continue;
+        }
+        // 没有注册的本地方法由 NativeRegistry::invoke 在第一次调用时再尝试绑定，以支持链接之后才 RegisterNatives
+        if (IS_METHOD_NATIVE(raw.methods[i].accessFlags)) {
+            natives.bind(this, &raw.methods[i]);
+        }
     }
 }
 
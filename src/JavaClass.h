@@ -5,12 +5,18 @@
 #ifndef CJVM_JAVACLASS_H
 #define CJVM_JAVACLASS_H
 
-#include <map>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <typeinfo>
+#include <functional>
 #include "Type.h"
 #include "JavaType.h"
 #include "ClassFile.h"
+#include "ConstantPoolCache.h"
 #include "FileReader.h"
 #include "MethodArea.h"
+#include "Option.h"
 
 
 #define JAVA_9_MAJOR 53
@@ -20,6 +26,18 @@
 
 #define JAVA_CLASS_FILE_MAGIC_NUMBER 0XCAFEBABE
 
+/**
+ * 对象中一段连续的引用字段，GC 按它扫描对象，不需要逐个检查字段描述符
+ *
+ * offset:  第一个引用字段的偏移量
+ * count:   引用字段的个数
+ */
+class ReferenceFieldBlock {
+public:
+    u4 offset = 0;
+    u4 count = 0;
+};
+
 class JavaClass {
     friend struct Inspector;
     friend struct YVM;
@@ -27,9 +45,15 @@ class JavaClass {
     friend class MethodArea;
     friend class CodeExecution;
     friend class ConcurrentGC;
+    friend class Verifier;
+    friend class EscapeAnalysis;
+    friend class SSABuilder;
 
 public:
     explicit JavaClass(const char* classFilePath);
+    // 从内存中解析，data 在类的生命周期内必须有效
+    JavaClass(const u1 *data, std::size_t size);
+    explicit JavaClass(std::vector<u1> &&bytes);
     ~JavaClass();
     JavaClass(const JavaClass &rhs) { this->raw = rhs.raw; }
 
@@ -56,12 +80,140 @@ public:
     std::vector<u2> getInterfacesIndex() const;
     MethodInfo* getMethod(const char *methodName, const char *methodDescriptor) const;
 
+    FieldInfo* getField(const char *fieldName, const char *fieldDescriptor) const;
+
+    // SourceFile 属性记录的源文件名，没有时返回 nullptr
+    const char* getSourceFile();
+
+    // 链接之后才有效，java.lang.Object 为 nullptr
+    JavaClass* getSuperClass() const { return superClass; }
+
+    /**
+     * 是否为 target 本身或者它的子类型，用于 instanceof、checkcast 和异常匹配，两者都必须已经链接。
+     *
+     * 深度小于 YVM_PRIMARY_SUPER_DEPTH 的类直接比较父类显示表中对应深度的一项，
+     * 接口和更深的类在 secondarySupers 中查找，最近一次命中的结果缓存在 secondarySuperCache 中
+     */
+    inline bool isSubtypeOf(const JavaClass *target) const {
+        if (target->primaryDepth < YVM_PRIMARY_SUPER_DEPTH) {
+            return primarySupers[target->primaryDepth] == target;
+        }
+        return this == target || isSecondarySubtypeOf(target);
+    }
+
+    // 实例的大小(包含对象头)，链接之后才有效
+    u4 getInstanceSize() const { return instanceSize; }
+
+    // 包括从父类继承的实例引用字段
+    const std::vector<ReferenceFieldBlock>& getReferenceFields() const { return referenceFields; }
+    const ReferenceFieldBlock& getStaticReferenceFields() const { return staticReferenceFields; }
+
+    /**
+     * 字段的地址，对象基址加上链接时计算好的偏移量：
+     *  - 实例字段 heap->at<T>(obj + field->offset)
+     *  - 静态字段 staticFieldAt<T>(field)
+     */
+    template<typename T>
+    T* staticFieldAt(const FieldInfo *field) const {
+        return reinterpret_cast<T*>(staticFields + field->offset);
+    }
+
+    // 属性可能是延迟解析的，访问属性内容前都要经过这里，不认识的属性返回 nullptr
+    inline AttributeInfo* getAttribute(AttributeInfo *attr) {
+        if (typeid(*attr) != typeid(ATTR_Lazy)) {
+            return attr;
+        }
+        auto *lazy = static_cast<ATTR_Lazy*>(attr);
+        AttributeInfo *decoded = lazy->decoded.load(std::memory_order_acquire);
+        return decoded ? decoded : decodeAttribute(lazy);
+    }
+
+    // 按类型查找属性，如 findAttribute(code->attributes, code->attributeCount, AttributeKind::LineNumberTable)
+    AttributeInfo* findAttribute(AttributeInfo **attrs, u2 attributeCount, AttributeKind kind);
+
+    // 按 JVM 规范 5.4.3.2/5.4.3.3 沿继承层次查找字段和方法
+    bool lookupField(const char *fieldName, const char *fieldDescriptor, ResolvedField &result);
+    bool lookupMethod(const char *methodName, const char *methodDescriptor, ResolvedMethod &result);
+
+    /**
+     * 调用指令的目标方法能静态确定时(invokestatic、invokespecial 以及 private/final 方法)返回它，owner 为声明它的类。
+     * 只查找已经加载的类，不触发类加载，本地方法和抽象方法返回 nullptr
+     */
+    MethodInfo* findStaticTarget(u1 opcode, u2 index, JavaClass *&owner);
+
+    /**
+     * 常量池符号引用的解析，每项只在第一次使用时解析一次，之后直接读取常量池缓存。
+     * 解析失败返回 nullptr(字符串返回 0)，并在当前线程上抛出对应的 LinkageError。
+     * 数组类常量要用 resolveArrayClass 解析，元素类型是类时会先加载元素类；
+     * 对数组类常量调用 resolveClass 会抛出 IncompatibleClassChangeError
+     */
+    inline JavaClass* resolveClass(u2 index) {
+        std::uintptr_t slot = cpCache->get(index);
+        return slot != 0 && !(slot & ConstantPoolCache::ARRAY_CLASS_TAG)
+               ? reinterpret_cast<JavaClass*>(slot) : resolveClassSlow(index);
+    }
+
+    inline const ArrayClass* resolveArrayClass(u2 index) {
+        std::uintptr_t slot = cpCache->get(index);
+        return slot & ConstantPoolCache::ARRAY_CLASS_TAG
+               ? reinterpret_cast<const ArrayClass*>(slot & ~(std::uintptr_t)ConstantPoolCache::ARRAY_CLASS_TAG)
+               : resolveArrayClassSlow(index);
+    }
+
+    // CONSTANT_Class 常量是否为数组类，不需要解析
+    bool isArrayClass(u2 index) const {
+        return getString(dynamic_cast<CONSTANT_Class*>(raw.constPoolInfo[index])->nameIndex)[0] == '[';
+    }
+
+    inline ResolvedField* resolveField(u2 index) {
+        ResolvedField *field = cpCache->getPointer<ResolvedField>(index);
+        return field ? field : resolveFieldSlow(index);
+    }
+
+    // CONSTANT_MethodRef 和 CONSTANT_InterfaceMethodRef
+    inline ResolvedMethod* resolveMethod(u2 index) {
+        ResolvedMethod *method = cpCache->getPointer<ResolvedMethod>(index);
+        return method ? method : resolveMethodSlow(index);
+    }
+
+    // ldc 一个 CONSTANT_String，字符串来自全局字符串常量池
+    inline std::size_t resolveString(u2 index) {
+        std::size_t str = cpCache->get(index);
+        return str != 0 ? str : resolveStringSlow(index);
+    }
+
+    // 已经解析的 CONSTANT_String 是强引用，GC 移动对象后可以直接修改偏移量
+    void forEachStringRoot(const std::function<void(std::size_t&)> &func);
+
 private:
     bool parseConstantPool(u2 cpCount);
     bool parseInterface(u2 interfaceCount);
     bool parseField(u2 fieldCount);
     bool parseMethod(u2 methodCount);
-    bool parseAttribute(AttributeInfo** attrs, u2 attributeCount);
+    bool parseAttribute(AttributeInfo **&attrs, u2 attributeCount);
+    AttributeInfo* parseAttributeBody(u2 attrStrIndex, AttributeKind kind);
+    static bool isDeferredAttribute(AttributeKind kind);
+    AttributeInfo* decodeAttribute(ATTR_Lazy *lazy);
+
+private:
+    JavaClass* resolveClassSlow(u2 index);
+    const ArrayClass* resolveArrayClassSlow(u2 index);
+    ResolvedField* resolveFieldSlow(u2 index);
+    ResolvedMethod* resolveMethodSlow(u2 index);
+    std::size_t resolveStringSlow(u2 index);
+
+private:
+    // 父类和直接实现的接口必须已经链接
+    void linkSupers(const std::vector<JavaClass*> &interfaces);
+    bool isSecondarySubtypeOf(const JavaClass *target) const;
+
+    // 父类必须已经链接
+    void layoutFields();
+    static u4 packFields(std::vector<FieldInfo*> *groups, u4 offset, ReferenceFieldBlock &refs);
+
+    bool linkMethodSignatures();
+    bool linkExceptionHandlers();
+    void linkNativeMethods(NativeRegistry &natives);
 
 private:
     VerificationTypeInfo* determineVerificationType(u1 tag);
@@ -71,8 +223,29 @@ private:
 
 private:
     ClassFile raw{};
+    ConstantPoolCache *cpCache = nullptr;
+    // 以常量池下标索引，Utf8 常量作为属性名时对应的 AttributeKind
+    u1 *attributeKinds = nullptr;
     FileReader reader;
-    std::map<size_t, JType*> sfield;
+    std::mutex lazyAttrMtx;
+
+    JavaClass *superClass = nullptr;
+    /**
+     * primarySupers[d] 为深度 d 的祖先类(java.lang.Object 深度为 0)，包括自身。
+     * 接口和深度超过显示表的类的 primaryDepth 为 YVM_PRIMARY_SUPER_DEPTH，它们出现在子类型的 secondarySupers 中
+     */
+    const JavaClass *primarySupers[YVM_PRIMARY_SUPER_DEPTH] = {};
+    u1 primaryDepth = YVM_PRIMARY_SUPER_DEPTH;
+    std::vector<const JavaClass*> secondarySupers;
+    mutable std::atomic<const JavaClass*> secondarySuperCache{nullptr};
+
+    u4 instanceSize = 0;
+    std::vector<ReferenceFieldBlock> referenceFields;
+    // 静态字段连续存放在这里，布局和实例字段相同
+    u1 *staticFields = nullptr;
+    ReferenceFieldBlock staticReferenceFields;
+    // 已经通过字节码校验(或者来自记录了校验结果的归档)
+    bool verified = false;
 };
 
 
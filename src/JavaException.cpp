@@ -2,14 +2,117 @@
 // Created by ha on 18/6/16.
 //
 
-#include <cstdio>
+#include <iostream>
 #include <cassert>
+#include <cstring>
 #include "JavaException.h"
+#include "JavaClass.h"
+#include "AccessFlag.h"
+#include "JavaHeap.h"
+#include "JavaString.h"
+#include "RuntimeEnv.h"
+#include "MethodArea.h"
+#include "JavaThread.h"
+
+// 类名中的 / 换成 .
+static void printClassName(const char *name) {
+    for (const char *p = name; *p; p++) {
+        std::cerr << (*p == '/' ? '.' : *p);
+    }
+}
+
+// pc 对应的源码行号，没有 LineNumberTable 时返回 -1
+static int32_t lineNumberOf(JavaClass *jc, const MethodInfo *method, u4 pc) {
+    auto *code = static_cast<ATTR_Code*>(
+            jc->findAttribute(method->attributes, method->attributeCount, AttributeKind::Code));
+    if (!code) {
+        return -1;
+    }
+    auto *table = static_cast<ATTR_LineNumberTable*>(
+            jc->findAttribute(code->attributes, code->attributeCount, AttributeKind::LineNumberTable));
+    if (!table) {
+        return -1;
+    }
+    // 起始 pc 不超过 pc 的条目中起始 pc 最大的那个
+    int32_t line = -1;
+    u2 bestPC = 0;
+    FOR_EACH(i, table->lineNumberTableLength) {
+        const auto &entry = table->lineNumberTable[i];
+        if (entry.startPC <= pc && (line < 0 || entry.startPC >= bestPC)) {
+            bestPC = entry.startPC;
+            line = entry.lineNumber;
+        }
+    }
+    return line;
+}
 
-// TODO;
 void StackTrace::printStackTrace() {
-    assert(!exceptionStackTrace.empty());
     assert(throwExceptionClass != nullptr);
 
-//    printf("Thrown %s at %s()\n", throwExceptionClass->getClassName(), exceptionStackTrace[0]);
+    printClassName(throwExceptionClass->getClassName());
+    // 异常对象不会被移动，打印时才读取 detailMessage
+    auto *throwableClass = const_cast<JavaClass*>(throwExceptionClass);
+    ResolvedField detailMessage{};
+    if (throwable != 0 && throwableClass->lookupField("detailMessage", "Ljava/lang/String;", detailMessage)) {
+        std::size_t msg = decodeReference(*crt.jheap->at<HeapRef>(throwable + detailMessage.field->offset));
+        if (msg != 0) {
+            std::cerr << ": " << JavaString::toUtf8(crt.jheap, msg);
+        }
+    }
+    std::cerr << "\n";
+
+    FOR_EACH(i, depth) {
+        const StackTraceElement &e = elements[i];
+        std::cerr << "\tat ";
+        printClassName(e.jc->getClassName());
+        std::cerr << "." << e.jc->getString(e.method->nameIndex);
+        if (IS_METHOD_NATIVE(e.method->accessFlags)) {
+            std::cerr << "(Native Method)\n";
+            continue;
+        }
+        const char *sourceFile = e.jc->getSourceFile();
+        const int32_t line = lineNumberOf(e.jc, e.method, e.pc);
+        std::cerr << "(" << (sourceFile ? sourceFile : "Unknown Source");
+        if (sourceFile && line >= 0) {
+            std::cerr << ":" << line;
+        }
+        std::cerr << ")\n";
+    }
+    if (droppedFrames > 0) {
+        std::cerr << "\t... " << droppedFrames << " more\n";
+    }
+}
+
+void StackTrace::setThrowExceptionInfo(JObject *throwableObject) {
+    throwExceptionClass = throwableObject->jc;
+    throwable = throwableObject->offset;
+}
+
+// 加载并链接类，失败时返回 nullptr
+static JavaClass* loadLinkedClass(const char *name) {
+    return crt.ma ? crt.ma->loadAndLinkClassIfAbsent(name) : nullptr;
+}
+
+void JavaException::throwNew(const char *exceptionClassName, const char *message) {
+    markException();
+    JavaClass *exceptionClass = loadLinkedClass(exceptionClassName);
+    if (!exceptionClass) {
+        std::cerr << __func__ << ":Can not load exception class " << exceptionClassName << "\n";
+        return;
+    }
+    ThreadLocalAllocBuffer &tlab = currentThread->tlab;
+    JObject throwableObject;
+    throwableObject.jc = exceptionClass;
+    throwableObject.offset = crt.jheap->allocateObject(tlab, exceptionClass->getInstanceSize(), exceptionClass);
+    if (throwableObject.offset == 0) {
+        return;
+    }
+
+    ResolvedField detailMessage{};
+    if (message && exceptionClass->lookupField("detailMessage", "Ljava/lang/String;", detailMessage)) {
+        std::size_t msg = JavaString::create(crt.jheap, tlab, reinterpret_cast<const u1*>(message),
+                                             std::strlen(message), loadLinkedClass("java/lang/String"));
+        *crt.jheap->at<HeapRef>(throwableObject.offset + detailMessage.field->offset) = encodeReference(msg);
+    }
+    setThrowExceptionInfo(&throwableObject);
 }
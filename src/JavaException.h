@@ -5,26 +5,66 @@
 #ifndef CJVM_JAVAEXCEPTION_H
 #define CJVM_JAVAEXCEPTION_H
 
-#include <vector>
-#include <string>
+#include <cstddef>
+#include "Type.h"
 #include "JavaType.h"
+#include "Option.h"
 
 class JavaClass;
+class MethodInfo;
+
+/**
+ * 栈轨迹中的一帧，只记录方法和 pc，打印时才查找类名、方法名和行号
+ */
+class StackTraceElement {
+public:
+    JavaClass *jc;
+    const MethodInfo *method;
+    u4 pc;
+};
 
 class StackTrace {
 public:
+    StackTrace() = default;
+    ~StackTrace() {
+        delete[] elements;
+    }
+
+    StackTrace(const StackTrace&) = delete;
+    StackTrace& operator=(const StackTrace&) = delete;
+
     void printStackTrace();
     void setThrowExceptionInfo(JObject *throwableObject);
-    void extendExceptionStackTrace(const char *methodName) {
-        exceptionStackTrace.push_back(methodName);
+
+    // 异常每经过一帧调用一次，缓冲区在第一次抛出异常时分配，之后一直复用
+    void extendExceptionStackTrace(JavaClass *jc, const MethodInfo *method, u4 pc) {
+        if (depth < YVM_STACK_TRACE_DEPTH) {
+            if (!elements) {
+                elements = new StackTraceElement[YVM_STACK_TRACE_DEPTH];
+            }
+            elements[depth++] = StackTraceElement{jc, method, pc};
+        } else {
+            droppedFrames++;
+        }
     }
 
 protected:
-    std::vector<const char*> exceptionStackTrace;
+    void clearStackTrace() {
+        depth = 0;
+        droppedFrames = 0;
+        throwExceptionClass = nullptr;
+        throwable = 0;
+    }
 
 private:
+    StackTraceElement *elements = nullptr;
+    u4 depth = 0;
+    // 超出 YVM_STACK_TRACE_DEPTH 没有记录的帧数
+    u4 droppedFrames = 0;
+
     const JavaClass *throwExceptionClass = nullptr;
-    std::string detailedMsg;
+    // 异常对象在 Java 堆上的偏移量
+    std::size_t throwable = 0;
 };
 
 class JavaException : public StackTrace {
@@ -37,9 +77,16 @@ public:
         unhandledException = true;
     }
 
+    /**
+     * 在当前线程上抛出 exceptionClassName 类型的异常：加载并链接异常类，在堆上分配异常对象，
+     * message 非空时写入 detailMessage，然后记录并标记异常。
+     * 没有执行引擎，不执行异常类的构造函数。异常类无法加载或者堆空间不足时只标记异常
+     */
+    void throwNew(const char *exceptionClassName, const char *message = nullptr);
+
     void sweepException() {
         unhandledException = false;
-        exceptionStackTrace.clear();
+        clearStackTrace();
     }
 
 private:
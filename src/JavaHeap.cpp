@@ -0,0 +1,143 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cstdlib>
+#include <new>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "JavaHeap.h"
+#include "JavaClass.h"
+#include "JavaThread.h"
+#include "ObjectMonitor.h"
+
+#ifdef YVM_LOCK_ELISION
+#define MARK_ON_ALLOCATION ObjectHeader::MARK_UNPUBLISHED
+#else
+#define MARK_ON_ALLOCATION 0u
+#endif
+
+JavaHeap::JavaHeap(std::size_t capacity) : capacity(capacity), top(YVM_HEAP_ALIGNMENT) {
+#ifdef YVM_COMPRESSED_REFERENCES
+    if ((uint64_t)capacity > ((uint64_t)1 << (32 + YVM_REFERENCE_SHIFT))) {
+        std::cerr << __func__ << ":Heap capacity " << capacity << " is too large for compressed references\n";
+        exit(EXIT_FAILURE);
+    }
+#endif
+    // calloc 对大块内存直接使用匿名映射，页面按需提交且已清零
+    base = static_cast<u1*>(std::calloc(capacity, 1));
+    if (!base) {
+        throw std::bad_alloc();
+    }
+}
+
+JavaHeap::~JavaHeap() {
+    std::free(base);
+}
+
+std::size_t JavaHeap::allocate(std::size_t bytes) {
+    bytes = alignUp(bytes);
+    // 空间不足时不移动 top，used() 不会超过容量，之后较小的请求仍然可能成功
+    std::size_t obj = top.load(std::memory_order_relaxed);
+    do {
+        if (bytes > capacity - obj) {
+            return 0;
+        }
+    } while (!top.compare_exchange_weak(obj, obj + bytes, std::memory_order_relaxed));
+    return obj;
+}
+
+std::size_t JavaHeap::allocateObject(ThreadLocalAllocBuffer &tlab, std::size_t bytes, const JavaClass *jc) {
+    std::size_t offset = tlab.allocate(this, bytes);
+    if (offset == 0) {
+        return 0;
+    }
+
+    std::memset(base + offset, 0, bytes);
+    at<ObjectHeader>(offset)->jc = jc;
+    at<ObjectHeader>(offset)->mark = MARK_ON_ALLOCATION;
+    return offset;
+}
+
+std::size_t JavaHeap::allocateArray(ThreadLocalAllocBuffer &tlab, u1 componentType, int32_t length,
+                                    const JavaClass *componentClass) {
+    std::size_t bytes = sizeof(ArrayHeader) + arrayElementSize(componentType) * (std::size_t)length;
+    std::size_t offset = tlab.allocate(this, bytes);
+    if (offset == 0) {
+        return 0;
+    }
+
+    // TLAB 中的内存可能被 GC 回收过，这里重新清零
+    std::memset(base + offset, 0, bytes);
+    ArrayHeader *header = arrayHeader(offset);
+    header->object.mark = MARK_ON_ALLOCATION | ObjectHeader::MARK_ARRAY;
+    header->length = length;
+    header->componentType = componentType;
+    header->componentClass = componentClass;
+    return offset;
+}
+
+bool JavaHeap::allocateTLAB(std::size_t bytes, std::size_t &start, std::size_t &end) {
+    start = allocate(bytes);
+    if (start == 0) {
+        return false;
+    }
+    end = start + alignUp(bytes);
+    return true;
+}
+
+std::size_t ThreadLocalAllocBuffer::allocateSlow(JavaHeap *heap, std::size_t bytes) {
+    // 大对象直接在共享区域上分配，不浪费当前 TLAB 剩余的空间
+    if (bytes > YVM_TLAB_SIZE / 2) {
+        return heap->allocate(bytes);
+    }
+
+    std::size_t start, limit;
+    if (!heap->allocateTLAB(YVM_TLAB_SIZE, start, limit)) {
+        // 堆快满时剩下的空间不够一整个 TLAB，但可能还放得下这个对象
+        return heap->allocate(bytes);
+    }
+    top = start + bytes;
+    end = limit;
+    return start;
+}
+
+void JavaHeap::publish(std::size_t obj) {
+    std::vector<std::size_t> worklist{obj};
+    auto visit = [&](const HeapRef *refs, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t ref = decodeReference(refs[i]);
+            if (ref != 0 && !isPublished(ref)) {
+                worklist.push_back(ref);
+            }
+        }
+    };
+
+    while (!worklist.empty()) {
+        const std::size_t current = worklist.back();
+        worklist.pop_back();
+        ObjectHeader *header = at<ObjectHeader>(current);
+        if ((header->mark & ObjectHeader::MARK_UNPUBLISHED) == 0) {
+            continue;
+        }
+        const u4 lockCount = header->mark >> ObjectHeader::MARK_LOCK_SHIFT;
+        header->mark &= ObjectHeader::MARK_ARRAY;
+        if (lockCount > 0) {
+            ObjectSynchronizer::inflate(currentThread, current, lockCount);
+        }
+
+        if (header->mark & ObjectHeader::MARK_ARRAY) {
+            const ArrayHeader *array = arrayHeader(current);
+            if (array->componentType == T_EXTRA_OBJECT) {
+                visit(reinterpret_cast<const HeapRef*>(arrayElements(current)), (std::size_t)array->length);
+            }
+        } else if (header->jc) {
+            for (const auto &block : header->jc->getReferenceFields()) {
+                visit(at<HeapRef>(current + block.offset), block.count);
+            }
+        }
+    }
+    // 其它线程通过之后存入的引用看到这些对象时，一定也能看到清除后的 mark
+    std::atomic_thread_fence(std::memory_order_release);
+}
@@ -0,0 +1,212 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_JAVAHEAP_H
+#define CJVM_JAVAHEAP_H
+
+#include <atomic>
+#include <cstddef>
+#include "Type.h"
+#include "Opcode.h"
+#include "Option.h"
+
+class JavaClass;
+
+/**
+ * 堆内引用(对象的引用字段、引用数组的元素)的存储形式
+ *
+ * 开启 YVM_COMPRESSED_REFERENCES 时是 32 位的压缩引用：对象按 YVM_HEAP_ALIGNMENT 对齐，偏移量的低位恒为 0，
+ * 右移 YVM_REFERENCE_SHIFT 位后存放，堆不超过 32GB 时 4 个字节就够了。否则直接存放堆偏移量。
+ * 0 仍然表示 null，从堆上读出引用后先 decodeReference 得到偏移量再使用
+ */
+#ifdef YVM_COMPRESSED_REFERENCES
+using HeapRef = u4;
+
+static_assert((1 << YVM_REFERENCE_SHIFT) <= YVM_HEAP_ALIGNMENT, "compressed references lose low bits");
+static_assert((uint64_t)YVM_HEAP_CAPACITY <= ((uint64_t)1 << (32 + YVM_REFERENCE_SHIFT)),
+              "heap is too large for compressed references");
+
+inline HeapRef encodeReference(std::size_t offset) {
+    return (HeapRef)(offset >> YVM_REFERENCE_SHIFT);
+}
+
+inline std::size_t decodeReference(HeapRef ref) {
+    return (std::size_t)ref << YVM_REFERENCE_SHIFT;
+}
+#else
+using HeapRef = std::size_t;
+
+inline HeapRef encodeReference(std::size_t offset) {
+    return offset;
+}
+
+inline std::size_t decodeReference(HeapRef ref) {
+    return ref;
+}
+#endif
+
+/**
+ * 堆上对象的布局
+ *
+ * 普通对象:   ObjectHeader + 实例字段
+ * 数组:       ArrayHeader + 元素，元素紧跟在头部之后
+ */
+class ObjectHeader {
+public:
+    /**
+     * mark 中的状态位
+     *
+     * MARK_UNPUBLISHED:    对象还没有发布，只有分配它的线程能看到它。分配时置位，发布时清除，之后不会再置位。
+     *                      发布点：存入已发布对象的字段或数组元素(publishOnStore)、存入静态字段、字符串驻留，
+     *                      以及交给其它线程(Thread.start0 和 VirtualThreadScheduler::start 发布 Thread 对象)
+     * MARK_ARRAY:          对象是数组，头部为 ArrayHeader
+     * MARK_LOCK_SHIFT:     未发布对象上省略的 monitorenter 的重入次数存放在这一位之上
+     */
+    enum : u4 {
+        MARK_UNPUBLISHED = 1u << 0,
+        MARK_ARRAY = 1u << 1,
+        MARK_LOCK_SHIFT = 8,
+        MARK_LOCK_MAX = (1u << (32 - MARK_LOCK_SHIFT)) - 1
+    };
+
+    const JavaClass *jc;
+    // 锁和 GC 标记等状态位
+    u4 mark;
+    u4 hash;
+};
+
+class ArrayHeader {
+public:
+    ObjectHeader object;
+    int32_t length;
+    // T_INT 等基本类型，引用数组为 T_EXTRA_OBJECT
+    u1 componentType;
+    // 引用数组的元素类型，基本类型数组和元素本身是数组(数组的数组)时为 nullptr
+    const JavaClass *componentClass;
+};
+
+// 数组元素占用的字节数，引用以 HeapRef 存放
+inline std::size_t arrayElementSize(u1 componentType) {
+    switch (componentType) {
+        case T_BOOLEAN:
+        case T_BYTE:
+            return 1;
+        case T_CHAR:
+        case T_SHORT:
+            return 2;
+        case T_INT:
+        case T_FLOAT:
+            return 4;
+        case T_LONG:
+        case T_DOUBLE:
+            return 8;
+        default:
+            return sizeof(HeapRef);
+    }
+}
+
+class ThreadLocalAllocBuffer;
+
+/**
+ * Java 堆：一块连续的内存，对象用相对堆基址的偏移量(offset)表示，
+ * offset 为 0 保留给 null
+ */
+class JavaHeap {
+public:
+    explicit JavaHeap(std::size_t capacity = YVM_HEAP_CAPACITY);
+    ~JavaHeap();
+
+    JavaHeap(const JavaHeap&) = delete;
+    JavaHeap& operator=(const JavaHeap&) = delete;
+
+    // 在共享区域上分配，返回 0 表示空间不足
+    std::size_t allocate(std::size_t bytes);
+
+    // 分配并清零一个对象，bytes 包含对象头，返回 0 表示空间不足
+    std::size_t allocateObject(ThreadLocalAllocBuffer &tlab, std::size_t bytes, const JavaClass *jc);
+
+    // 分配并初始化一个数组，返回 0 表示空间不足
+    std::size_t allocateArray(ThreadLocalAllocBuffer &tlab, u1 componentType, int32_t length,
+                              const JavaClass *componentClass = nullptr);
+
+    // 为线程分配一块新的 TLAB，[start, end)
+    bool allocateTLAB(std::size_t bytes, std::size_t &start, std::size_t &end);
+
+    template<typename T>
+    inline T* at(std::size_t offset) const {
+        return reinterpret_cast<T*>(base + offset);
+    }
+
+    inline ArrayHeader* arrayHeader(std::size_t offset) const {
+        return at<ArrayHeader>(offset);
+    }
+
+    // 数组第一个元素的地址
+    inline u1* arrayElements(std::size_t offset) const {
+        return base + offset + sizeof(ArrayHeader);
+    }
+
+    inline bool isPublished(std::size_t obj) const {
+        return (at<ObjectHeader>(obj)->mark & ObjectHeader::MARK_UNPUBLISHED) == 0;
+    }
+
+    /**
+     * 引用写屏障的发布部分，在把 value 存入 container 的字段或者元素之前调用，静态字段的 container 为 0。
+     * 已发布对象只引用已发布的对象，所以只有 container 已发布而 value 还未发布时需要处理
+     */
+    inline void publishOnStore(std::size_t container, std::size_t value) {
+        if (value != 0 && !isPublished(value) && (container == 0 || isPublished(container))) {
+            publish(value);
+        }
+    }
+
+    /**
+     * 发布 obj 以及从它能到达的所有未发布对象，由当前线程(唯一能看到它们的线程)在对象被其它线程看到之前调用。
+     * 对象上省略的锁转移到真正的 ObjectMonitor 上
+     */
+    void publish(std::size_t obj);
+
+    std::size_t used() const { return top.load(std::memory_order_relaxed); }
+    std::size_t getCapacity() const { return capacity; }
+
+    static constexpr std::size_t alignUp(std::size_t bytes) {
+        return (bytes + YVM_HEAP_ALIGNMENT - 1) & ~(std::size_t)(YVM_HEAP_ALIGNMENT - 1);
+    }
+
+private:
+    u1 *base;
+    std::size_t capacity;
+    std::atomic<std::size_t> top;
+};
+
+
+/**
+ * 线程本地分配缓冲区(TLAB)
+ *
+ * 线程从堆上批量申请一段空间，之后的分配只是在本线程内移动指针，不需要任何原子操作
+ */
+class ThreadLocalAllocBuffer {
+public:
+    inline std::size_t allocate(JavaHeap *heap, std::size_t bytes) {
+        bytes = JavaHeap::alignUp(bytes);
+        if (top + bytes <= end) {
+            std::size_t obj = top;
+            top += bytes;
+            return obj;
+        }
+        return allocateSlow(heap, bytes);
+    }
+
+    // GC 之后 TLAB 中剩余的空间全部作废
+    void retire() { top = end = 0; }
+
+private:
+    std::size_t allocateSlow(JavaHeap *heap, std::size_t bytes);
+
+    std::size_t top = 0;
+    std::size_t end = 0;
+};
+
+
+#endif //CJVM_JAVAHEAP_H
@@ -0,0 +1,324 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cstring>
+#include "JavaString.h"
+#include "ArrayOps.h"
+#include "Option.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define JAVASTRING_SSE2
+#endif
+
+/****************************************************************************
+ * Modified UTF-8
+ ****************************************************************************/
+#ifdef JAVASTRING_SSE2
+// 从 bytes 开始连续的 ASCII(不含 0 字节)有多少个完整的 16 字节块
+static inline std::size_t asciiPrefix(const u1 *bytes, std::size_t length) {
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(bytes + i));
+        if (_mm_movemask_epi8(_mm_or_si128(v, _mm_cmpeq_epi8(v, zero))) != 0) {
+            break;
+        }
+    }
+    return i;
+}
+#else
+static inline std::size_t asciiPrefix(const u1 *bytes, std::size_t length) {
+    return 0;
+}
+#endif
+
+bool ModifiedUtf8::validate(const u1 *bytes, std::size_t length, int32_t &utf16Length, bool &latin1) {
+    std::size_t count = 0;
+    latin1 = true;
+
+    std::size_t i = 0;
+    while (i < length) {
+        std::size_t ascii = asciiPrefix(bytes + i, length - i);
+        i += ascii;
+        count += ascii;
+        if (i >= length) {
+            break;
+        }
+
+        u1 b = bytes[i];
+        if (b == 0) {
+            return false;
+        } else if (b < 0x80) {
+            i += 1;
+        } else if ((b & 0xE0) == 0xC0) {
+            if (i + 1 >= length || (bytes[i + 1] & 0xC0) != 0x80) {
+                return false;
+            }
+            // 110000xx 10xxxxxx 解码后不超过 0xFF
+            if (b > 0xC3) {
+                latin1 = false;
+            }
+            i += 2;
+        } else if ((b & 0xF0) == 0xE0) {
+            if (i + 2 >= length || (bytes[i + 1] & 0xC0) != 0x80 || (bytes[i + 2] & 0xC0) != 0x80) {
+                return false;
+            }
+            latin1 = false;
+            i += 3;
+        } else {
+            return false;
+        }
+        count++;
+    }
+
+    if (count > INT32_MAX / 2) {
+        return false;
+    }
+    utf16Length = (int32_t)count;
+    return true;
+}
+
+void ModifiedUtf8::decodeLatin1(const u1 *bytes, std::size_t length, u1 *dst) {
+    std::size_t i = 0;
+    while (i < length) {
+        std::size_t ascii = asciiPrefix(bytes + i, length - i);
+        std::memcpy(dst, bytes + i, ascii);
+        dst += ascii;
+        i += ascii;
+        if (i >= length) {
+            break;
+        }
+
+        u1 b = bytes[i];
+        if (b < 0x80) {
+            *dst++ = b;
+            i += 1;
+        } else {
+            *dst++ = (u1)(((b & 0x1F) << 6) | (bytes[i + 1] & 0x3F));
+            i += 2;
+        }
+    }
+}
+
+void ModifiedUtf8::decodeUtf16(const u1 *bytes, std::size_t length, uint16_t *dst) {
+    std::size_t i = 0;
+    while (i < length) {
+        std::size_t ascii = asciiPrefix(bytes + i, length - i);
+#ifdef JAVASTRING_SSE2
+        // 每 16 个 ASCII 字节与 0 交错，得到 16 个 UTF-16 字符
+        const __m128i zero = _mm_setzero_si128();
+        for (std::size_t k = 0; k < ascii; k += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(bytes + i + k));
+            _mm_storeu_si128((__m128i*)(dst + k), _mm_unpacklo_epi8(v, zero));
+            _mm_storeu_si128((__m128i*)(dst + k + 8), _mm_unpackhi_epi8(v, zero));
+        }
+#endif
+        dst += ascii;
+        i += ascii;
+        if (i >= length) {
+            break;
+        }
+
+        u1 b = bytes[i];
+        if (b < 0x80) {
+            *dst++ = b;
+            i += 1;
+        } else if ((b & 0xE0) == 0xC0) {
+            *dst++ = (uint16_t)(((b & 0x1F) << 6) | (bytes[i + 1] & 0x3F));
+            i += 2;
+        } else {
+            *dst++ = (uint16_t)(((b & 0x0F) << 12) | ((bytes[i + 1] & 0x3F) << 6) | (bytes[i + 2] & 0x3F));
+            i += 3;
+        }
+    }
+}
+
+
+/****************************************************************************
+ * java.lang.String
+ ****************************************************************************/
+static inline const StringObject* stringAt(JavaHeap *heap, std::size_t str) {
+    return heap->at<StringObject>(str);
+}
+
+std::size_t JavaString::create(JavaHeap *heap, ThreadLocalAllocBuffer &tlab, const u1 *bytes, std::size_t length,
+                               const JavaClass *stringClass) {
+    int32_t count;
+    bool latin1;
+    if (!ModifiedUtf8::validate(bytes, length, count, latin1)) {
+        return 0;
+    }
+#ifndef YVM_COMPACT_STRINGS
+    latin1 = false;
+#endif
+
+    std::size_t value = heap->allocateArray(tlab, T_BYTE, latin1 ? count : count * 2);
+    if (value == 0) {
+        return 0;
+    }
+    if (latin1) {
+        ModifiedUtf8::decodeLatin1(bytes, length, heap->arrayElements(value));
+    } else {
+        ModifiedUtf8::decodeUtf16(bytes, length, reinterpret_cast<uint16_t*>(heap->arrayElements(value)));
+    }
+
+    std::size_t str = heap->allocateObject(tlab, sizeof(StringObject), stringClass);
+    if (str == 0) {
+        return 0;
+    }
+    StringObject *s = heap->at<StringObject>(str);
+    s->value = encodeReference(value);
+    s->coder = latin1 ? LATIN1 : UTF16;
+    return str;
+}
+
+int32_t JavaString::length(JavaHeap *heap, std::size_t str) {
+    const StringObject *s = stringAt(heap, str);
+    return heap->arrayHeader(decodeReference(s->value))->length >> s->coder;
+}
+
+uint16_t JavaString::charAt(JavaHeap *heap, std::size_t str, int32_t index) {
+    const StringObject *s = stringAt(heap, str);
+    const u1 *value = heap->arrayElements(decodeReference(s->value));
+    return s->coder == LATIN1 ? value[index] : reinterpret_cast<const uint16_t*>(value)[index];
+}
+
+bool JavaString::equals(JavaHeap *heap, std::size_t a, std::size_t b) {
+    if (a == b) {
+        return true;
+    }
+    const StringObject *x = stringAt(heap, a);
+    const StringObject *y = stringAt(heap, b);
+    // 能用 Latin-1 存放的字符串一定是 LATIN1，所以编码不同的字符串内容必然不同
+    if (x->coder != y->coder) {
+        return false;
+    }
+    int32_t bytes = heap->arrayHeader(decodeReference(x->value))->length;
+    if (bytes != heap->arrayHeader(decodeReference(y->value))->length) {
+        return false;
+    }
+    return ArrayOps::equals(heap->arrayElements(decodeReference(x->value)),
+                            heap->arrayElements(decodeReference(y->value)), (std::size_t)bytes);
+}
+
+int32_t JavaString::hashCode(JavaHeap *heap, std::size_t str) {
+    StringObject *s = heap->at<StringObject>(str);
+    if (s->hash == 0) {
+        s->hash = ArrayOps::hashString(heap->arrayElements(decodeReference(s->value)), length(heap, str),
+                                       s->coder == LATIN1);
+    }
+    return s->hash;
+}
+
+int32_t JavaString::indexOf(JavaHeap *heap, std::size_t str, int32_t ch, int32_t fromIndex) {
+    const StringObject *s = stringAt(heap, str);
+    const u1 *value = heap->arrayElements(decodeReference(s->value));
+    int32_t count = length(heap, str);
+    if (fromIndex < 0) {
+        fromIndex = 0;
+    }
+    if (fromIndex >= count) {
+        return -1;
+    }
+
+    if (s->coder == LATIN1) {
+        if (ch < 0 || ch > 0xFF) {
+            return -1;
+        }
+        const void *pos = std::memchr(value + fromIndex, ch, (std::size_t)(count - fromIndex));
+        return pos ? (int32_t)(static_cast<const u1*>(pos) - value) : -1;
+    }
+
+    const uint16_t *chars = reinterpret_cast<const uint16_t*>(value);
+    if (ch >= 0x10000 && ch <= 0x10FFFF) {
+        // 补充字符以代理对的形式查找
+        uint16_t hi = (uint16_t)(0xD800 + ((ch - 0x10000) >> 10));
+        uint16_t lo = (uint16_t)(0xDC00 + ((ch - 0x10000) & 0x3FF));
+        for (int32_t i = fromIndex; i + 1 < count; ++i) {
+            if (chars[i] == hi && chars[i + 1] == lo) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    if (ch < 0 || ch > 0xFFFF) {
+        return -1;
+    }
+
+    int32_t i = fromIndex;
+#ifdef JAVASTRING_SSE2
+    const __m128i target = _mm_set1_epi16((short)ch);
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(chars + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(v, target));
+        if (mask != 0) {
+            return i + __builtin_ctz((unsigned)mask) / 2;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        if (chars[i] == ch) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::string JavaString::toUtf8(JavaHeap *heap, std::size_t str) {
+    const StringObject *s = stringAt(heap, str);
+    const u1 *value = heap->arrayElements(decodeReference(s->value));
+    int32_t count = length(heap, str);
+
+    std::string result;
+    result.reserve((std::size_t)count);
+    for (int32_t i = 0; i < count; ++i) {
+        uint32_t c = s->coder == LATIN1 ? value[i] : reinterpret_cast<const uint16_t*>(value)[i];
+        if (c >= 0xD800 && c <= 0xDBFF && i + 1 < count && s->coder == UTF16) {
+            uint32_t lo = reinterpret_cast<const uint16_t*>(value)[i + 1];
+            if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                c = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+                ++i;
+            }
+        }
+
+        if (c < 0x80) {
+            result.push_back((char)c);
+        } else if (c < 0x800) {
+            result.push_back((char)(0xC0 | (c >> 6)));
+            result.push_back((char)(0x80 | (c & 0x3F)));
+        } else if (c < 0x10000) {
+            result.push_back((char)(0xE0 | (c >> 12)));
+            result.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            result.push_back((char)(0x80 | (c & 0x3F)));
+        } else {
+            result.push_back((char)(0xF0 | (c >> 18)));
+            result.push_back((char)(0x80 | ((c >> 12) & 0x3F)));
+            result.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            result.push_back((char)(0x80 | (c & 0x3F)));
+        }
+    }
+    return result;
+}
+
+std::string JavaString::toModifiedUtf8(JavaHeap *heap, std::size_t str) {
+    int32_t count = length(heap, str);
+
+    std::string result;
+    result.reserve((std::size_t)count);
+    for (int32_t i = 0; i < count; ++i) {
+        uint16_t c = charAt(heap, str, i);
+        if (c != 0 && c < 0x80) {
+            result.push_back((char)c);
+        } else if (c < 0x800) {
+            result.push_back((char)(0xC0 | (c >> 6)));
+            result.push_back((char)(0x80 | (c & 0x3F)));
+        } else {
+            result.push_back((char)(0xE0 | (c >> 12)));
+            result.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            result.push_back((char)(0x80 | (c & 0x3F)));
+        }
+    }
+    return result;
+}
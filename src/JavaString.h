@@ -0,0 +1,69 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_JAVASTRING_H
+#define CJVM_JAVASTRING_H
+
+#include <cstddef>
+#include <string>
+#include "Type.h"
+#include "JavaHeap.h"
+
+class JavaClass;
+
+/**
+ * 堆上 java.lang.String 的布局，与 JDK 9 之后的实现一致：
+ * value 是 byte[]，coder 为 LATIN1 时每个字符一个字节，为 UTF16 时每个字符两个字节
+ */
+class StringObject {
+public:
+    ObjectHeader object;
+    // byte[] 的引用，decodeReference 后得到堆上的偏移量
+    HeapRef value;
+    // 为 0 表示还未计算
+    int32_t hash;
+    u1 coder;
+};
+
+/**
+ * class 文件中的 modified UTF-8：
+ *  - '\0' 编码为两个字节 C0 80，不会出现 0 字节
+ *  - 补充字符拆成两个代理项，各自编码为三个字节，不会出现四字节的形式
+ */
+class ModifiedUtf8 {
+public:
+    // 校验并统计解码后的 UTF-16 长度，latin1 表示所有字符都不超过 0xFF
+    static bool validate(const u1 *bytes, std::size_t length, int32_t &utf16Length, bool &latin1);
+
+    // 两者都要求 bytes 已经通过校验
+    static void decodeLatin1(const u1 *bytes, std::size_t length, u1 *dst);
+    static void decodeUtf16(const u1 *bytes, std::size_t length, uint16_t *dst);
+};
+
+class JavaString {
+public:
+    static const u1 LATIN1 = 0;
+    static const u1 UTF16 = 1;
+
+    // 从 modified UTF-8 新建 String，返回 0 表示编码非法或空间不足。
+    // stringClass 在 java/lang/String 加载之前可以为 nullptr
+    static std::size_t create(JavaHeap *heap, ThreadLocalAllocBuffer &tlab, const u1 *bytes, std::size_t length,
+                              const JavaClass *stringClass);
+
+    static int32_t length(JavaHeap *heap, std::size_t str);
+    // 调用者保证 index 不越界
+    static uint16_t charAt(JavaHeap *heap, std::size_t str, int32_t index);
+    static bool equals(JavaHeap *heap, std::size_t a, std::size_t b);
+    static int32_t hashCode(JavaHeap *heap, std::size_t str);
+    // 从 fromIndex 开始查找字符 ch，找不到返回 -1
+    static int32_t indexOf(JavaHeap *heap, std::size_t str, int32_t ch, int32_t fromIndex);
+
+    // 转成 UTF-8，用于输出和调试
+    static std::string toUtf8(JavaHeap *heap, std::size_t str);
+    // 转成 class 文件中的 modified UTF-8，与常量池中的字面量逐字节可比
+    static std::string toModifiedUtf8(JavaHeap *heap, std::size_t str);
+};
+
+
+#endif //CJVM_JAVASTRING_H
@@ -0,0 +1,272 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <algorithm>
+#include <chrono>
+#include "JavaThread.h"
+#include "RuntimeEnv.h"
+#include "VirtualThread.h"
+#include "JavaHeap.h"
+
+thread_local JavaThread *currentThread = nullptr;
+
+std::atomic_bool JavaThread::safepointRequested(false);
+
+namespace {
+    // 所有存活的 Java 线程，GC 通过它枚举线程栈上的根
+    std::mutex threadsMtx;
+    std::vector<std::shared_ptr<JavaThread>> threads;
+
+    std::mutex safepointMtx;
+    std::condition_variable safepointCond;
+
+    void addThread(const std::shared_ptr<JavaThread> &t) {
+        std::lock_guard<std::mutex> lock(threadsMtx);
+        threads.push_back(t);
+    }
+
+    void removeThread(const JavaThread *t) {
+        std::lock_guard<std::mutex> lock(threadsMtx);
+        threads.erase(std::remove_if(threads.begin(), threads.end(),
+                                     [=](const std::shared_ptr<JavaThread> &p) { return p.get() == t; }),
+                      threads.end());
+    }
+}
+
+JavaThread::JavaThread(JObject *threadObject)
+        : threadObject(threadObject), state(ThreadState::NEW),
+          safepointState(SafepointState::RUNNING), interrupted(false) {}
+
+JavaThread::~JavaThread() {
+    if (nativeThread.joinable()) {
+        nativeThread.detach();
+    }
+    delete threadObject;
+}
+
+std::shared_ptr<JavaThread> JavaThread::create(JObject *threadObject) {
+    return std::make_shared<JavaThread>(threadObject);
+}
+
+JavaThread* JavaThread::attachCurrentThread(JObject *threadObject) {
+    auto t = create(threadObject);
+    t->state = ThreadState::RUNNABLE;
+    addThread(t);
+    currentThread = t.get();
+    return currentThread;
+}
+
+void JavaThread::detachCurrentThread() {
+    if (currentThread) {
+        JavaThread *t = currentThread;
+        currentThread = nullptr;
+        t->terminate();
+    }
+}
+
+std::shared_ptr<JavaThread> JavaThread::findByThreadObject(const JObject *threadObject) {
+    std::lock_guard<std::mutex> lock(threadsMtx);
+    for (auto &t : threads) {
+        if (t->threadObject && t->threadObject->offset == threadObject->offset) {
+            return t;
+        }
+    }
+    return nullptr;
+}
+
+void JavaThread::forEach(const std::function<void(JavaThread*)> &func) {
+    std::lock_guard<std::mutex> lock(threadsMtx);
+    for (auto &t : threads) {
+        func(t.get());
+    }
+}
+
+void JavaThread::start(std::function<void()> body) {
+    // start() 返回之后 isAlive() 必须为 true
+    state = ThreadState::RUNNABLE;
+    auto self = shared_from_this();
+    addThread(self);
+
+    nativeThread = std::thread([self, body] {
+        currentThread = self.get();
+        body();
+        currentThread = nullptr;
+        self->terminate();
+    });
+    nativeThread.detach();
+}
+
+void JavaThread::terminate() {
+    {
+        std::lock_guard<std::mutex> lock(parkMtx);
+        state = ThreadState::TERMINATED;
+    }
+    parkCond.notify_all();
+    // 可能是最后一个引用，之后不能再访问 this
+    removeThread(this);
+}
+
+void JavaThread::join() {
+    auto *self = currentThread;
+    if (self) {
+        self->safepointState = SafepointState::SAFE;
+    }
+    {
+        std::unique_lock<std::mutex> lock(parkMtx);
+        parkCond.wait(lock, [this] { return state == ThreadState::TERMINATED; });
+    }
+    if (self) {
+        self->safepointState = SafepointState::RUNNING;
+        self->pollSafepoint();
+    }
+}
+
+bool JavaThread::sleep(int64_t millis) {
+    safepointState = SafepointState::SAFE;
+    state = ThreadState::TIMED_WAITING;
+    bool wasInterrupted;
+    {
+        std::unique_lock<std::mutex> lock(parkMtx);
+        wasInterrupted = parkCond.wait_for(lock, std::chrono::milliseconds(millis),
+                                           [this] { return interrupted.load(); });
+    }
+    state = ThreadState::RUNNABLE;
+    safepointState = SafepointState::RUNNING;
+    pollSafepoint();
+
+    if (wasInterrupted) {
+        interrupted = false;
+        return false;
+    }
+    return true;
+}
+
+void JavaThread::interrupt() {
+    {
+        std::lock_guard<std::mutex> lock(parkMtx);
+        interrupted = true;
+    }
+    parkCond.notify_all();
+}
+
+bool JavaThread::isInterrupted(bool clearInterrupted) {
+    if (clearInterrupted) {
+        return interrupted.exchange(false);
+    }
+    return interrupted.load();
+}
+
+void JavaThread::requestSafepoint() {
+    safepointRequested = true;
+    bool allStopped = false;
+    while (!allStopped) {
+        allStopped = true;
+        forEach([&](JavaThread *t) {
+            if (t != currentThread && t->safepointState == SafepointState::RUNNING) {
+                allStopped = false;
+            }
+        });
+        if (!allStopped) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JavaThread::releaseSafepoint() {
+    {
+        std::lock_guard<std::mutex> lock(safepointMtx);
+        safepointRequested = false;
+    }
+    safepointCond.notify_all();
+}
+
+void JavaThread::blockAtSafepoint() {
+    JavaThread *os = carrier ? carrier : this;
+    std::unique_lock<std::mutex> lock(safepointMtx);
+    os->safepointState = SafepointState::SUSPENDED;
+    tlab.retire();
+    safepointCond.wait(lock, [] { return !safepointRequested.load(); });
+    os->safepointState = SafepointState::RUNNING;
+}
+
+
+/****************************************************************************
+ * java.lang.Thread native methods
+ ****************************************************************************/
+static std::shared_ptr<JavaThread> findThread(RuntimeEnv *env, jobject threadObject) {
+    auto *obj = dynamic_cast<JObject*>(threadObject);
+    if (env->vts) {
+        auto t = env->vts->find(obj);
+        if (t) {
+            return t;
+        }
+    }
+    return JavaThread::findByThreadObject(obj);
+}
+
+static void java_lang_Thread_start0(RuntimeEnv *env, jobject self) {
+    auto *threadObject = new JObject(*dynamic_cast<JObject*>(self));
+    // Thread 对象(连同 Runnable 等从它能到达的对象)交给新线程之前必须发布
+    if (threadObject->offset != 0) {
+        env->jheap->publish(threadObject->offset);
+    }
+    if (env->vts) {
+        env->vts->start(threadObject);
+        return;
+    }
+
+    auto t = JavaThread::create(threadObject);
+    JavaThread *thread = t.get();
+    t->start([env, thread] {
+        if (env->runJavaThread) {
+            env->runJavaThread(thread);
+        }
+    });
+}
+
+static jboolean java_lang_Thread_isAlive(RuntimeEnv *env, jobject self) {
+    auto t = findThread(env, self);
+    return (jboolean)(t && t->isAlive());
+}
+
+static void java_lang_Thread_sleep(RuntimeEnv *env, jlong millis) {
+    if (millis < 0) {
+        currentThread->exception.throwNew("java/lang/IllegalArgumentException", "timeout value is negative");
+    } else if (!currentThread->sleep(millis)) {
+        currentThread->exception.throwNew("java/lang/InterruptedException", "sleep interrupted");
+    }
+}
+
+static void java_lang_Thread_yield(RuntimeEnv *env) {
+    std::this_thread::yield();
+}
+
+static jobject java_lang_Thread_currentThread(RuntimeEnv *env) {
+    return currentThread->threadObject;
+}
+
+static void java_lang_Thread_interrupt0(RuntimeEnv *env, jobject self) {
+    auto t = findThread(env, self);
+    if (t) {
+        t->interrupt();
+    }
+}
+
+static jboolean java_lang_Thread_isInterrupted(RuntimeEnv *env, jobject self, jboolean clearInterrupted) {
+    auto t = findThread(env, self);
+    return (jboolean)(t && t->isInterrupted(clearInterrupted != 0));
+}
+
+void registerThreadNatives(RuntimeEnv *env) {
+    static const JNINativeMethod methods[] = {
+            makeNativeMethod("start0", "()V", java_lang_Thread_start0),
+            makeNativeMethod("isAlive", "()Z", java_lang_Thread_isAlive),
+            makeNativeMethod("sleep", "(J)V", java_lang_Thread_sleep),
+            makeNativeMethod("yield", "()V", java_lang_Thread_yield),
+            makeNativeMethod("currentThread", "()Ljava/lang/Thread;", java_lang_Thread_currentThread),
+            makeNativeMethod("interrupt0", "()V", java_lang_Thread_interrupt0),
+            makeNativeMethod("isInterrupted", "(Z)Z", java_lang_Thread_isInterrupted),
+    };
+    env->natives.registerNatives("java/lang/Thread", methods, sizeof(methods) / sizeof(methods[0]));
+}
@@ -0,0 +1,124 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_JAVATHREAD_H
+#define CJVM_JAVATHREAD_H
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <memory>
+#include "Frame.h"
+#include "JavaType.h"
+#include "JavaHeap.h"
+#include "JavaException.h"
+
+class RuntimeEnv;
+
+enum class ThreadState {
+    NEW,
+    RUNNABLE,
+    BLOCKED,
+    WAITING,
+    TIMED_WAITING,
+    TERMINATED
+};
+
+enum class SafepointState {
+    // 正在执行 Java 代码，GC 需要等它主动到达安全点
+    RUNNING,
+    // 阻塞或者执行本地方法中，不会访问 Java 堆，GC 无需等待
+    SAFE,
+    // 已在安全点上挂起
+    SUSPENDED
+};
+
+/**
+ * 每个 Java 线程的全部虚拟机状态：栈帧、TLAB、异常状态和安全点状态
+ *
+ * 通过 thread_local 的 currentThread 指针访问，一次 TLS 读取即可拿到全部线程状态
+ */
+class JavaThread : public std::enable_shared_from_this<JavaThread> {
+public:
+    explicit JavaThread(JObject *threadObject);
+    virtual ~JavaThread();
+
+    JavaThread(const JavaThread&) = delete;
+    JavaThread& operator=(const JavaThread&) = delete;
+
+    // 把当前原生线程(如 main 线程)注册为 Java 线程
+    static JavaThread* attachCurrentThread(JObject *threadObject);
+    static void detachCurrentThread();
+
+    static std::shared_ptr<JavaThread> findByThreadObject(const JObject *threadObject);
+    static void forEach(const std::function<void(JavaThread*)> &func);
+
+    static std::shared_ptr<JavaThread> create(JObject *threadObject);
+
+    void start(std::function<void()> body);
+    void join();
+    // 返回 false 表示睡眠被中断
+    virtual bool sleep(int64_t millis);
+    virtual void interrupt();
+    bool isInterrupted(bool clearInterrupted);
+
+    virtual bool isVirtual() const { return false; }
+
+    bool isAlive() const {
+        ThreadState s = state.load(std::memory_order_acquire);
+        return s != ThreadState::NEW && s != ThreadState::TERMINATED;
+    }
+
+    inline void pollSafepoint() {
+        if (safepointRequested.load(std::memory_order_acquire)) {
+            blockAtSafepoint();
+        }
+    }
+
+    // GC 线程调用，请求/释放所有 Java 线程的安全点
+    static void requestSafepoint();
+    static void releaseSafepoint();
+
+public:
+    StackFrames frames;
+    ThreadLocalAllocBuffer tlab;
+    JavaException exception;
+
+    // 本地方法新建对象时用来返回的句柄，调用者复制后即可复用，类似 JNI 的局部引用
+    JObject localObject;
+    JArray localArray;
+
+    JObject *threadObject;
+    std::atomic<ThreadState> state;
+    std::atomic<SafepointState> safepointState;
+
+    // 虚拟线程挂载时指向承载它的平台线程，安全点状态记在承载线程上
+    JavaThread *carrier = nullptr;
+
+protected:
+    void terminate();
+
+    std::atomic_bool interrupted;
+
+private:
+    void blockAtSafepoint();
+
+    static std::atomic_bool safepointRequested;
+
+    std::thread nativeThread;
+
+protected:
+    // sleep/join 在这里等待，interrupt 和线程结束时唤醒
+    std::mutex parkMtx;
+    std::condition_variable parkCond;
+};
+
+extern thread_local JavaThread *currentThread;
+
+void registerThreadNatives(RuntimeEnv *env);
+
+#endif //CJVM_JAVATHREAD_H
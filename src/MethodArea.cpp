@@ -2,23 +2,33 @@
 // Created by ha on 18/6/16.
 //
 
+#include <iostream>
 #include "MethodArea.h"
 #include "JavaClass.h"
 #include "Option.h"
 #include "AccessFlag.h"
 #include "Descriptor.h"
+#include "RuntimeEnv.h"
+#include "ClassArchive.h"
+#include "ClassPath.h"
+#include "Verifier.h"
+#include "JavaThread.h"
 
 
 MethodArea::MethodArea(const std::vector<std::string> &libPaths) {
     for (const auto &path : libPaths) {
         searchPaths.push_back(path);
     }
+    classPath = new ClassPath(searchPaths);
 }
 
 MethodArea::~MethodArea() {
     for (auto &x : classTable) {
         delete x.second;
     }
+    // 从归档和 jar 中加载的类引用着映射的内存，最后解除映射
+    delete archive;
+    delete classPath;
 }
 
 JavaClass* MethodArea::findJavaClass(const char *javaClassName) {
@@ -36,14 +46,143 @@ JavaClass* MethodArea::findJavaClass(const char *javaClassName) {
 bool MethodArea::loadJavaClass(const char *javaClassName) {
     std::lock_guard<std::recursive_mutex> lockMA(maMutex);
 
-    auto path = parseName2Path(javaClassName);
-    if (path.length() != 0 && !findJavaClass(javaClassName)) {
-        JavaClass *jc = new JavaClass(path.c_str());
-        // TODO
+    if (findJavaClass(javaClassName)) {
+        return true;
     }
+
+    JavaClass *jc = nullptr;
+    const u1 *bytes;
+    std::size_t length;
+    u4 flags;
+    if (archive && archive->find(javaClassName, bytes, length, flags)) {
+        // 直接从映射的归档中解析，不访问类路径
+        jc = new JavaClass(bytes, length);
+        jc->verified = (flags & ClassArchive::CLASS_VERIFIED) != 0;
+    } else {
+        ClassBytes cb;
+        if (!classPath->readClass(javaClassName, cb)) {
+            return false;
+        }
+        if (cb.buffer.empty()) {
+            // 未压缩的 jar 条目，直接解析映射的内存
+            jc = new JavaClass(cb.data, cb.length);
+        } else {
+            jc = new JavaClass(std::move(cb.buffer));
+        }
+    }
+
+    jc->parseClassFile();
+    classTable.insert(std::make_pair(std::string(javaClassName), jc));
+    return true;
+}
+
+void MethodArea::forEachStringRoot(const std::function<void(std::size_t&)> &func) {
+    std::lock_guard<std::recursive_mutex> lockMA(maMutex);
+    for (auto &x : classTable) {
+        x.second->forEachStringRoot(func);
+    }
+}
+
+bool MethodArea::mapClassArchive(const std::string &archivePath) {
+    std::lock_guard<std::recursive_mutex> lockMA(maMutex);
+
+    auto *a = new ClassArchive;
+    if (!a->map(archivePath, getClassPath())) {
+        delete a;
+        return false;
+    }
+    delete archive;
+    archive = a;
+    return true;
+}
+
+bool MethodArea::dumpClassArchive(const std::string &archivePath) {
+    std::lock_guard<std::recursive_mutex> lockMA(maMutex);
+
+    ClassArchive::Writer writer;
+    std::string source;
+    for (const auto &x : classTable) {
+        // 不在类路径中的类无法确认之后是否过期，不转储
+        if (!classPath->locateClass(x.first.c_str(), source)) {
+            continue;
+        }
+        const FileReader &reader = x.second->reader;
+        const u4 flags = x.second->verified ? (u4)ClassArchive::CLASS_VERIFIED : 0u;
+        writer.add(x.first, reader.data(), reader.length(), flags, source);
+    }
+    return writer.write(archivePath, getClassPath(), *classPath);
+}
+
+std::string MethodArea::getClassPath() const {
+    std::string classPath;
+    for (const auto &path : searchPaths) {
+        if (!classPath.empty()) {
+            classPath.push_back(':');
+        }
+        classPath.append(path);
+    }
+    return classPath;
+}
+
+/**
+ * 把类记为链接失败并抛出异常。先记录再抛出：异常类本身链接失败时，throwNew 加载它不会再次进入链接。
+ * 父类或接口链接失败时它们的异常已经抛出，不再覆盖
+ */
+bool MethodArea::failLink(JavaClass *jc, const char *exceptionClassName, const char *message) {
+    erroneousClasses.insert(jc->getClassName());
+    if (currentThread && !currentThread->exception.hasUnhandledException()) {
+        currentThread->exception.throwNew(exceptionClassName, message);
+    }
+    return false;
 }
 
+bool MethodArea::linkJavaClass(const char *javaClassName) {
+    std::lock_guard<std::recursive_mutex> lockMA(maMutex);
+
+    JavaClass *jc = findJavaClass(javaClassName);
+    if (!jc) {
+        return false;
+    }
 
+#ifdef YVM_VERIFY_BYTECODE
+    if (!jc->verified) {
+        if (!Verifier(jc).verify()) {
+            std::cerr << __func__ << ":Failed to verify class " << javaClassName << "\n";
+            return failLink(jc, "java/lang/VerifyError", javaClassName);
+        }
+        jc->verified = true;
+    }
+#endif
 
+    // 父类和接口先链接，子类的字段布局接在父类之后，子类型检查的显示表也在父类的基础上生成
+    if (jc->hasSuperClass()) {
+        const char *superName = jc->getSuperClassName();
+        jc->superClass = loadClassIfAbsent(superName);
+        if (!jc->superClass || !linkClassIfAbsent(superName)) {
+            std::cerr << __func__ << ":Failed to load super class " << superName << "\n";
+            return failLink(jc, "java/lang/NoClassDefFoundError", superName);
+        }
+    }
+    std::vector<JavaClass*> interfaces;
+    FOR_EACH(i, jc->raw.interfacesCount) {
+        const char *interfaceName = jc->getString(
+                dynamic_cast<CONSTANT_Class*>(jc->raw.constPoolInfo[jc->raw.interfaces[i]])->nameIndex);
+        JavaClass *interface = loadClassIfAbsent(interfaceName);
+        if (!interface || !linkClassIfAbsent(interfaceName)) {
+            std::cerr << __func__ << ":Failed to load interface " << interfaceName << "\n";
+            return failLink(jc, "java/lang/NoClassDefFoundError", interfaceName);
+        }
+        interfaces.push_back(interface);
+    }
+    jc->linkSupers(interfaces);
+    jc->layoutFields();
 
+    if (!jc->linkMethodSignatures() || !jc->linkExceptionHandlers()) {
+        std::cerr << __func__ << ":Failed to link class " << javaClassName << "\n";
+        return failLink(jc, "java/lang/ClassFormatError", javaClassName);
+    }
+    jc->linkNativeMethods(crt.natives);
 
+    linkedClasses.insert(jc->getClassName());
+    return true;
+}
@@ -13,11 +13,14 @@
 #include <algorithm>
 #include <cstring>
 #include <mutex>
+#include <functional>
 #include "ClassFile.h"
 
 class CodeExecution;
 class JavaClass;
 class ConcurrentGC;
+class ClassArchive;
+class ClassPath;
 
 class MethodArea {
     friend class ConcurrentGC;
@@ -28,9 +31,15 @@ public:
     JavaClass* findJavaClass(const char *javaClassName);
     bool loadJavaClass(const char *javaClassName);
     bool removeJavaClass(const char *javaClassName);
-    void linkJavaClass(const char *javaClassName);
+    // 链接失败时在当前线程上抛出 VerifyError 等 LinkageError 并返回 false，之后这个类不会再链接
+    bool linkJavaClass(const char *javaClassName);
     void initJavaClass(CodeExecution &execution, const char *javaClassName);
 
+    // class 文件缓存：映射之前转储的归档，之后加载的类优先从归档中读取 class 文件，省去类路径的 I/O
+    bool mapClassArchive(const std::string &archivePath);
+    // 把目前已加载的所有类的 class 文件转储到归档中
+    bool dumpClassArchive(const std::string &archivePath);
+
 public:
     JavaClass* loadClassIfAbsent(const char *javaClassName) {
         std::lock_guard<std::recursive_mutex> lockMA(maMutex);
@@ -42,29 +51,46 @@ public:
         return findJavaClass(javaClassName);
     }
 
-    void linkClassIfAbsent(const char *javaClassName) {
+    // 已经链接或者这次链接成功时返回 true，以前链接失败过的类直接返回 false，不再抛出异常
+    bool linkClassIfAbsent(const char *javaClassName) {
         std::lock_guard<std::recursive_mutex> lockMA(maMutex);
-        bool linked = false;
+        for (auto *p : erroneousClasses) {
+            if (strcmp(p, javaClassName) == 0) {
+                return false;
+            }
+        }
         for (auto *p : linkedClasses) {
             if (strcmp(p, javaClassName) == 0) {
-                linked = true;
+                return true;
             }
         }
+        return linkJavaClass(javaClassName);
+    }
 
-        if (!linked) {
-            linkJavaClass(javaClassName);
-        }
+    // 按需加载并链接，找不到类或者链接失败时返回 nullptr
+    JavaClass* loadAndLinkClassIfAbsent(const char *javaClassName) {
+        std::lock_guard<std::recursive_mutex> lockMA(maMutex);
+        JavaClass *jc = loadClassIfAbsent(javaClassName);
+        return jc && linkClassIfAbsent(javaClassName) ? jc : nullptr;
     }
 
+    // 所有类的常量池缓存中已经解析的字符串字面量，供 GC 作为强根扫描
+    void forEachStringRoot(const std::function<void(std::size_t&)> &func);
+
 
 private:
     std::recursive_mutex maMutex;
     std::unordered_set<const char*> linkedClasses;
+    // 链接失败的类
+    std::unordered_set<const char*> erroneousClasses;
     std::unordered_set<const char*> initedClasses;
     std::unordered_map<std::string, JavaClass*> classTable;
     std::vector<std::string> searchPaths;
+    ClassArchive *archive = nullptr;
+    ClassPath *classPath = nullptr;
 
-    std::string parseName2Path(const char *name);
+    std::string getClassPath() const;
+    bool failLink(JavaClass *jc, const char *exceptionClassName, const char *message);
 };
 
 
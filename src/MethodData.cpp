@@ -0,0 +1,156 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <algorithm>
+#include "MethodData.h"
+#include "JavaClass.h"
+#include "Bytecode.h"
+
+const JavaClass* TypeProfile::monomorphicClass() const {
+    if (nullSeen.load(std::memory_order_relaxed) || polymorphic.load(std::memory_order_relaxed) != 0) {
+        return nullptr;
+    }
+    const JavaClass *klass = classes[0].load(std::memory_order_relaxed);
+    for (int i = 1; i < YVM_TYPE_PROFILE_WIDTH; i++) {
+        if (classes[i].load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+    }
+    return klass;
+}
+
+MethodData* MethodData::onInvocation(JavaClass *jc, MethodInfo *method) {
+    MethodData *data = method->methodData.load(std::memory_order_acquire);
+    if (data) {
+        return data;
+    }
+    profileIncrement(method->invocationCount);
+    return allocate(jc, method);
+}
+
+MethodData* MethodData::onBackedge(JavaClass *jc, MethodInfo *method) {
+    MethodData *data = method->methodData.load(std::memory_order_acquire);
+    if (data) {
+        return data;
+    }
+    profileIncrement(method->backedgeCount);
+    return allocate(jc, method);
+}
+
+MethodData* MethodData::allocate(JavaClass *jc, MethodInfo *method) {
+    const uint64_t count = (uint64_t)method->invocationCount.load(std::memory_order_relaxed) +
+                           method->backedgeCount.load(std::memory_order_relaxed);
+    if (count < YVM_PROFILE_THRESHOLD) {
+        return nullptr;
+    }
+
+    auto *data = new MethodData(jc, method);
+    MethodData *expected = nullptr;
+    if (!method->methodData.compare_exchange_strong(expected, data, std::memory_order_acq_rel)) {
+        delete data;
+        return expected;
+    }
+    return data;
+}
+
+MethodData::MethodData(JavaClass *jc, MethodInfo *method) : jc(jc), method(method) {
+    auto *code = static_cast<ATTR_Code*>(jc->findAttribute(method->attributes, method->attributeCount,
+                                                           AttributeKind::Code));
+    if (!code) {
+        return;
+    }
+    u4 pc = 0;
+    while (pc < code->codeLength) {
+        const u1 opcode = code->code[pc];
+        const u4 length = bytecodeLength(code->code, pc, code->codeLength);
+        if (length == 0) {
+            break;
+        }
+        if ((opcode >= op_ifeq && opcode <= op_if_acmpne) || opcode == op_ifnull || opcode == op_ifnonnull) {
+            branchPCs.push_back(pc);
+        } else if (opcode == op_invokevirtual || opcode == op_invokeinterface || opcode == op_checkcast ||
+                   opcode == op_instanceof || opcode == op_aastore) {
+            typePCs.push_back(pc);
+        }
+        pc += length;
+    }
+    branches = new BranchProfile[branchPCs.size()];
+    types = new TypeProfile[typePCs.size()];
+}
+
+MethodData::~MethodData() {
+    delete[] branches;
+    delete[] types;
+}
+
+int MethodData::find(const std::vector<u4> &pcs, u4 pc) {
+    auto it = std::lower_bound(pcs.cbegin(), pcs.cend(), pc);
+    return it != pcs.cend() && *it == pc ? (int)(it - pcs.cbegin()) : -1;
+}
+
+void MethodData::recordBranch(u4 pc, bool taken) {
+    const int index = find(branchPCs, pc);
+    if (index >= 0) {
+        profileIncrement(taken ? branches[index].taken : branches[index].notTaken);
+    }
+}
+
+void MethodData::recordType(u4 pc, const JavaClass *klass) {
+    const int index = find(typePCs, pc);
+    if (index < 0) {
+        return;
+    }
+    TypeProfile &profile = types[index];
+    if (!klass) {
+        profile.nullSeen.store(true, std::memory_order_relaxed);
+        return;
+    }
+    for (int i = 0; i < YVM_TYPE_PROFILE_WIDTH; i++) {
+        const JavaClass *recorded = profile.classes[i].load(std::memory_order_relaxed);
+        if (!recorded) {
+            // 空行由第一个线程占用，竞争失败时 recorded 为占用它的类
+            if (profile.classes[i].compare_exchange_strong(recorded, klass, std::memory_order_relaxed) ||
+                recorded == klass) {
+                profileIncrement(profile.counts[i]);
+                return;
+            }
+        } else if (recorded == klass) {
+            profileIncrement(profile.counts[i]);
+            return;
+        }
+    }
+    profileIncrement(profile.polymorphic);
+}
+
+const BranchProfile* MethodData::branchAt(u4 pc) const {
+    const int index = find(branchPCs, pc);
+    return index >= 0 ? &branches[index] : nullptr;
+}
+
+const TypeProfile* MethodData::typeAt(u4 pc) const {
+    const int index = find(typePCs, pc);
+    return index >= 0 ? &types[index] : nullptr;
+}
+
+void MethodData::print(std::ostream &os) const {
+    os << jc->getClassName() << "." << jc->getString(method->nameIndex) << jc->getString(method->descriptorIndex)
+       << ", invocations " << method->invocationCount.load(std::memory_order_relaxed)
+       << ", backedges " << method->backedgeCount.load(std::memory_order_relaxed) << "\n";
+    FOR_EACH(i, branchPCs.size()) {
+        os << "  " << branchPCs[i] << ": branch taken " << branches[i].taken.load(std::memory_order_relaxed)
+           << ", not taken " << branches[i].notTaken.load(std::memory_order_relaxed) << "\n";
+    }
+    FOR_EACH(i, typePCs.size()) {
+        const TypeProfile &profile = types[i];
+        os << "  " << typePCs[i] << ": types";
+        for (int k = 0; k < YVM_TYPE_PROFILE_WIDTH; k++) {
+            const JavaClass *klass = profile.classes[k].load(std::memory_order_relaxed);
+            if (klass) {
+                os << " " << klass->getClassName() << " " << profile.counts[k].load(std::memory_order_relaxed);
+            }
+        }
+        os << ", polymorphic " << profile.polymorphic.load(std::memory_order_relaxed)
+           << (profile.nullSeen.load(std::memory_order_relaxed) ? ", null seen" : "") << "\n";
+    }
+}
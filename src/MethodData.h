@@ -0,0 +1,96 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_METHODDATA_H
+#define CJVM_METHODDATA_H
+
+#include <atomic>
+#include <vector>
+#include <ostream>
+#include "Type.h"
+#include "Option.h"
+
+class JavaClass;
+class MethodInfo;
+
+/**
+ * 解释器收集的计数都是不加锁的"有损"自增：先读再写，多个线程同时更新时可能丢失几次计数，
+ * 但不需要原子的读-改-写指令，对分支预测和类型推测来说足够准确
+ */
+inline void profileIncrement(std::atomic<u4> &counter) {
+    u4 value = counter.load(std::memory_order_relaxed);
+    if (value != UINT32_MAX) {
+        counter.store(value + 1, std::memory_order_relaxed);
+    }
+}
+
+// 条件跳转指令的跳转和不跳转次数
+class BranchProfile {
+public:
+    std::atomic<u4> taken{0};
+    std::atomic<u4> notTaken{0};
+};
+
+/**
+ * invokevirtual/invokeinterface 的接收者、checkcast/instanceof 的操作数和 aastore 存入的值的类型
+ *
+ * 最多记录 YVM_TYPE_PROFILE_WIDTH 个不同的类，之后出现的类只计入 polymorphic。
+ * nullSeen 表示操作数出现过 null
+ */
+class TypeProfile {
+public:
+    std::atomic<const JavaClass*> classes[YVM_TYPE_PROFILE_WIDTH] = {};
+    std::atomic<u4> counts[YVM_TYPE_PROFILE_WIDTH] = {};
+    std::atomic<u4> polymorphic{0};
+    std::atomic<bool> nullSeen{false};
+
+    // 只见过一个类并且没有见过 null 时返回该类，否则返回 nullptr
+    const JavaClass* monomorphicClass() const;
+};
+
+/**
+ * 方法的运行时 profile，供优化编译器做分支布局、类型推测和去虚化
+ *
+ * 方法被调用和循环回跳的次数之和达到 YVM_PROFILE_THRESHOLD 之后才分配，冷方法只有两个计数器的开销。
+ * 分配时扫描一遍字节码，为每条需要 profile 的指令预留一项，按 pc 升序排列，记录时二分查找
+ */
+class MethodData {
+public:
+    /**
+     * 方法入口和循环回跳处调用，计数并在达到阈值时分配 profile。
+     * 返回 nullptr 表示方法还是冷的，不需要收集 profile
+     */
+    static MethodData* onInvocation(JavaClass *jc, MethodInfo *method);
+    static MethodData* onBackedge(JavaClass *jc, MethodInfo *method);
+
+    ~MethodData();
+
+    void recordBranch(u4 pc, bool taken);
+    // klass 为操作数的类，操作数为 null 时传 nullptr
+    void recordType(u4 pc, const JavaClass *klass);
+
+    // pc 处不是相应的指令时返回 nullptr
+    const BranchProfile* branchAt(u4 pc) const;
+    const TypeProfile* typeAt(u4 pc) const;
+
+    void print(std::ostream &os) const;
+
+private:
+    MethodData(JavaClass *jc, MethodInfo *method);
+
+    static MethodData* allocate(JavaClass *jc, MethodInfo *method);
+    static int find(const std::vector<u4> &pcs, u4 pc);
+
+private:
+    JavaClass *jc;
+    MethodInfo *method;
+
+    std::vector<u4> branchPCs;
+    BranchProfile *branches = nullptr;
+    std::vector<u4> typePCs;
+    TypeProfile *types = nullptr;
+};
+
+
+#endif //CJVM_METHODDATA_H
@@ -0,0 +1,89 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <iostream>
+#include "NativeMethod.h"
+#include "JavaClass.h"
+#include "AccessFlag.h"
+#include "JavaThread.h"
+
+void NativeRegistry::registerNatives(const char *className, const JNINativeMethod *methods, int count) {
+    std::lock_guard<std::mutex> lock(registryMtx);
+    for (int i = 0; i < count; ++i) {
+        std::string key(className);
+        key.append(".").append(methods[i].name).append(methods[i].signature);
+        registry[key] = methods[i].entry;
+    }
+}
+
+bool NativeRegistry::bind(const JavaClass *jc, MethodInfo *method) {
+    NativeEntry entry;
+    if (!lookup(jc, method, entry)) {
+        return false;
+    }
+    method->nativeEntry = entry;
+    return true;
+}
+
+bool NativeRegistry::lookup(const JavaClass *jc, MethodInfo *method, NativeEntry &entry) {
+    const char *name = jc->getString(method->nameIndex);
+    const char *descriptor = jc->getString(method->descriptorIndex);
+
+    {
+        std::string key(jc->getClassName());
+        key.append(".").append(name).append(descriptor);
+
+        std::lock_guard<std::mutex> lock(registryMtx);
+        auto pos = registry.find(key);
+        if (pos == registry.end()) {
+            return false;
+        }
+        entry = pos->second;
+    }
+
+    // 核对 C++ 函数签名与方法描述符的形状，实例方法的第一个参数是 this
+    const MethodSignature &sig = method->signature;
+    int receiver = IS_METHOD_STATIC(method->accessFlags) ? 0 : 1;
+    bool matched = entry.argCount == sig.argCount + receiver && entry.returnType == sig.returnType;
+    if (matched && receiver) {
+        matched = entry.argTypes[0] == T_EXTRA_OBJECT;
+    }
+    for (int i = 0; matched && i < sig.argCount; ++i) {
+        u1 expected = sig.argTypes[i] == T_EXTRA_ARRAY ? (u1)T_EXTRA_OBJECT : sig.argTypes[i];
+        matched = entry.argTypes[i + receiver] == expected;
+    }
+    if (!matched) {
+        std::cerr << __func__ << ":Native method " << jc->getClassName() << "." << name << descriptor
+                  << " does not match its registered signature\n";
+        return false;
+    }
+    return true;
+}
+
+bool NativeRegistry::invoke(RuntimeEnv *env, const JavaClass *jc, MethodInfo *method, std::deque<JType*> &locals,
+                            jvalue &result) {
+    // nativeEntry 只在链接时写入，之后只读
+    const NativeEntry *entry = &method->nativeEntry;
+    if (!entry->isBound()) {
+        entry = method->lateNativeEntry.load(std::memory_order_acquire);
+    }
+    if (!entry) {
+        std::lock_guard<std::mutex> lock(bindMtx);
+        entry = method->lateNativeEntry.load(std::memory_order_acquire);
+        if (!entry) {
+            NativeEntry bound;
+            if (!lookup(jc, method, bound)) {
+                std::string name(jc->getClassName());
+                name.append(".").append(jc->getString(method->nameIndex))
+                    .append(jc->getString(method->descriptorIndex));
+                currentThread->exception.throwNew("java/lang/UnsatisfiedLinkError", name.c_str());
+                return false;
+            }
+            entry = new NativeEntry(bound);
+            method->lateNativeEntry.store(entry, std::memory_order_release);
+        }
+    }
+    result = entry->invoke(env, locals);
+    return true;
+}
@@ -0,0 +1,226 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_NATIVEMETHOD_H
+#define CJVM_NATIVEMETHOD_H
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <utility>
+#include "Type.h"
+#include "Opcode.h"
+#include "JavaType.h"
+
+class RuntimeEnv;
+class JavaClass;
+class MethodInfo;
+
+/****************************************************************************
+ * JNI 风格的原始类型，本地方法直接以这些类型接收参数、返回结果
+ ****************************************************************************/
+using jboolean = uint8_t;
+using jbyte = int8_t;
+using jchar = uint16_t;
+using jshort = int16_t;
+using jint = int32_t;
+using jlong = int64_t;
+using jfloat = float;
+using jdouble = double;
+// 对象和数组都以 JType* 传递，为 nullptr 表示 null。
+// 返回的 jobject 不转移所有权，调用者复制后再压入操作数栈
+using jobject = JType*;
+
+union jvalue {
+    jint i;
+    jlong j;
+    jfloat f;
+    jdouble d;
+    jobject l;
+};
+
+/**
+ * 桥接函数：从本地方法栈帧的局部变量表里按描述符的形状取出参数，调用真正的本地方法
+ *
+ * 每种 C++ 函数签名由模板生成一个桥接函数，调用时不需要任何解析和分配
+ */
+using NativeBridge = jvalue (*)(RuntimeEnv *env, void *function, std::deque<JType*> &locals);
+
+class NativeEntry {
+public:
+    NativeBridge bridge = nullptr;
+    void *function = nullptr;
+
+    // 参数类型(含 this)和返回类型，绑定时与方法描述符核对
+    const u1 *argTypes = nullptr;
+    u1 argCount = 0;
+    u1 returnType = T_EXTRA_VOID;
+
+    bool isBound() const { return bridge != nullptr; }
+
+    inline jvalue invoke(RuntimeEnv *env, std::deque<JType*> &locals) const {
+        return bridge(env, function, locals);
+    }
+};
+
+
+namespace native_detail {
+    template<typename T> struct NativeArg;
+
+#define DEF_NATIVE_INT_ARG(ctype, typeCode) \
+    template<> struct NativeArg<ctype> { \
+        static const u1 type = typeCode; \
+        static const int slots = 1; \
+        static ctype get(JType *v) { return (ctype)static_cast<JInt*>(v)->val; } \
+        static void set(jvalue &r, ctype v) { r.i = v; } \
+    };
+
+    DEF_NATIVE_INT_ARG(jboolean, T_BOOLEAN)
+    DEF_NATIVE_INT_ARG(jbyte, T_BYTE)
+    DEF_NATIVE_INT_ARG(jchar, T_CHAR)
+    DEF_NATIVE_INT_ARG(jshort, T_SHORT)
+    DEF_NATIVE_INT_ARG(jint, T_INT)
+
+    template<> struct NativeArg<jlong> {
+        static const u1 type = T_LONG;
+        static const int slots = 2;
+        static jlong get(JType *v) { return static_cast<JLong*>(v)->val; }
+        static void set(jvalue &r, jlong v) { r.j = v; }
+    };
+
+    template<> struct NativeArg<jfloat> {
+        static const u1 type = T_FLOAT;
+        static const int slots = 1;
+        static jfloat get(JType *v) { return static_cast<JFloat*>(v)->val; }
+        static void set(jvalue &r, jfloat v) { r.f = v; }
+    };
+
+    template<> struct NativeArg<jdouble> {
+        static const u1 type = T_DOUBLE;
+        static const int slots = 2;
+        static jdouble get(JType *v) { return static_cast<JDouble*>(v)->val; }
+        static void set(jvalue &r, jdouble v) { r.d = v; }
+    };
+
+    template<> struct NativeArg<jobject> {
+        static const u1 type = T_EXTRA_OBJECT;
+        static const int slots = 1;
+        static jobject get(JType *v) { return v; }
+        static void set(jvalue &r, jobject v) { r.l = v; }
+    };
+
+    // 第 I 个参数在局部变量表中的槽位
+    template<typename... Args>
+    constexpr int slotOf(std::size_t index) {
+        const int slots[] = {0, NativeArg<Args>::slots...};
+        int slot = 0;
+        for (std::size_t k = 0; k < index; ++k) {
+            slot += slots[k + 1];
+        }
+        return slot;
+    }
+
+    template<typename R, typename... Args>
+    struct Bridge {
+        using Function = R (*)(RuntimeEnv*, Args...);
+
+        template<std::size_t... I>
+        static jvalue call(RuntimeEnv *env, Function f, std::deque<JType*> &locals, std::index_sequence<I...>) {
+            jvalue r;
+            r.j = 0;
+            NativeArg<R>::set(r, f(env, NativeArg<Args>::get(locals[slotOf<Args...>(I)])...));
+            return r;
+        }
+
+        static jvalue invoke(RuntimeEnv *env, void *function, std::deque<JType*> &locals) {
+            return call(env, reinterpret_cast<Function>(function), locals, std::index_sequence_for<Args...>{});
+        }
+    };
+
+    template<typename... Args>
+    struct Bridge<void, Args...> {
+        using Function = void (*)(RuntimeEnv*, Args...);
+
+        template<std::size_t... I>
+        static void call(RuntimeEnv *env, Function f, std::deque<JType*> &locals, std::index_sequence<I...>) {
+            f(env, NativeArg<Args>::get(locals[slotOf<Args...>(I)])...);
+        }
+
+        static jvalue invoke(RuntimeEnv *env, void *function, std::deque<JType*> &locals) {
+            call(env, reinterpret_cast<Function>(function), locals, std::index_sequence_for<Args...>{});
+            jvalue r;
+            r.j = 0;
+            return r;
+        }
+    };
+
+    template<typename R> struct ReturnType { static const u1 type = NativeArg<R>::type; };
+    template<> struct ReturnType<void> { static const u1 type = T_EXTRA_VOID; };
+
+    template<typename... Args>
+    struct ArgTypes {
+        static const u1 types[sizeof...(Args) + 1];
+    };
+    template<typename... Args>
+    const u1 ArgTypes<Args...>::types[sizeof...(Args) + 1] = {NativeArg<Args>::type..., 0};
+}
+
+
+/**
+ * 等价于 JNI 的 JNINativeMethod，用 makeNativeMethod 构造，由模板推导出桥接函数
+ */
+class JNINativeMethod {
+public:
+    const char *name;
+    const char *signature;
+    NativeEntry entry;
+};
+
+template<typename R, typename... Args>
+JNINativeMethod makeNativeMethod(const char *name, const char *signature, R (*function)(RuntimeEnv*, Args...)) {
+    JNINativeMethod m;
+    m.name = name;
+    m.signature = signature;
+    m.entry.bridge = &native_detail::Bridge<R, Args...>::invoke;
+    m.entry.function = reinterpret_cast<void*>(function);
+    m.entry.argTypes = native_detail::ArgTypes<Args...>::types;
+    m.entry.argCount = sizeof...(Args);
+    m.entry.returnType = native_detail::ReturnType<R>::type;
+    return m;
+}
+
+
+/**
+ * 本地方法注册表
+ *
+ * 以字符串为键只在注册和链接时查找，链接时把入口绑定到 MethodInfo 上，之后调用只是一次间接跳转
+ */
+class NativeRegistry {
+public:
+    // 等价于 JNI 的 RegisterNatives，className 形如 java/lang/Thread
+    void registerNatives(const char *className, const JNINativeMethod *methods, int count);
+
+    // 链接时为本地方法绑定入口(写入 nativeEntry)，找不到或签名不匹配时返回 false
+    bool bind(const JavaClass *jc, MethodInfo *method);
+
+    /**
+     * 执行引擎调用本地方法的入口。链接时还没有注册的方法在第一次调用时再绑定，
+     * 绑定结果作为一个不可变的 NativeEntry 经 lateNativeEntry 发布(release/acquire)，
+     * 仍然找不到时抛出 UnsatisfiedLinkError 并返回 false
+     */
+    bool invoke(RuntimeEnv *env, const JavaClass *jc, MethodInfo *method, std::deque<JType*> &locals,
+                jvalue &result);
+
+private:
+    bool lookup(const JavaClass *jc, MethodInfo *method, NativeEntry &entry);
+
+    std::mutex registryMtx;
+    // 串行化调用时的延迟绑定，同一个方法只发布一次 lateNativeEntry
+    std::mutex bindMtx;
+    std::unordered_map<std::string, NativeEntry> registry;
+};
+
+
+#endif //CJVM_NATIVEMETHOD_H
@@ -2,37 +2,120 @@
 // Created by ha on 18/6/16.
 //
 
+#include <stdexcept>
 #include "ObjectMonitor.h"
+#include "JavaThread.h"
+#include "VirtualThread.h"
+#include "JavaHeap.h"
+#include "RuntimeEnv.h"
 
-void ObjectMonitor::enter(std::thread::id tid) {
+bool ObjectMonitor::enter(JavaThread *thread) {
     std::unique_lock<std::mutex> lock(internalMtx);
 
     if (monitorCnt == 0) {
         monitorCnt = 1;
-        owner = tid;
-        entered = true;
-    } else {
-        if (tid == owner) {
-            ++monitorCnt;
-            entered = true;
-        } else {
-            cv.wait(lock, [=] { return monitorCnt == 0; });
-            entered = true;
+        owner = thread;
+        return true;
+    }
+
+    if (thread == owner) {
+        ++monitorCnt;
+        return true;
+    }
+
+    if (thread->isVirtual()) {
+        // 持锁期间挂起，exit() 一定在 park() 之后才能看到这个等待者
+        auto *vt = static_cast<VirtualThread*>(thread);
+        virtualWaiters.push_back(vt);
+        vt->park();
+        return false;
+    }
+
+    thread->safepointState = SafepointState::SAFE;
+    cv.wait(lock, [=] { return monitorCnt == 0; });
+    thread->safepointState = SafepointState::RUNNING;
+    monitorCnt = 1;
+    owner = thread;
+    lock.unlock();
+
+    thread->pollSafepoint();
+    return true;
+}
+
+void ObjectMonitor::exit(JavaThread *thread) {
+    VirtualThread *waiter = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(internalMtx);
+
+        if (owner != thread || monitorCnt == 0) {
+            throw std::runtime_error("illegal monitor state");
+        }
+
+        --monitorCnt;
+        if (monitorCnt != 0) {
+            return;
         }
+        owner = nullptr;
+
+        if (!virtualWaiters.empty()) {
+            waiter = virtualWaiters.front();
+            virtualWaiters.pop_front();
+        }
+        cv.notify_one();
+    }
+
+    if (waiter) {
+        waiter->unpark();
     }
 }
 
-void ObjectMonitor::exit() {
-    std::unique_lock<std::mutex> lock(internalMtx);
+void ObjectMonitor::transfer(JavaThread *thread, int32_t count) {
+    std::lock_guard<std::mutex> lock(internalMtx);
+    monitorCnt = count;
+    owner = thread;
+}
 
-    if (!entered) {
-        throw std::runtime_error("illegal monitor state");
+
+/****************************************************************************
+ * ObjectSynchronizer
+ ****************************************************************************/
+std::mutex ObjectSynchronizer::tableMtx;
+std::unordered_map<std::size_t, ObjectMonitor*> ObjectSynchronizer::monitors;
+
+ObjectMonitor* ObjectSynchronizer::monitorFor(std::size_t obj) {
+    std::lock_guard<std::mutex> lock(tableMtx);
+    ObjectMonitor *&monitor = monitors[obj];
+    if (!monitor) {
+        monitor = new ObjectMonitor;
     }
+    return monitor;
+}
 
-    --monitorCnt;
-    if (monitorCnt == 0) {
-        cv.notify_one();
+bool ObjectSynchronizer::enter(JavaThread *thread, std::size_t obj) {
+    ObjectHeader *header = crt.jheap->at<ObjectHeader>(obj);
+    if (header->mark & ObjectHeader::MARK_UNPUBLISHED) {
+        if ((header->mark >> ObjectHeader::MARK_LOCK_SHIFT) < ObjectHeader::MARK_LOCK_MAX) {
+            header->mark += 1u << ObjectHeader::MARK_LOCK_SHIFT;
+            return true;
+        }
+        // 重入次数放不下时发布对象，改用 ObjectMonitor 计数
+        crt.jheap->publish(obj);
     }
+    return monitorFor(obj)->enter(thread);
+}
 
+void ObjectSynchronizer::exit(JavaThread *thread, std::size_t obj) {
+    ObjectHeader *header = crt.jheap->at<ObjectHeader>(obj);
+    if (header->mark & ObjectHeader::MARK_UNPUBLISHED) {
+        if ((header->mark >> ObjectHeader::MARK_LOCK_SHIFT) == 0) {
+            throw std::runtime_error("illegal monitor state");
+        }
+        header->mark -= 1u << ObjectHeader::MARK_LOCK_SHIFT;
+        return;
+    }
+    monitorFor(obj)->exit(thread);
 }
 
+void ObjectSynchronizer::inflate(JavaThread *thread, std::size_t obj, u4 count) {
+    monitorFor(obj)->transfer(thread, (int32_t)count);
+}
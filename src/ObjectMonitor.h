@@ -8,18 +8,54 @@
 #include <thread>
 #include <condition_variable>
 #include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include "Type.h"
+
+class JavaThread;
+class VirtualThread;
 
 class ObjectMonitor {
 public:
-    void enter(std::thread::id tid);
-    void exit();
+    // 返回 false 表示当前虚拟线程已挂起，恢复后需要重新执行 monitorenter
+    bool enter(JavaThread *thread);
+    void exit(JavaThread *thread);
+
+    // 对象发布时把省略的锁交给新建的 monitor，thread 已经持有 count 次
+    void transfer(JavaThread *thread, int32_t count);
 
 private:
     std::mutex internalMtx;
-    volatile bool entered = false;
     int32_t monitorCnt = 0;
-    std::thread::id owner;
+    // 虚拟线程共用承载线程，所以持有者用 JavaThread 而不是原生线程 id 标识
+    JavaThread *owner = nullptr;
     std::condition_variable cv;
+    std::deque<VirtualThread*> virtualWaiters;
+};
+
+/**
+ * monitorenter/monitorexit 的入口，obj 为对象的堆偏移量
+ *
+ * 未发布的对象只有分配它的线程能看到，加锁只在对象头的 mark 中记录重入次数，不需要任何原子操作，
+ * 也不需要 ObjectMonitor。对象被发布时还持有的锁由 JavaHeap::publish 转移到该对象的 ObjectMonitor 上。
+ * 已发布对象的 ObjectMonitor 在第一次加锁时创建
+ */
+class ObjectSynchronizer {
+public:
+    // 返回 false 表示当前虚拟线程已挂起，恢复后需要重新执行 monitorenter
+    static bool enter(JavaThread *thread, std::size_t obj);
+    static void exit(JavaThread *thread, std::size_t obj);
+
+    // 由 JavaHeap::publish 调用
+    static void inflate(JavaThread *thread, std::size_t obj, u4 count);
+
+private:
+    static ObjectMonitor* monitorFor(std::size_t obj);
+
+    static std::mutex tableMtx;
+    static std::unordered_map<std::size_t, ObjectMonitor*> monitors;
 };
 
 
@@ -0,0 +1,445 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <algorithm>
+#include "Optimizer.h"
+#include "JavaClass.h"
+#include "AccessFlag.h"
+#include "Opcode.h"
+#include "EscapeAnalysis.h"
+
+static bool isNullConstant(const SSANode *node) {
+    return node->isConstant() && node->type == T_EXTRA_OBJECT && node->cpIndex == 0;
+}
+
+static bool isIntConstant(const SSANode *node, int64_t value) {
+    return node->isConstant() && node->type == T_INT && node->aux == value;
+}
+
+// 解引用的对象，不解引用时返回 nullptr
+static SSANode* dereferencedObject(const SSANode *node) {
+    switch (node->op) {
+        case SSAOp::GET_FIELD:
+        case SSAOp::PUT_FIELD:
+        case SSAOp::ARRAY_LENGTH:
+        case SSAOp::LOAD_INDEXED:
+        case SSAOp::STORE_INDEXED:
+        case SSAOp::MONITOR_ENTER:
+        case SSAOp::MONITOR_EXIT:
+        case SSAOp::NULL_CHECK:
+            return node->inputs[0];
+        case SSAOp::INVOKE:
+            if (node->aux == op_invokevirtual || node->aux == op_invokespecial || node->aux == op_invokeinterface) {
+                return node->inputs[0];
+            }
+            return nullptr;
+        default:
+            return nullptr;
+    }
+}
+
+Optimizer::Optimizer(SSAGraph *graph) : graph(graph) {
+    u4 maxId = 0;
+    for (auto *block : graph->blocks) {
+        maxId = std::max(maxId, block->id);
+    }
+    order.assign(maxId + 1, 0);
+    FOR_EACH(i, graph->blocks.size()) {
+        order[graph->blocks[i]->id] = (u4)i;
+    }
+}
+
+void Optimizer::run(SSAGraph *graph) {
+    Optimizer optimizer(graph);
+    optimizer.computeDominators();
+    optimizer.computeLoops();
+#ifdef YVM_LOCK_ELISION
+    optimizer.eliminateLocks();
+#endif
+
+    std::vector<bool> nonNull(graph->nodes.size(), false);
+    optimizer.eliminateNullChecks(graph->blocks[0], nonNull);
+
+    std::map<std::vector<int64_t>, SSANode*> table;
+    optimizer.numberValues(graph->blocks[0], table);
+    graph->applyReplacements();
+
+    optimizer.hoistInvariants();
+    optimizer.eliminateRangeChecks();
+}
+
+void Optimizer::computeDominators() {
+    // Cooper, Harvey, Kennedy: A Simple, Fast Dominance Algorithm
+    SSABlock *entry = graph->blocks[0];
+    for (auto *block : graph->blocks) {
+        block->idom = nullptr;
+        block->dominated.clear();
+    }
+    entry->idom = entry;
+
+    auto intersect = [&](SSABlock *a, SSABlock *b) {
+        while (a != b) {
+            while (order[a->id] > order[b->id]) {
+                a = a->idom;
+            }
+            while (order[b->id] > order[a->id]) {
+                b = b->idom;
+            }
+        }
+        return a;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t i = 1; i < graph->blocks.size(); i++) {
+            SSABlock *block = graph->blocks[i];
+            SSABlock *idom = nullptr;
+            for (auto *pred : block->preds) {
+                if (pred->idom) {
+                    idom = idom ? intersect(pred, idom) : pred;
+                }
+            }
+            if (idom != block->idom) {
+                block->idom = idom;
+                changed = true;
+            }
+        }
+    }
+    for (std::size_t i = 1; i < graph->blocks.size(); i++) {
+        graph->blocks[i]->idom->dominated.push_back(graph->blocks[i]);
+    }
+}
+
+void Optimizer::computeLoops() {
+    // 目标支配源的边为回边，同一个循环头的所有回边组成一个自然循环
+    for (auto *block : graph->blocks) {
+        for (auto *succ : block->succs) {
+            if (!graph->dominates(succ, block)) {
+                continue;
+            }
+            auto it = std::find_if(loops.begin(), loops.end(), [&](const Loop &loop) { return loop.header == succ; });
+            if (it == loops.end()) {
+                loops.emplace_back();
+                loops.back().header = succ;
+                it = loops.end() - 1;
+            }
+            if (std::find(it->backEdges.cbegin(), it->backEdges.cend(), block) == it->backEdges.cend()) {
+                it->backEdges.push_back(block);
+            }
+        }
+    }
+
+    for (auto &loop : loops) {
+        loop.body.assign(order.size(), false);
+        loop.body[loop.header->id] = true;
+        std::vector<SSABlock*> worklist(loop.backEdges.cbegin(), loop.backEdges.cend());
+        while (!worklist.empty()) {
+            SSABlock *block = worklist.back();
+            worklist.pop_back();
+            if (loop.body[block->id]) {
+                continue;
+            }
+            loop.body[block->id] = true;
+            worklist.insert(worklist.end(), block->preds.cbegin(), block->preds.cend());
+        }
+
+        for (auto *block : graph->blocks) {
+            if (loop.body[block->id]) {
+                loop.size++;
+                block->loopDepth++;
+            }
+        }
+        SSABlock *outside = nullptr;
+        for (auto *pred : loop.header->preds) {
+            if (loop.body[pred->id]) {
+                continue;
+            }
+            if (outside && outside != pred) {
+                outside = nullptr;
+                break;
+            }
+            outside = pred;
+        }
+        if (outside && outside->succs.size() == 1) {
+            loop.preheader = outside;
+        }
+    }
+    // 内层循环先外提，外提出来的节点可以继续外提到外层循环
+    std::sort(loops.begin(), loops.end(), [](const Loop &a, const Loop &b) { return a.size < b.size; });
+}
+
+void Optimizer::eliminateLocks() {
+    const EscapeInfo *info = EscapeAnalysis::analyze(graph->jc, graph->method);
+    if (!info || info->elidableMonitors.empty()) {
+        return;
+    }
+    for (auto *block : graph->blocks) {
+        for (auto *node : block->nodes) {
+            // 内联进来的节点记为调用点的 pc，不会被当作可以消除的 monitor 指令
+            if ((node->op == SSAOp::MONITOR_ENTER || node->op == SSAOp::MONITOR_EXIT) &&
+                info->isMonitorElidable(node->pc)) {
+                // 对 null 加锁仍然要抛出 NullPointerException
+                node->op = SSAOp::NULL_CHECK;
+            }
+        }
+    }
+}
+
+void Optimizer::eliminateNullChecks(SSABlock *block, std::vector<bool> &nonNull) {
+    std::vector<u4> marked;
+    auto mark = [&](const SSANode *node) {
+        if (!nonNull[node->id]) {
+            nonNull[node->id] = true;
+            marked.push_back(node->id);
+        }
+    };
+
+    // 只有一个前驱并且是 if (x != null) 成立或者 if (x == null) 不成立的分支
+    if (block->preds.size() == 1) {
+        const SSANode *branch = block->preds[0]->terminator();
+        if (branch->op == SSAOp::IF && block->preds[0]->succs[0] != block->preds[0]->succs[1]) {
+            const auto condition = (SSACondition)branch->aux;
+            const bool taken = block->preds[0]->succs[0] == block;
+            if ((condition == SSACondition::NE && taken) || (condition == SSACondition::EQ && !taken)) {
+                if (isNullConstant(branch->inputs[1])) {
+                    mark(branch->inputs[0]);
+                } else if (isNullConstant(branch->inputs[0])) {
+                    mark(branch->inputs[1]);
+                }
+            }
+        }
+    }
+
+    const bool isStatic = IS_METHOD_STATIC(graph->method->accessFlags);
+    for (auto *node : block->nodes) {
+        switch (node->op) {
+            case SSAOp::NEW:
+            case SSAOp::NEW_ARRAY:
+                mark(node);
+                break;
+            case SSAOp::PARAM:
+                if (!isStatic && node->aux == 0) {
+                    mark(node);
+                }
+                break;
+            case SSAOp::CONSTANT:
+                if (node->type == T_EXTRA_OBJECT && node->cpIndex != 0) {
+                    mark(node);
+                }
+                break;
+            case SSAOp::CHECK_CAST:
+                if (nonNull[node->inputs[0]->id]) {
+                    mark(node);
+                }
+                break;
+            default:
+                break;
+        }
+        SSANode *object = dereferencedObject(node);
+        if (!object) {
+            continue;
+        }
+        if (nonNull[object->id]) {
+            node->nullCheck = false;
+        } else {
+            // 之后的指令执行时该对象一定不为 null
+            mark(object);
+        }
+    }
+    block->nodes.erase(std::remove_if(block->nodes.begin(), block->nodes.end(), [](const SSANode *node) {
+        return node->op == SSAOp::NULL_CHECK && !node->nullCheck;
+    }), block->nodes.end());
+
+    for (auto *dominated : block->dominated) {
+        eliminateNullChecks(dominated, nonNull);
+    }
+    for (u4 id : marked) {
+        nonNull[id] = false;
+    }
+}
+
+bool Optimizer::isPure(const SSANode *node) {
+    switch (node->op) {
+        case SSAOp::CONSTANT:
+        case SSAOp::ADD:
+        case SSAOp::SUB:
+        case SSAOp::MUL:
+        case SSAOp::NEG:
+        case SSAOp::SHL:
+        case SSAOp::SHR:
+        case SSAOp::USHR:
+        case SSAOp::AND:
+        case SSAOp::OR:
+        case SSAOp::XOR:
+        case SSAOp::CONVERT:
+        case SSAOp::COMPARE:
+        case SSAOp::ARRAY_LENGTH:
+        case SSAOp::INSTANCE_OF:
+            return true;
+        case SSAOp::DIV:
+        case SSAOp::REM:
+            // 整数除以非 0 常量不会抛出 ArithmeticException
+            return (node->type != T_INT && node->type != T_LONG) ||
+                   (node->inputs[1]->isConstant() && node->inputs[1]->aux != 0);
+        default:
+            return false;
+    }
+}
+
+bool Optimizer::canTrap(const SSANode *node) {
+    // instanceof 可能需要加载类
+    return (node->op == SSAOp::ARRAY_LENGTH && node->nullCheck) || node->op == SSAOp::INSTANCE_OF;
+}
+
+void Optimizer::numberValues(SSABlock *block, std::map<std::vector<int64_t>, SSANode*> &table) {
+    std::vector<std::vector<int64_t>> inserted;
+    for (auto *node : block->nodes) {
+        if (!isPure(node)) {
+            continue;
+        }
+        std::vector<int64_t> key{(int64_t)node->op, node->type, node->aux, node->cpIndex,
+                                 (int64_t)reinterpret_cast<intptr_t>(node->jc)};
+        std::vector<int64_t> inputs;
+        for (auto *input : node->inputs) {
+            inputs.push_back(SSAGraph::resolve(input)->id);
+        }
+        const bool commutative = (node->type == T_INT || node->type == T_LONG) &&
+                                 (node->op == SSAOp::ADD || node->op == SSAOp::MUL || node->op == SSAOp::AND ||
+                                  node->op == SSAOp::OR || node->op == SSAOp::XOR);
+        if (commutative) {
+            std::sort(inputs.begin(), inputs.end());
+        }
+        key.insert(key.end(), inputs.begin(), inputs.end());
+
+        auto it = table.find(key);
+        if (it != table.end()) {
+            node->replacement = it->second;
+        } else {
+            table.emplace(key, node);
+            inserted.push_back(std::move(key));
+        }
+    }
+
+    for (auto *dominated : block->dominated) {
+        numberValues(dominated, table);
+    }
+    for (const auto &key : inserted) {
+        table.erase(key);
+    }
+}
+
+void Optimizer::hoistInvariants() {
+    for (auto &loop : loops) {
+        if (!loop.preheader) {
+            continue;
+        }
+        auto &target = loop.preheader->nodes;
+        for (auto *block : graph->blocks) {
+            if (!loop.body[block->id]) {
+                continue;
+            }
+            // 循环头中第一个有副作用的节点之前，可能抛出异常的纯运算也可以外提
+            bool sideEffects = block != loop.header;
+            std::vector<SSANode*> remaining;
+            for (auto *node : block->nodes) {
+                bool invariant = isPure(node) && (!sideEffects || !canTrap(node));
+                for (auto *input : node->inputs) {
+                    if (!invariant) {
+                        break;
+                    }
+                    invariant = !loop.body[input->block->id];
+                }
+                if (invariant) {
+                    node->block = loop.preheader;
+                    target.insert(target.end() - 1, node);
+                } else {
+                    remaining.push_back(node);
+                    if (!isPure(node) || canTrap(node)) {
+                        sideEffects = true;
+                    }
+                }
+            }
+            block->nodes.swap(remaining);
+        }
+    }
+}
+
+bool Optimizer::isLoopBounded(const SSANode *index, const SSANode *array, const SSABlock *access) const {
+    if (index->op != SSAOp::PHI || index->type != T_INT) {
+        return false;
+    }
+    auto it = std::find_if(loops.cbegin(), loops.cend(), [&](const Loop &loop) {
+        return loop.header == index->block;
+    });
+    if (it == loops.cend()) {
+        return false;
+    }
+    const Loop &loop = *it;
+
+    // 循环头以 i < a.length 判断是否继续循环，guarded 为条件成立时进入的循环内的基本块
+    const SSANode *branch = loop.header->terminator();
+    if (branch->op != SSAOp::IF) {
+        return false;
+    }
+    const SSANode *x = branch->inputs[0], *y = branch->inputs[1];
+    const auto condition = (SSACondition)branch->aux;
+    const SSANode *length;
+    int taken;
+    if (x == index && (condition == SSACondition::LT || condition == SSACondition::GE)) {
+        length = y;
+        taken = condition == SSACondition::LT ? 0 : 1;
+    } else if (y == index && (condition == SSACondition::GT || condition == SSACondition::LE)) {
+        length = x;
+        taken = condition == SSACondition::GT ? 0 : 1;
+    } else {
+        return false;
+    }
+    if (length->op != SSAOp::ARRAY_LENGTH || length->inputs[0] != array) {
+        return false;
+    }
+    const SSABlock *guarded = loop.header->succs[taken];
+    if (!loop.body[guarded->id] || guarded->preds.size() != 1 || !graph->dominates(guarded, access)) {
+        return false;
+    }
+
+    // 从循环外进入时为非负常量，每次回到循环头时为判断过的 i 加 1，因此不会溢出
+    FOR_EACH(i, index->inputs.size()) {
+        const SSANode *input = index->inputs[i];
+        if (!loop.body[loop.header->preds[i]->id]) {
+            if (!input->isConstant() || input->aux < 0) {
+                return false;
+            }
+            continue;
+        }
+        if (input->op != SSAOp::ADD ||
+            !((input->inputs[0] == index && isIntConstant(input->inputs[1], 1)) ||
+              (input->inputs[1] == index && isIntConstant(input->inputs[0], 1))) ||
+            !graph->dominates(guarded, input->block)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Optimizer::eliminateRangeChecks() {
+    for (auto *block : graph->blocks) {
+        for (auto *node : block->nodes) {
+            if (node->op != SSAOp::LOAD_INDEXED && node->op != SSAOp::STORE_INDEXED) {
+                continue;
+            }
+            const SSANode *array = node->inputs[0];
+            const SSANode *index = node->inputs[1];
+            // 常量下标访问一维的新数组
+            if (array->op == SSAOp::NEW_ARRAY && array->inputs.size() == 1 && array->inputs[0]->isConstant() &&
+                index->isConstant() && index->aux >= 0 && index->aux < array->inputs[0]->aux) {
+                node->rangeCheck = false;
+                continue;
+            }
+            if (isLoopBounded(index, array, block)) {
+                node->rangeCheck = false;
+            }
+        }
+    }
+}
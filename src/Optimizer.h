@@ -0,0 +1,62 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_OPTIMIZER_H
+#define CJVM_OPTIMIZER_H
+
+#include <map>
+#include <vector>
+#include "SSA.h"
+
+/**
+ * SSA 形式上的优化，依次为：
+ *
+ * 1. 计算支配树和自然循环
+ * 2. 锁消除：逃逸分析证明加锁对象不会被其它线程看到的 monitorenter/monitorexit 只保留 null 检查
+ * 3. null 检查消除：new 出来的对象、this 以及支配路径上已经解引用过或者判断过非 null 的值不再检查
+ * 4. 全局值编号：沿支配树查找相同的纯运算，用支配它的那个代替
+ * 5. 循环不变量外提：输入都在循环外定义的纯运算移到循环的前置块
+ * 6. 数组越界检查消除：常量下标访问常量长度的新数组，以及 for (i = c; i < a.length; i++) 形式的循环中用 i 访问 a
+ *
+ * 消除的检查只记录在 SSA 图上，还没有代码生成器使用优化的结果
+ */
+class Optimizer {
+public:
+    static void run(SSAGraph *graph);
+
+private:
+    class Loop {
+    public:
+        SSABlock *header;
+        // 唯一的循环外前驱且只有一个后继时为该前驱，否则为 nullptr，不做外提
+        SSABlock *preheader = nullptr;
+        // 以 SSABlock::id 索引
+        std::vector<bool> body;
+        u4 size = 0;
+        std::vector<SSABlock*> backEdges;
+    };
+
+    explicit Optimizer(SSAGraph *graph);
+
+    void computeDominators();
+    void computeLoops();
+    void eliminateLocks();
+    void eliminateNullChecks(SSABlock *block, std::vector<bool> &nonNull);
+    void numberValues(SSABlock *block, std::map<std::vector<int64_t>, SSANode*> &table);
+    void hoistInvariants();
+    void eliminateRangeChecks();
+    bool isLoopBounded(const SSANode *index, const SSANode *array, const SSABlock *access) const;
+
+    static bool isPure(const SSANode *node);
+    static bool canTrap(const SSANode *node);
+
+private:
+    SSAGraph *graph;
+    // 以 SSABlock::id 索引，基本块在逆后序中的位置
+    std::vector<u4> order;
+    std::vector<Loop> loops;
+};
+
+
+#endif //CJVM_OPTIMIZER_H
@@ -17,6 +17,98 @@
  */
 #define YVM_GC_THRESHOLD_VALUE (1024*1024)
 
+/*
+ * denote the capacity of java heap, the size of thread local allocation buffer,
+ * and the alignment of every object allocated on java heap
+ */
+#define YVM_HEAP_CAPACITY (256*1024*1024)
+#define YVM_TLAB_SIZE (64*1024)
+#define YVM_HEAP_ALIGNMENT 8
+
+/*
+ * define to store references inside java heap(object fields and reference array
+ * elements) as 32-bit offsets shifted right by YVM_REFERENCE_SHIFT, which
+ * addresses up to 4G << YVM_REFERENCE_SHIFT bytes of heap. (1 << YVM_REFERENCE_SHIFT)
+ * must not be greater than YVM_HEAP_ALIGNMENT
+ */
+#define YVM_COMPRESSED_REFERENCES
+#define YVM_REFERENCE_SHIFT 3
+
+/*
+ * define to skip debug and annotation attributes(LineNumberTable, StackMapTable,
+ * RuntimeVisibleAnnotations, etc) while parsing class file, they are decoded on
+ * first access instead
+ */
+#define YVM_LAZY_ATTRIBUTES
+
+/*
+ * define to store strings whose characters all fit in Latin-1 with one byte per
+ * character, otherwise every string is stored as UTF-16
+ */
+#define YVM_COMPACT_STRINGS
+
+/*
+ * define to parse uncompressed(stored) jar entries directly from the mapped jar
+ * file instead of copying them out
+ */
+#define YVM_JAR_MAP_STORED_ENTRIES
+
+/*
+ * define to verify bytecode with StackMapTable type checking when a class is
+ * linked, classes loaded from a class data sharing archive which have been
+ * verified when dumped are not checked again
+ */
+#define YVM_VERIFY_BYTECODE
+
+/*
+ * max directory depth scanned when indexing packages on the class path
+ */
+#define YVM_CLASS_PATH_MAX_DEPTH 64
+
+/*
+ * max number of frames recorded in an exception stack trace, deeper frames are
+ * counted but not recorded
+ */
+#define YVM_STACK_TRACE_DEPTH 1024
+
+/*
+ * length of the primary supertype display of each class, subtype checks against
+ * classes whose depth in the class hierarchy is less than this take constant time,
+ * deeper classes and interfaces are searched in the secondary supertype list
+ */
+#define YVM_PRIMARY_SUPER_DEPTH 8
+
+/*
+ * max depth of statically bound callees analyzed when computing escape states of
+ * call arguments, and the max bytecode size of a callee which is assumed to be
+ * inlined so that arguments not escaping in it do not escape the caller either
+ */
+#define YVM_ESCAPE_ANALYSIS_MAX_DEPTH 5
+#define YVM_ESCAPE_ANALYSIS_INLINE_SIZE 35
+
+/*
+ * max bytecode size and max nesting depth of statically bound, branch-free callees
+ * inlined while building the SSA form of a method for the optimizing compiler
+ */
+#define YVM_MAX_INLINE_SIZE 35
+#define YVM_MAX_INLINE_DEPTH 9
+
+/*
+ * define to elide monitor operations on objects that only one thread can see:
+ * objects not yet published to the heap lock by counting in their mark word
+ * without atomics or an ObjectMonitor, and the optimizer removes monitors on
+ * objects that escape analysis proves do not escape the compiled method
+ */
+#define YVM_LOCK_ELISION
+
+/*
+ * number of invocations plus loop back edges after which a method starts collecting
+ * branch and type profiles, and the number of distinct classes recorded per call site,
+ * cast or array store before further classes are only counted as polymorphic
+ */
+#define YVM_PROFILE_THRESHOLD 500
+#define YVM_TYPE_PROFILE_WIDTH 2
+
 /*
  * define to show new spawning thread name
  */
@@ -3,3 +3,20 @@
 //
 
 #include "RuntimeEnv.h"
+#include "JavaHeap.h"
+#include "GC.h"
+#include "StringTable.h"
+
+RuntimeEnv::RuntimeEnv() : ma(nullptr) {
+    jheap = new JavaHeap;
+    gc = new ConcurrentGC;
+    stringTable = new StringTable(jheap);
+    registerThreadNatives(this);
+    registerStringNatives(this);
+}
+
+RuntimeEnv::~RuntimeEnv() {
+    delete stringTable;
+    delete gc;
+    delete jheap;
+}
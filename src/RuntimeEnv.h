@@ -7,14 +7,19 @@
 
 #include <unordered_map>
 #include <string>
+#include <functional>
 #include "Type.h"
 #include "Frame.h"
+#include "JavaThread.h"
+#include "NativeMethod.h"
 
 class JType;
 class Frame;
 class JavaHeap;
 class MethodArea;
 class ConcurrentGC;
+class StringTable;
+class VirtualThreadScheduler;
 
 class RuntimeEnv {
 public:
@@ -23,11 +28,18 @@ public:
 
     MethodArea *ma;
     JavaHeap *jheap;
-    std::unordered_map<std::string, JType*(*)(RuntimeEnv*)> nativeMethods;
+    NativeRegistry natives;
     ConcurrentGC *gc;
+    StringTable *stringTable;
+
+    // 由执行引擎设置，在新建的 Java 线程上执行 Thread.run()。
+    // 对虚拟线程，栈帧非空时表示从挂起处恢复；线程请求让出时必须尽快返回且保留栈帧
+    std::function<void(JavaThread*)> runJavaThread;
+
+    // 非空时 Thread.start 创建虚拟线程，由少量承载线程调度执行
+    VirtualThreadScheduler *vts = nullptr;
 };
 
 extern RuntimeEnv crt;
-extern thread_local StackFrames frames;
 
 #endif //CJVM_RUNTIMEENV_H
@@ -0,0 +1,1317 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <algorithm>
+#include <cstring>
+#include "SSA.h"
+#include "JavaClass.h"
+#include "AccessFlag.h"
+#include "Bytecode.h"
+#include "Descriptor.h"
+#include "Option.h"
+
+static const char *SSA_OP_NAMES[] = {
+        "param", "const", "phi",
+        "add", "sub", "mul", "div", "rem", "neg", "shl", "shr", "ushr", "and", "or", "xor", "convert", "compare",
+        "arraylength", "load_indexed", "store_indexed", "getfield", "putfield", "getstatic", "putstatic",
+        "new", "newarray", "checkcast", "instanceof", "nullcheck", "invoke", "monitorenter", "monitorexit",
+        "if", "goto", "switch", "return", "throw"
+};
+
+static const char *SSA_CONDITION_NAMES[] = {"eq", "ne", "lt", "ge", "gt", "le"};
+
+static bool isCategory2(u1 type) {
+    return type == T_LONG || type == T_DOUBLE;
+}
+
+static u1 fieldType(const char *descriptor) {
+    switch (descriptor[0]) {
+        case 'J':
+            return T_LONG;
+        case 'F':
+            return T_FLOAT;
+        case 'D':
+            return T_DOUBLE;
+        case 'L':
+        case '[':
+            return T_EXTRA_OBJECT;
+        default:
+            return T_INT;
+    }
+}
+
+static inline bool isConditionalBranch(u1 opcode) {
+    return (opcode >= op_ifeq && opcode <= op_if_acmpne) || opcode == op_ifnull || opcode == op_ifnonnull;
+}
+
+static inline bool isReturn(u1 opcode) {
+    return opcode >= op_ireturn && opcode <= op_return;
+}
+
+
+/****************************************************************************
+ * SSAGraph
+ ****************************************************************************/
+SSAGraph::~SSAGraph() {
+    for (auto *node : nodes) {
+        delete node;
+    }
+    for (auto *block : allBlocks) {
+        delete block;
+    }
+}
+
+SSANode* SSAGraph::newNode(SSAOp op, u1 type, u4 pc) {
+    auto *node = new SSANode;
+    node->op = op;
+    node->type = type;
+    node->id = (u4)nodes.size();
+    node->pc = pc;
+    nodes.push_back(node);
+    return node;
+}
+
+SSABlock* SSAGraph::newBlock(u4 startPC) {
+    auto *block = new SSABlock;
+    block->id = (u4)allBlocks.size();
+    block->startPC = startPC;
+    allBlocks.push_back(block);
+    return block;
+}
+
+SSANode* SSAGraph::resolve(SSANode *node) {
+    while (node && node->replacement) {
+        node = node->replacement;
+    }
+    return node;
+}
+
+void SSAGraph::applyReplacements() {
+    for (auto *node : nodes) {
+        for (auto &input : node->inputs) {
+            input = resolve(input);
+        }
+    }
+    auto replaced = [](const SSANode *node) { return node->replacement != nullptr; };
+    for (auto *block : blocks) {
+        block->phis.erase(std::remove_if(block->phis.begin(), block->phis.end(), replaced), block->phis.end());
+        block->nodes.erase(std::remove_if(block->nodes.begin(), block->nodes.end(), replaced), block->nodes.end());
+    }
+}
+
+bool SSAGraph::dominates(const SSABlock *a, const SSABlock *b) const {
+    while (b) {
+        if (a == b) {
+            return true;
+        }
+        b = b->idom == b ? nullptr : b->idom;
+    }
+    return false;
+}
+
+static const char* typeName(u1 type) {
+    switch (type) {
+        case T_INT:
+            return "int";
+        case T_LONG:
+            return "long";
+        case T_FLOAT:
+            return "float";
+        case T_DOUBLE:
+            return "double";
+        default:
+            return "ref";
+    }
+}
+
+static void dumpNode(std::ostream &os, const SSANode *node) {
+    os << "    ";
+    if (node->type != T_EXTRA_VOID) {
+        os << "v" << node->id << " = ";
+    }
+    os << SSA_OP_NAMES[(int)node->op];
+    if (node->type != T_EXTRA_VOID) {
+        os << " " << typeName(node->type);
+    }
+    if (node->op == SSAOp::IF) {
+        os << " " << SSA_CONDITION_NAMES[node->aux];
+    } else if (node->op == SSAOp::CONSTANT || node->op == SSAOp::PARAM) {
+        os << " " << node->aux;
+    }
+    for (auto *input : node->inputs) {
+        os << " v" << input->id;
+    }
+    if (node->cpIndex != 0) {
+        os << " #" << node->cpIndex;
+    }
+    if (!node->nullCheck) {
+        os << " [no null check]";
+    }
+    if ((node->op == SSAOp::LOAD_INDEXED || node->op == SSAOp::STORE_INDEXED) && !node->rangeCheck) {
+        os << " [no range check]";
+    }
+    os << "\n";
+}
+
+void SSAGraph::dump(std::ostream &os) const {
+    os << jc->getClassName() << "." << jc->getString(method->nameIndex) << jc->getString(method->descriptorIndex)
+       << ", " << inlinedCalls << " calls inlined\n";
+    for (auto *block : blocks) {
+        os << "  B" << block->id << " [pc " << block->startPC << ", loop depth " << block->loopDepth << "] preds:";
+        for (auto *pred : block->preds) {
+            os << " B" << pred->id;
+        }
+        os << " succs:";
+        for (auto *succ : block->succs) {
+            os << " B" << succ->id;
+        }
+        os << "\n";
+        for (auto *phi : block->phis) {
+            dumpNode(os, phi);
+        }
+        for (auto *node : block->nodes) {
+            dumpNode(os, node);
+        }
+    }
+}
+
+
+/****************************************************************************
+ * SSABuilder
+ ****************************************************************************/
+/**
+ * 按逆后序遍历基本块，模拟执行字节码生成 SSA 节点
+ *
+ * 局部变量表和操作数栈的每个槽位记录当前的 SSA 值，long/double 的第二个槽为 nullptr
+ */
+class SSABuilder {
+public:
+    explicit SSABuilder(SSAGraph *graph) : graph(graph) {}
+
+    bool build();
+
+private:
+    // 一个方法的模拟执行状态，内联时为被调用方法新建一个
+    class Frame {
+    public:
+        JavaClass *jc;
+        MethodInfo *method;
+        ATTR_Code *code;
+        std::vector<SSANode*> locals;
+        std::vector<SSANode*> stack;
+        // 内联深度，最外层方法为 0
+        int depth = 0;
+        u4 callerPC = 0;
+        // 内联的方法执行到了 return
+        bool returned = false;
+        SSANode *returnValue = nullptr;
+    };
+
+    class State {
+    public:
+        bool processed = false;
+        std::vector<SSANode*> locals;
+        std::vector<SSANode*> stack;
+    };
+
+    bool computeBlocks();
+    bool scanSuccessors(SSABlock *block);
+    void orderBlocks();
+    bool processBlock(SSABlock *block);
+    bool fillPhis();
+    void removeTrivialPhis();
+
+    bool execute(Frame &f, u4 pc);
+    bool invoke(Frame &f, u4 pc, u1 opcode);
+    bool canInline(Frame &f, JavaClass *owner, MethodInfo *target, ATTR_Code *&targetCode);
+    bool accessField(Frame &f, u4 pc, u1 opcode);
+
+    SSANode* append(Frame &f, u4 pc, SSAOp op, u1 type, std::initializer_list<SSANode*> inputs = {});
+    SSANode* constant(Frame &f, u4 pc, u1 type, int64_t value);
+    SSANode* arithmetic(Frame &f, u4 pc, SSAOp op, u1 type, SSANode *x, SSANode *y);
+    void terminate(Frame &f, u4 pc, SSAOp op, std::initializer_list<SSANode*> inputs = {});
+
+    bool push(Frame &f, SSANode *value);
+    SSANode* pop(Frame &f);
+    bool load(Frame &f, u2 index, u1 type);
+    bool store(Frame &f, u2 index, SSANode *value);
+    bool dup(Frame &f, int n, int m);
+
+private:
+    SSAGraph *graph;
+    ATTR_Code *code = nullptr;
+    Frame root;
+    SSABlock *current = nullptr;
+    bool failed = false;
+
+    // 以 pc 索引，基本块入口处为对应的基本块
+    std::vector<SSABlock*> blockAt;
+    std::vector<SSABlock*> candidates;
+    // 以 SSABlock::id 索引，基本块执行完之后的状态
+    std::vector<State> exitStates;
+    std::vector<const MethodInfo*> inlineChain;
+};
+
+bool SSABuilder::build() {
+    code = static_cast<ATTR_Code*>(graph->jc->findAttribute(graph->method->attributes, graph->method->attributeCount,
+                                                             AttributeKind::Code));
+    if (!code || code->codeLength == 0 || code->exceptionTableLength > 0) {
+        return false;
+    }
+    if (!computeBlocks()) {
+        return false;
+    }
+    orderBlocks();
+    // 跳回方法入口的循环需要在入口之前再加一个基本块，javac 不会生成这样的代码
+    if (!graph->blocks[0]->preds.empty()) {
+        return false;
+    }
+
+    root.jc = graph->jc;
+    root.method = graph->method;
+    root.code = code;
+    inlineChain.push_back(graph->method);
+    exitStates.resize(candidates.size());
+    for (auto *block : graph->blocks) {
+        if (!processBlock(block)) {
+            return false;
+        }
+    }
+    if (!fillPhis()) {
+        return false;
+    }
+    removeTrivialPhis();
+    graph->applyReplacements();
+    return true;
+}
+
+bool SSABuilder::computeBlocks() {
+    const u4 codeLength = code->codeLength;
+    std::vector<bool> leaders(codeLength, false);
+    leaders[0] = true;
+    auto markTarget = [&](int64_t target) {
+        if (target < 0 || target >= codeLength) {
+            return false;
+        }
+        leaders[target] = true;
+        return true;
+    };
+
+    u4 pc = 0;
+    while (pc < codeLength) {
+        const u1 *bc = code->code + pc;
+        const u4 length = bytecodeLength(code->code, pc, codeLength);
+        if (length == 0 || bc[0] == op_jsr || bc[0] == op_jsr_w || bc[0] == op_ret) {
+            return false;
+        }
+        bool endsBlock = true;
+        if (isConditionalBranch(bc[0]) || bc[0] == op_goto) {
+            if (!markTarget((int64_t)pc + readBytecodeS2(bc + 1))) {
+                return false;
+            }
+        } else if (bc[0] == op_goto_w) {
+            if (!markTarget((int64_t)pc + readBytecodeS4(bc + 1))) {
+                return false;
+            }
+        } else if (bc[0] == op_tableswitch || bc[0] == op_lookupswitch) {
+            const u1 *p = code->code + ((pc + 4) & ~3u);
+            if (!markTarget((int64_t)pc + readBytecodeS4(p))) {
+                return false;
+            }
+            const bool table = bc[0] == op_tableswitch;
+            const int64_t count = table ? (int64_t)readBytecodeS4(p + 8) - readBytecodeS4(p + 4) + 1
+                                        : readBytecodeS4(p + 4);
+            for (int64_t i = 0; i < count; i++) {
+                const int32_t offset = table ? readBytecodeS4(p + 12 + i * 4) : readBytecodeS4(p + 12 + i * 8);
+                if (!markTarget((int64_t)pc + offset)) {
+                    return false;
+                }
+            }
+        } else if (!isReturn(bc[0]) && bc[0] != op_athrow) {
+            endsBlock = false;
+        }
+        if (endsBlock && pc + length < codeLength) {
+            leaders[pc + length] = true;
+        }
+        pc += length;
+    }
+
+    blockAt.assign(codeLength, nullptr);
+    for (u4 i = 0; i < codeLength; i++) {
+        if (leaders[i]) {
+            blockAt[i] = graph->newBlock(i);
+            candidates.push_back(blockAt[i]);
+        }
+    }
+    for (auto *block : candidates) {
+        if (!scanSuccessors(block)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SSABuilder::scanSuccessors(SSABlock *block) {
+    u4 pc = block->startPC;
+    while (true) {
+        const u1 *bc = code->code + pc;
+        const u4 length = bytecodeLength(code->code, pc, code->codeLength);
+        if (isConditionalBranch(bc[0])) {
+            block->succs.push_back(blockAt[pc + readBytecodeS2(bc + 1)]);
+            if (pc + length >= code->codeLength) {
+                return false;
+            }
+            block->succs.push_back(blockAt[pc + length]);
+            return true;
+        }
+        if (bc[0] == op_goto || bc[0] == op_goto_w) {
+            block->succs.push_back(blockAt[pc + (bc[0] == op_goto ? readBytecodeS2(bc + 1) : readBytecodeS4(bc + 1))]);
+            return true;
+        }
+        if (bc[0] == op_tableswitch || bc[0] == op_lookupswitch) {
+            const u1 *p = code->code + ((pc + 4) & ~3u);
+            const bool table = bc[0] == op_tableswitch;
+            const int64_t count = table ? (int64_t)readBytecodeS4(p + 8) - readBytecodeS4(p + 4) + 1
+                                        : readBytecodeS4(p + 4);
+            for (int64_t i = 0; i < count; i++) {
+                const int32_t offset = table ? readBytecodeS4(p + 12 + i * 4) : readBytecodeS4(p + 12 + i * 8);
+                block->succs.push_back(blockAt[pc + offset]);
+            }
+            block->succs.push_back(blockAt[pc + readBytecodeS4(p)]);
+            return true;
+        }
+        if (isReturn(bc[0]) || bc[0] == op_athrow) {
+            return true;
+        }
+        pc += length;
+        // 经过校验的代码不会执行到方法末尾之外
+        if (pc >= code->codeLength) {
+            return false;
+        }
+        if (blockAt[pc]) {
+            block->succs.push_back(blockAt[pc]);
+            return true;
+        }
+    }
+}
+
+void SSABuilder::orderBlocks() {
+    // 迭代的深度优先遍历，后序的逆序即为逆后序
+    std::vector<bool> visited(candidates.size(), false);
+    std::vector<std::pair<SSABlock*, std::size_t>> stack;
+    std::vector<SSABlock*> postorder;
+    stack.emplace_back(candidates[0], 0);
+    visited[candidates[0]->id] = true;
+    while (!stack.empty()) {
+        auto &top = stack.back();
+        if (top.second < top.first->succs.size()) {
+            SSABlock *succ = top.first->succs[top.second++];
+            if (!visited[succ->id]) {
+                visited[succ->id] = true;
+                stack.emplace_back(succ, 0);
+            }
+        } else {
+            postorder.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+    graph->blocks.assign(postorder.rbegin(), postorder.rend());
+    // 前驱只保留可达的基本块，同一个前驱经过两条边到达时记录两次，和 phi 的操作数一一对应
+    for (auto *block : graph->blocks) {
+        for (auto *succ : block->succs) {
+            succ->preds.push_back(block);
+        }
+    }
+}
+
+bool SSABuilder::processBlock(SSABlock *block) {
+    current = block;
+    if (block == graph->blocks[0]) {
+        root.locals.assign(code->maxLocals, nullptr);
+        root.stack.clear();
+        u2 slot = 0;
+        auto param = [&](u1 type) {
+            SSANode *node = graph->newNode(SSAOp::PARAM, type, 0);
+            node->aux = slot;
+            node->block = block;
+            block->nodes.push_back(node);
+            root.locals[slot] = node;
+            slot += isCategory2(type) ? 2 : 1;
+        };
+        if (slot + graph->method->signature.argSlots + (IS_METHOD_STATIC(graph->method->accessFlags) ? 0 : 1) >
+            code->maxLocals) {
+            return false;
+        }
+        if (!IS_METHOD_STATIC(graph->method->accessFlags)) {
+            param(T_EXTRA_OBJECT);
+        }
+        FOR_EACH(i, graph->method->signature.argCount) {
+            u1 type = graph->method->signature.argTypes[i];
+            param(type == T_EXTRA_ARRAY ? T_EXTRA_OBJECT : (isCategory2(type) || type == T_FLOAT) ? type :
+                  type == T_EXTRA_OBJECT ? T_EXTRA_OBJECT : T_INT);
+        }
+    } else {
+        // 逆后序保证至少有一个前驱已经处理过
+        const State *first = nullptr;
+        for (auto *pred : block->preds) {
+            if (exitStates[pred->id].processed) {
+                first = &exitStates[pred->id];
+                break;
+            }
+        }
+        if (!first) {
+            return false;
+        }
+        root.locals = first->locals;
+        root.stack = first->stack;
+        if (block->preds.size() > 1) {
+            // 汇合点(包括循环头)的每个有值的槽位都先建立 phi，操作数在所有基本块处理完之后填入
+            auto makePhi = [&](SSANode *&slot, int64_t index) {
+                if (!slot) {
+                    return;
+                }
+                SSANode *phi = graph->newNode(SSAOp::PHI, slot->type, block->startPC);
+                phi->aux = index;
+                phi->block = block;
+                block->phis.push_back(phi);
+                slot = phi;
+            };
+            FOR_EACH(i, root.locals.size()) {
+                makePhi(root.locals[i], (int64_t)i);
+            }
+            FOR_EACH(i, root.stack.size()) {
+                makePhi(root.stack[i], (int64_t)(code->maxLocals + i));
+            }
+        }
+    }
+
+    u4 pc = block->startPC;
+    while (true) {
+        const u4 length = bytecodeLength(code->code, pc, code->codeLength);
+        if (!execute(root, pc) || failed) {
+            return false;
+        }
+        if (!block->nodes.empty() && block->terminator()->isTerminator()) {
+            break;
+        }
+        pc += length;
+        if (blockAt[pc]) {
+            terminate(root, pc, SSAOp::GOTO);
+            break;
+        }
+    }
+
+    State &exit = exitStates[block->id];
+    exit.processed = true;
+    exit.locals = root.locals;
+    exit.stack = root.stack;
+    return true;
+}
+
+bool SSABuilder::fillPhis() {
+    std::vector<SSANode*> phis;
+    for (auto *block : graph->blocks) {
+        for (auto *phi : block->phis) {
+            for (auto *pred : block->preds) {
+                const State &state = exitStates[pred->id];
+                SSANode *input = nullptr;
+                if (phi->aux < code->maxLocals) {
+                    input = state.locals[phi->aux];
+                } else if ((std::size_t)(phi->aux - code->maxLocals) < state.stack.size()) {
+                    input = state.stack[phi->aux - code->maxLocals];
+                }
+                phi->inputs.push_back(input);
+            }
+            phis.push_back(phi);
+        }
+    }
+
+    // 有的前驱在该槽位上没有值或者类型不同时 phi 无效，使用了无效 phi 的 phi 也无效
+    std::vector<bool> dead(graph->nodes.size(), false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto *phi : phis) {
+            if (dead[phi->id]) {
+                continue;
+            }
+            for (auto *input : phi->inputs) {
+                if (!input || input->type != phi->type || dead[input->id]) {
+                    dead[phi->id] = true;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    // 经过校验的代码不会使用这样的槽位
+    for (auto *block : graph->blocks) {
+        for (auto *node : block->nodes) {
+            for (auto *input : node->inputs) {
+                if (dead[input->id]) {
+                    return false;
+                }
+            }
+        }
+        block->phis.erase(std::remove_if(block->phis.begin(), block->phis.end(),
+                                         [&](const SSANode *phi) { return dead[phi->id]; }), block->phis.end());
+    }
+    for (auto *block : graph->blocks) {
+        for (auto *phi : block->phis) {
+            for (auto *input : phi->inputs) {
+                if (dead[input->id]) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void SSABuilder::removeTrivialPhis() {
+    // 除了自身之外只有一个不同操作数的 phi 可以用该操作数替代
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto *block : graph->blocks) {
+            for (auto *phi : block->phis) {
+                if (phi->replacement) {
+                    continue;
+                }
+                SSANode *same = nullptr;
+                bool trivial = true;
+                for (auto *input : phi->inputs) {
+                    input = SSAGraph::resolve(input);
+                    if (input == phi || input == same) {
+                        continue;
+                    }
+                    if (same) {
+                        trivial = false;
+                        break;
+                    }
+                    same = input;
+                }
+                if (trivial && same) {
+                    phi->replacement = same;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+SSANode* SSABuilder::append(Frame &f, u4 pc, SSAOp op, u1 type, std::initializer_list<SSANode*> inputs) {
+    SSANode *node = graph->newNode(op, type, f.depth == 0 ? pc : f.callerPC);
+    node->inputs.assign(inputs.begin(), inputs.end());
+    node->block = current;
+    current->nodes.push_back(node);
+    return node;
+}
+
+SSANode* SSABuilder::constant(Frame &f, u4 pc, u1 type, int64_t value) {
+    SSANode *node = append(f, pc, SSAOp::CONSTANT, type);
+    node->aux = value;
+    return node;
+}
+
+void SSABuilder::terminate(Frame &f, u4 pc, SSAOp op, std::initializer_list<SSANode*> inputs) {
+    append(f, pc, op, T_EXTRA_VOID, inputs);
+}
+
+// 两个整数常量的运算，除数为 0 时不折叠
+static bool foldInteger(SSAOp op, u1 type, int64_t x, int64_t y, int64_t &result) {
+    if (type == T_INT) {
+        const auto a = (int32_t)x, b = (int32_t)y;
+        const auto ua = (uint32_t)a, ub = (uint32_t)b;
+        switch (op) {
+            case SSAOp::ADD: result = (int32_t)(ua + ub); return true;
+            case SSAOp::SUB: result = (int32_t)(ua - ub); return true;
+            case SSAOp::MUL: result = (int32_t)(ua * ub); return true;
+            case SSAOp::DIV:
+                if (b == 0) {
+                    return false;
+                }
+                result = (a == INT32_MIN && b == -1) ? a : a / b;
+                return true;
+            case SSAOp::REM:
+                if (b == 0) {
+                    return false;
+                }
+                result = (a == INT32_MIN && b == -1) ? 0 : a % b;
+                return true;
+            case SSAOp::SHL: result = (int32_t)(ua << (b & 31)); return true;
+            case SSAOp::SHR: result = a >> (b & 31); return true;
+            case SSAOp::USHR: result = (int32_t)(ua >> (b & 31)); return true;
+            case SSAOp::AND: result = a & b; return true;
+            case SSAOp::OR: result = a | b; return true;
+            case SSAOp::XOR: result = a ^ b; return true;
+            default: return false;
+        }
+    }
+    const auto ux = (uint64_t)x, uy = (uint64_t)y;
+    switch (op) {
+        case SSAOp::ADD: result = (int64_t)(ux + uy); return true;
+        case SSAOp::SUB: result = (int64_t)(ux - uy); return true;
+        case SSAOp::MUL: result = (int64_t)(ux * uy); return true;
+        case SSAOp::DIV:
+            if (y == 0) {
+                return false;
+            }
+            result = (x == INT64_MIN && y == -1) ? x : x / y;
+            return true;
+        case SSAOp::REM:
+            if (y == 0) {
+                return false;
+            }
+            result = (x == INT64_MIN && y == -1) ? 0 : x % y;
+            return true;
+        // long 的移位数是 int
+        case SSAOp::SHL: result = (int64_t)(ux << (y & 63)); return true;
+        case SSAOp::SHR: result = x >> (y & 63); return true;
+        case SSAOp::USHR: result = (int64_t)(ux >> (y & 63)); return true;
+        case SSAOp::AND: result = x & y; return true;
+        case SSAOp::OR: result = x | y; return true;
+        case SSAOp::XOR: result = x ^ y; return true;
+        default: return false;
+    }
+}
+
+SSANode* SSABuilder::arithmetic(Frame &f, u4 pc, SSAOp op, u1 type, SSANode *x, SSANode *y) {
+    if (type == T_INT || type == T_LONG) {
+        int64_t result;
+        if (x->isConstant() && y->isConstant() && foldInteger(op, type, x->aux, y->aux, result)) {
+            return constant(f, pc, type, result);
+        }
+        // x+0、x-0、x*1、x|0、x^0 和移位 0 位
+        if (y->isConstant()) {
+            const bool zeroIdentity = op == SSAOp::ADD || op == SSAOp::SUB || op == SSAOp::OR || op == SSAOp::XOR ||
+                                      op == SSAOp::SHL || op == SSAOp::SHR || op == SSAOp::USHR;
+            if ((zeroIdentity && y->aux == 0) || (op == SSAOp::MUL && y->aux == 1)) {
+                return x;
+            }
+        }
+    }
+    return append(f, pc, op, type, {x, y});
+}
+
+bool SSABuilder::push(Frame &f, SSANode *value) {
+    f.stack.push_back(value);
+    if (isCategory2(value->type)) {
+        f.stack.push_back(nullptr);
+    }
+    return f.stack.size() <= f.code->maxStack;
+}
+
+SSANode* SSABuilder::pop(Frame &f) {
+    if (f.stack.empty()) {
+        failed = true;
+        return nullptr;
+    }
+    SSANode *value = f.stack.back();
+    f.stack.pop_back();
+    if (!value && !f.stack.empty()) {
+        value = f.stack.back();
+        f.stack.pop_back();
+    }
+    if (!value) {
+        failed = true;
+    }
+    return value;
+}
+
+bool SSABuilder::load(Frame &f, u2 index, u1 type) {
+    if (index >= f.locals.size() || !f.locals[index] || f.locals[index]->type != type) {
+        return false;
+    }
+    return push(f, f.locals[index]);
+}
+
+bool SSABuilder::store(Frame &f, u2 index, SSANode *value) {
+    const std::size_t slots = isCategory2(value->type) ? 2 : 1;
+    if (index + slots > f.locals.size()) {
+        return false;
+    }
+    // 覆盖了 long/double 的第二个槽时前一个槽也失效
+    if (index > 0 && f.locals[index - 1] && isCategory2(f.locals[index - 1]->type)) {
+        f.locals[index - 1] = nullptr;
+    }
+    f.locals[index] = value;
+    if (slots == 2) {
+        f.locals[index + 1] = nullptr;
+    }
+    return true;
+}
+
+bool SSABuilder::dup(Frame &f, int n, int m) {
+    if (f.stack.size() < (std::size_t)(n + m) || f.stack.size() + n > f.code->maxStack) {
+        return false;
+    }
+    std::vector<SSANode*> top(f.stack.end() - n, f.stack.end());
+    f.stack.insert(f.stack.end() - n - m, top.begin(), top.end());
+    return true;
+}
+
+bool SSABuilder::accessField(Frame &f, u4 pc, u1 opcode) {
+    const u2 index = readBytecodeU2(f.code->code + pc + 1);
+    auto *ref = index < f.jc->raw.constPoolCount ? dynamic_cast<CONSTANT_FieldRef*>(f.jc->raw.constPoolInfo[index])
+                                                  : nullptr;
+    if (!ref) {
+        return false;
+    }
+    auto *nameAndType = dynamic_cast<CONSTANT_NameAndType*>(f.jc->raw.constPoolInfo[ref->nameAndTypeIndex]);
+    const u1 type = fieldType(f.jc->getString(nameAndType->descriptorIndex));
+
+    SSANode *node;
+    switch (opcode) {
+        case op_getstatic:
+            node = append(f, pc, SSAOp::GET_STATIC, type);
+            break;
+        case op_putstatic: {
+            SSANode *value = pop(f);
+            if (!value) {
+                return false;
+            }
+            node = append(f, pc, SSAOp::PUT_STATIC, T_EXTRA_VOID, {value});
+            break;
+        }
+        case op_getfield: {
+            SSANode *object = pop(f);
+            if (!object) {
+                return false;
+            }
+            node = append(f, pc, SSAOp::GET_FIELD, type, {object});
+            break;
+        }
+        default: {
+            SSANode *value = pop(f);
+            SSANode *object = pop(f);
+            if (!value || !object) {
+                return false;
+            }
+            node = append(f, pc, SSAOp::PUT_FIELD, T_EXTRA_VOID, {object, value});
+            break;
+        }
+    }
+    node->jc = f.jc;
+    node->cpIndex = index;
+    return node->type == T_EXTRA_VOID || push(f, node);
+}
+
+bool SSABuilder::canInline(Frame &f, JavaClass *owner, MethodInfo *target, ATTR_Code *&targetCode) {
+    if (f.depth + 1 > YVM_MAX_INLINE_DEPTH || IS_METHOD_SYNCHRONIZED(target->accessFlags) ||
+        std::find(inlineChain.cbegin(), inlineChain.cend(), target) != inlineChain.cend()) {
+        return false;
+    }
+    targetCode = static_cast<ATTR_Code*>(owner->findAttribute(target->attributes, target->attributeCount,
+                                                              AttributeKind::Code));
+    if (!targetCode || targetCode->codeLength > YVM_MAX_INLINE_SIZE || targetCode->exceptionTableLength > 0) {
+        return false;
+    }
+    // 只内联没有分支、最后一条指令是唯一的 return 的方法
+    u4 pc = 0;
+    while (pc < targetCode->codeLength) {
+        const u1 opcode = targetCode->code[pc];
+        const u4 length = bytecodeLength(targetCode->code, pc, targetCode->codeLength);
+        if (length == 0 || isConditionalBranch(opcode) || opcode == op_goto || opcode == op_goto_w ||
+            opcode == op_tableswitch || opcode == op_lookupswitch || opcode == op_athrow || opcode == op_jsr ||
+            opcode == op_jsr_w || opcode == op_ret || opcode == op_monitorenter || opcode == op_monitorexit) {
+            return false;
+        }
+        if (isReturn(opcode)) {
+            return pc + length == targetCode->codeLength;
+        }
+        pc += length;
+    }
+    return false;
+}
+
+bool SSABuilder::invoke(Frame &f, u4 pc, u1 opcode) {
+    const u2 index = readBytecodeU2(f.code->code + pc + 1);
+    if (index == 0 || index >= f.jc->raw.constPoolCount) {
+        return false;
+    }
+    ConstantPoolInfo *cp = f.jc->raw.constPoolInfo[index];
+    u2 nameAndTypeIndex;
+    if (auto *ref = dynamic_cast<CONSTANT_MethodRef*>(cp)) {
+        nameAndTypeIndex = ref->nameAndTypeIndex;
+    } else if (auto *interfaceRef = dynamic_cast<CONSTANT_InterfaceMethodRef*>(cp)) {
+        nameAndTypeIndex = interfaceRef->nameAndTypeIndex;
+    } else if (auto *indy = dynamic_cast<CONSTANT_InvokeDynamic*>(cp)) {
+        nameAndTypeIndex = indy->nameAndTypeIndex;
+    } else {
+        return false;
+    }
+    auto *nameAndType = dynamic_cast<CONSTANT_NameAndType*>(f.jc->raw.constPoolInfo[nameAndTypeIndex]);
+    MethodSignature signature;
+    if (!parseMethodSignature(f.jc->getString(nameAndType->descriptorIndex), signature)) {
+        return false;
+    }
+    const int receiver = opcode == op_invokestatic || opcode == op_invokedynamic ? 0 : 1;
+    const std::size_t argSlots = signature.argSlots + receiver;
+    if (f.stack.size() < argSlots) {
+        return false;
+    }
+
+    JavaClass *owner = nullptr;
+    MethodInfo *target = f.jc->findStaticTarget(opcode, index, owner);
+    ATTR_Code *targetCode = nullptr;
+    if (target && canInline(f, owner, target, targetCode)) {
+        Frame callee;
+        callee.jc = owner;
+        callee.method = target;
+        callee.code = targetCode;
+        callee.depth = f.depth + 1;
+        callee.callerPC = f.depth == 0 ? pc : f.callerPC;
+        callee.locals.assign(std::max<std::size_t>(targetCode->maxLocals, argSlots), nullptr);
+        // 实参在操作数栈上的排列和被调用方法的局部变量槽位一致
+        std::copy(f.stack.end() - argSlots, f.stack.end(), callee.locals.begin());
+        f.stack.resize(f.stack.size() - argSlots);
+        if (receiver) {
+            append(f, pc, SSAOp::NULL_CHECK, T_EXTRA_VOID, {callee.locals[0]});
+        }
+
+        inlineChain.push_back(target);
+        u4 calleePC = 0;
+        while (!callee.returned) {
+            const u4 length = bytecodeLength(targetCode->code, calleePC, targetCode->codeLength);
+            if (!execute(callee, calleePC) || failed) {
+                return false;
+            }
+            calleePC += length;
+        }
+        inlineChain.pop_back();
+        graph->inlinedCalls++;
+        return !callee.returnValue || push(f, callee.returnValue);
+    }
+
+    u1 returnType = signature.returnType;
+    if (returnType != T_EXTRA_VOID && returnType != T_EXTRA_OBJECT && returnType != T_LONG &&
+        returnType != T_FLOAT && returnType != T_DOUBLE) {
+        returnType = T_INT;
+    }
+    SSANode *node = append(f, pc, SSAOp::INVOKE, returnType);
+    node->aux = opcode;
+    node->jc = f.jc;
+    node->cpIndex = index;
+    for (auto it = f.stack.end() - argSlots; it != f.stack.end(); ++it) {
+        if (*it) {
+            node->inputs.push_back(*it);
+        }
+    }
+    f.stack.resize(f.stack.size() - argSlots);
+    return returnType == T_EXTRA_VOID || push(f, node);
+}
+
+bool SSABuilder::execute(Frame &f, u4 pc) {
+    const u1 *bc = f.code->code + pc;
+    const u1 opcode = bc[0];
+    SSANode *x, *y, *z;
+
+    switch (opcode) {
+        case op_nop:
+            return true;
+        case op_aconst_null:
+            return push(f, constant(f, pc, T_EXTRA_OBJECT, 0));
+        case op_iconst_m1:
+        case op_iconst_0:
+        case op_iconst_1:
+        case op_iconst_2:
+        case op_iconst_3:
+        case op_iconst_4:
+        case op_iconst_5:
+            return push(f, constant(f, pc, T_INT, opcode - op_iconst_0));
+        case op_lconst_0:
+        case op_lconst_1:
+            return push(f, constant(f, pc, T_LONG, opcode - op_lconst_0));
+        case op_fconst_0:
+        case op_fconst_1:
+        case op_fconst_2: {
+            const float value = (float)(opcode - op_fconst_0);
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return push(f, constant(f, pc, T_FLOAT, bits));
+        }
+        case op_dconst_0:
+        case op_dconst_1: {
+            const double value = (double)(opcode - op_dconst_0);
+            int64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return push(f, constant(f, pc, T_DOUBLE, bits));
+        }
+        case op_bipush:
+            return push(f, constant(f, pc, T_INT, (int8_t)bc[1]));
+        case op_sipush:
+            return push(f, constant(f, pc, T_INT, readBytecodeS2(bc + 1)));
+        case op_ldc:
+        case op_ldc_w:
+        case op_ldc2_w: {
+            const u2 index = opcode == op_ldc ? bc[1] : readBytecodeU2(bc + 1);
+            if (index == 0 || index >= f.jc->raw.constPoolCount) {
+                return false;
+            }
+            ConstantPoolInfo *cp = f.jc->raw.constPoolInfo[index];
+            if (auto *i = dynamic_cast<CONSTANT_Integer*>(cp)) {
+                return push(f, constant(f, pc, T_INT, i->val));
+            }
+            if (auto *l = dynamic_cast<CONSTANT_Long*>(cp)) {
+                return push(f, constant(f, pc, T_LONG, l->val));
+            }
+            // 浮点常量按位存放
+            if (auto *fl = dynamic_cast<CONSTANT_Float*>(cp)) {
+                uint32_t bits;
+                memcpy(&bits, &fl->val, sizeof(bits));
+                return push(f, constant(f, pc, T_FLOAT, bits));
+            }
+            if (auto *d = dynamic_cast<CONSTANT_Double*>(cp)) {
+                int64_t bits;
+                memcpy(&bits, &d->val, sizeof(bits));
+                return push(f, constant(f, pc, T_DOUBLE, bits));
+            }
+            // String、Class 等引用常量以常量池下标区分
+            x = constant(f, pc, T_EXTRA_OBJECT, 0);
+            x->jc = f.jc;
+            x->cpIndex = index;
+            return push(f, x);
+        }
+
+        case op_iload:
+            return load(f, bc[1], T_INT);
+        case op_lload:
+            return load(f, bc[1], T_LONG);
+        case op_fload:
+            return load(f, bc[1], T_FLOAT);
+        case op_dload:
+            return load(f, bc[1], T_DOUBLE);
+        case op_aload:
+            return load(f, bc[1], T_EXTRA_OBJECT);
+        case op_iload_0: case op_iload_1: case op_iload_2: case op_iload_3:
+            return load(f, (u2)(opcode - op_iload_0), T_INT);
+        case op_lload_0: case op_lload_1: case op_lload_2: case op_lload_3:
+            return load(f, (u2)(opcode - op_lload_0), T_LONG);
+        case op_fload_0: case op_fload_1: case op_fload_2: case op_fload_3:
+            return load(f, (u2)(opcode - op_fload_0), T_FLOAT);
+        case op_dload_0: case op_dload_1: case op_dload_2: case op_dload_3:
+            return load(f, (u2)(opcode - op_dload_0), T_DOUBLE);
+        case op_aload_0: case op_aload_1: case op_aload_2: case op_aload_3:
+            return load(f, (u2)(opcode - op_aload_0), T_EXTRA_OBJECT);
+
+        case op_iaload: case op_laload: case op_faload: case op_daload:
+        case op_aaload: case op_baload: case op_caload: case op_saload: {
+            static const u1 elementTypes[] = {T_INT, T_LONG, T_FLOAT, T_DOUBLE, T_EXTRA_OBJECT, T_BYTE, T_CHAR, T_SHORT};
+            static const u1 valueTypes[] = {T_INT, T_LONG, T_FLOAT, T_DOUBLE, T_EXTRA_OBJECT, T_INT, T_INT, T_INT};
+            y = pop(f);
+            x = pop(f);
+            if (!x || !y) {
+                return false;
+            }
+            z = append(f, pc, SSAOp::LOAD_INDEXED, valueTypes[opcode - op_iaload], {x, y});
+            z->aux = elementTypes[opcode - op_iaload];
+            return push(f, z);
+        }
+
+        case op_istore: case op_lstore: case op_fstore: case op_dstore: case op_astore:
+            x = pop(f);
+            return x && store(f, bc[1], x);
+        case op_istore_0: case op_istore_1: case op_istore_2: case op_istore_3:
+        case op_lstore_0: case op_lstore_1: case op_lstore_2: case op_lstore_3:
+        case op_fstore_0: case op_fstore_1: case op_fstore_2: case op_fstore_3:
+        case op_dstore_0: case op_dstore_1: case op_dstore_2: case op_dstore_3:
+        case op_astore_0: case op_astore_1: case op_astore_2: case op_astore_3:
+            x = pop(f);
+            return x && store(f, (u2)((opcode - op_istore_0) % 4), x);
+
+        case op_iastore: case op_lastore: case op_fastore: case op_dastore:
+        case op_aastore: case op_bastore: case op_castore: case op_sastore: {
+            static const u1 elementTypes[] = {T_INT, T_LONG, T_FLOAT, T_DOUBLE, T_EXTRA_OBJECT, T_BYTE, T_CHAR, T_SHORT};
+            z = pop(f);
+            y = pop(f);
+            x = pop(f);
+            if (!x || !y || !z) {
+                return false;
+            }
+            append(f, pc, SSAOp::STORE_INDEXED, T_EXTRA_VOID, {x, y, z})->aux = elementTypes[opcode - op_iastore];
+            return true;
+        }
+
+        case op_pop:
+        case op_pop2: {
+            const std::size_t slots = opcode == op_pop ? 1 : 2;
+            if (f.stack.size() < slots) {
+                return false;
+            }
+            f.stack.resize(f.stack.size() - slots);
+            return true;
+        }
+        case op_dup:
+            return dup(f, 1, 0);
+        case op_dup_x1:
+            return dup(f, 1, 1);
+        case op_dup_x2:
+            return dup(f, 1, 2);
+        case op_dup2:
+            return dup(f, 2, 0);
+        case op_dup2_x1:
+            return dup(f, 2, 1);
+        case op_dup2_x2:
+            return dup(f, 2, 2);
+        case op_swap:
+            if (f.stack.size() < 2) {
+                return false;
+            }
+            std::swap(f.stack[f.stack.size() - 1], f.stack[f.stack.size() - 2]);
+            return true;
+
+        case op_iadd: case op_ladd: case op_fadd: case op_dadd:
+        case op_isub: case op_lsub: case op_fsub: case op_dsub:
+        case op_imul: case op_lmul: case op_fmul: case op_dmul:
+        case op_idiv: case op_ldiv: case op_fdiv: case op_ddiv:
+        case op_irem: case op_lrem: case op_frem: case op_drem: {
+            static const SSAOp ops[] = {SSAOp::ADD, SSAOp::SUB, SSAOp::MUL, SSAOp::DIV, SSAOp::REM};
+            static const u1 types[] = {T_INT, T_LONG, T_FLOAT, T_DOUBLE};
+            y = pop(f);
+            x = pop(f);
+            return x && y && push(f, arithmetic(f, pc, ops[(opcode - op_iadd) / 4], types[(opcode - op_iadd) % 4],
+                                                x, y));
+        }
+        case op_ineg: case op_lneg: case op_fneg: case op_dneg: {
+            static const u1 types[] = {T_INT, T_LONG, T_FLOAT, T_DOUBLE};
+            x = pop(f);
+            return x && push(f, append(f, pc, SSAOp::NEG, types[opcode - op_ineg], {x}));
+        }
+        case op_ishl: case op_lshl: case op_ishr: case op_lshr: case op_iushr: case op_lushr: {
+            static const SSAOp ops[] = {SSAOp::SHL, SSAOp::SHR, SSAOp::USHR};
+            y = pop(f);
+            x = pop(f);
+            return x && y && push(f, arithmetic(f, pc, ops[(opcode - op_ishl) / 2],
+                                                (opcode - op_ishl) % 2 ? T_LONG : T_INT, x, y));
+        }
+        case op_iand: case op_land: case op_ior: case op_lor: case op_ixor: case op_lxor: {
+            static const SSAOp ops[] = {SSAOp::AND, SSAOp::OR, SSAOp::XOR};
+            y = pop(f);
+            x = pop(f);
+            return x && y && push(f, arithmetic(f, pc, ops[(opcode - op_iand) / 2],
+                                                (opcode - op_iand) % 2 ? T_LONG : T_INT, x, y));
+        }
+        case op_iinc: {
+            if (bc[1] >= f.locals.size() || !f.locals[bc[1]] || f.locals[bc[1]]->type != T_INT) {
+                return false;
+            }
+            y = constant(f, pc, T_INT, (int8_t)bc[2]);
+            return store(f, bc[1], arithmetic(f, pc, SSAOp::ADD, T_INT, f.locals[bc[1]], y));
+        }
+
+        case op_i2l: case op_i2f: case op_i2d: case op_l2i: case op_l2f: case op_l2d:
+        case op_f2i: case op_f2l: case op_f2d: case op_d2i: case op_d2l: case op_d2f:
+        case op_i2b: case op_i2c: case op_i2s: {
+            static const u1 types[] = {T_LONG, T_FLOAT, T_DOUBLE, T_INT, T_FLOAT, T_DOUBLE,
+                                       T_INT, T_LONG, T_DOUBLE, T_INT, T_LONG, T_FLOAT, T_INT, T_INT, T_INT};
+            x = pop(f);
+            if (!x) {
+                return false;
+            }
+            y = append(f, pc, SSAOp::CONVERT, types[opcode - op_i2l], {x});
+            y->aux = opcode;
+            return push(f, y);
+        }
+        case op_lcmp: case op_fcmpl: case op_fcmpg: case op_dcmpl: case op_dcmpg:
+            y = pop(f);
+            x = pop(f);
+            if (!x || !y) {
+                return false;
+            }
+            z = append(f, pc, SSAOp::COMPARE, T_INT, {x, y});
+            z->aux = opcode;
+            return push(f, z);
+
+        case op_ifeq: case op_ifne: case op_iflt: case op_ifge: case op_ifgt: case op_ifle:
+            x = pop(f);
+            if (!x) {
+                return false;
+            }
+            terminate(f, pc, SSAOp::IF, {x, constant(f, pc, T_INT, 0)});
+            current->terminator()->aux = opcode - op_ifeq;
+            return true;
+        case op_if_icmpeq: case op_if_icmpne: case op_if_icmplt: case op_if_icmpge: case op_if_icmpgt:
+        case op_if_icmple: case op_if_acmpeq: case op_if_acmpne:
+            y = pop(f);
+            x = pop(f);
+            if (!x || !y) {
+                return false;
+            }
+            terminate(f, pc, SSAOp::IF, {x, y});
+            current->terminator()->aux = opcode <= op_if_icmple ? opcode - op_if_icmpeq : opcode - op_if_acmpeq;
+            return true;
+        case op_ifnull:
+        case op_ifnonnull:
+            x = pop(f);
+            if (!x) {
+                return false;
+            }
+            terminate(f, pc, SSAOp::IF, {x, constant(f, pc, T_EXTRA_OBJECT, 0)});
+            current->terminator()->aux = (int64_t)(opcode == op_ifnull ? SSACondition::EQ : SSACondition::NE);
+            return true;
+        case op_goto:
+        case op_goto_w:
+            terminate(f, pc, SSAOp::GOTO);
+            return true;
+        case op_tableswitch:
+        case op_lookupswitch: {
+            x = pop(f);
+            if (!x) {
+                return false;
+            }
+            terminate(f, pc, SSAOp::SWITCH, {x});
+            const u1 *p = f.code->code + ((pc + 4) & ~3u);
+            auto &keys = current->terminator()->keys;
+            if (opcode == op_tableswitch) {
+                const int32_t low = readBytecodeS4(p + 4);
+                const int32_t high = readBytecodeS4(p + 8);
+                for (int64_t key = low; key <= high; key++) {
+                    keys.push_back((int32_t)key);
+                }
+            } else {
+                const int32_t npairs = readBytecodeS4(p + 4);
+                for (int32_t i = 0; i < npairs; i++) {
+                    keys.push_back(readBytecodeS4(p + 8 + (int64_t)i * 8));
+                }
+            }
+            return true;
+        }
+
+        case op_ireturn: case op_lreturn: case op_freturn: case op_dreturn: case op_areturn:
+        case op_return:
+            x = opcode == op_return ? nullptr : pop(f);
+            if (opcode != op_return && !x) {
+                return false;
+            }
+            if (f.depth > 0) {
+                f.returned = true;
+                f.returnValue = x;
+            } else if (x) {
+                terminate(f, pc, SSAOp::RETURN, {x});
+            } else {
+                terminate(f, pc, SSAOp::RETURN);
+            }
+            return true;
+
+        case op_getstatic:
+        case op_putstatic:
+        case op_getfield:
+        case op_putfield:
+            return accessField(f, pc, opcode);
+        case op_invokevirtual:
+        case op_invokespecial:
+        case op_invokestatic:
+        case op_invokeinterface:
+        case op_invokedynamic:
+            return invoke(f, pc, opcode);
+
+        case op_new:
+            x = append(f, pc, SSAOp::NEW, T_EXTRA_OBJECT);
+            x->jc = f.jc;
+            x->cpIndex = readBytecodeU2(bc + 1);
+            return push(f, x);
+        case op_newarray:
+        case op_anewarray:
+            y = pop(f);
+            if (!y) {
+                return false;
+            }
+            x = append(f, pc, SSAOp::NEW_ARRAY, T_EXTRA_OBJECT, {y});
+            if (opcode == op_newarray) {
+                x->aux = bc[1];
+            } else {
+                x->aux = T_EXTRA_OBJECT;
+                x->jc = f.jc;
+                x->cpIndex = readBytecodeU2(bc + 1);
+            }
+            return push(f, x);
+        case op_multianewarray: {
+            if (f.stack.size() < bc[3]) {
+                return false;
+            }
+            x = append(f, pc, SSAOp::NEW_ARRAY, T_EXTRA_OBJECT);
+            x->inputs.assign(f.stack.end() - bc[3], f.stack.end());
+            f.stack.resize(f.stack.size() - bc[3]);
+            x->aux = T_EXTRA_ARRAY;
+            x->jc = f.jc;
+            x->cpIndex = readBytecodeU2(bc + 1);
+            return push(f, x);
+        }
+        case op_arraylength:
+            x = pop(f);
+            return x && push(f, append(f, pc, SSAOp::ARRAY_LENGTH, T_INT, {x}));
+        case op_athrow:
+            x = pop(f);
+            if (!x) {
+                return false;
+            }
+            terminate(f, pc, SSAOp::THROW, {x});
+            return true;
+        case op_checkcast:
+        case op_instanceof:
+            x = pop(f);
+            if (!x) {
+                return false;
+            }
+            y = append(f, pc, opcode == op_checkcast ? SSAOp::CHECK_CAST : SSAOp::INSTANCE_OF,
+                       opcode == op_checkcast ? T_EXTRA_OBJECT : T_INT, {x});
+            y->jc = f.jc;
+            y->cpIndex = readBytecodeU2(bc + 1);
+            return push(f, y);
+        case op_monitorenter:
+        case op_monitorexit:
+            x = pop(f);
+            if (!x) {
+                return false;
+            }
+            append(f, pc, opcode == op_monitorenter ? SSAOp::MONITOR_ENTER : SSAOp::MONITOR_EXIT, T_EXTRA_VOID, {x});
+            return true;
+
+        case op_wide: {
+            const u2 index = readBytecodeU2(bc + 2);
+            switch (bc[1]) {
+                case op_iload:
+                    return load(f, index, T_INT);
+                case op_lload:
+                    return load(f, index, T_LONG);
+                case op_fload:
+                    return load(f, index, T_FLOAT);
+                case op_dload:
+                    return load(f, index, T_DOUBLE);
+                case op_aload:
+                    return load(f, index, T_EXTRA_OBJECT);
+                case op_istore:
+                case op_lstore:
+                case op_fstore:
+                case op_dstore:
+                case op_astore:
+                    x = pop(f);
+                    return x && store(f, index, x);
+                case op_iinc:
+                    if (index >= f.locals.size() || !f.locals[index] || f.locals[index]->type != T_INT) {
+                        return false;
+                    }
+                    y = constant(f, pc, T_INT, readBytecodeS2(bc + 4));
+                    return store(f, index, arithmetic(f, pc, SSAOp::ADD, T_INT, f.locals[index], y));
+                default:
+                    return false;
+            }
+        }
+
+        default:
+            return false;
+    }
+}
+
+SSAGraph* SSAGraph::build(JavaClass *jc, MethodInfo *method) {
+    auto *graph = new SSAGraph;
+    graph->jc = jc;
+    graph->method = method;
+    if (!SSABuilder(graph).build()) {
+        delete graph;
+        return nullptr;
+    }
+    return graph;
+}
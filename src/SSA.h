@@ -0,0 +1,172 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_SSA_H
+#define CJVM_SSA_H
+
+#include <vector>
+#include <ostream>
+#include "Type.h"
+
+class JavaClass;
+class MethodInfo;
+class SSABlock;
+
+enum class SSAOp : u1 {
+    PARAM,
+    CONSTANT,
+    PHI,
+
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    REM,
+    NEG,
+    SHL,
+    SHR,
+    USHR,
+    AND,
+    OR,
+    XOR,
+    // 基本类型之间的转换，type 为目标类型
+    CONVERT,
+    // lcmp、fcmpl、fcmpg、dcmpl、dcmpg
+    COMPARE,
+
+    ARRAY_LENGTH,
+    LOAD_INDEXED,
+    STORE_INDEXED,
+    GET_FIELD,
+    PUT_FIELD,
+    GET_STATIC,
+    PUT_STATIC,
+    NEW,
+    NEW_ARRAY,
+    CHECK_CAST,
+    INSTANCE_OF,
+    NULL_CHECK,
+    INVOKE,
+    MONITOR_ENTER,
+    MONITOR_EXIT,
+
+    // 以下为基本块的最后一条指令
+    IF,
+    GOTO,
+    SWITCH,
+    RETURN,
+    THROW
+};
+
+enum class SSACondition : u1 {
+    EQ,
+    NE,
+    LT,
+    GE,
+    GT,
+    LE
+};
+
+/**
+ * SSA 形式的一个值或者一条语句
+ *
+ * type:    T_INT、T_LONG、T_FLOAT、T_DOUBLE、T_EXTRA_OBJECT，不产生值的语句为 T_EXTRA_VOID
+ * pc:      对应的字节码位置，内联进来的指令记为调用点的位置
+ * aux:     随 op 而定：
+ *          CONSTANT 为常量值(浮点数按位存放)，PARAM 为局部变量槽位，PHI 为构建时对应的槽位，
+ *          IF 为 SSACondition，CONVERT/COMPARE/INVOKE 为原字节码的操作码，
+ *          数组指令为元素类型(T_INT 等，引用为 T_EXTRA_OBJECT)，NEW/NEW_ARRAY/CHECK_CAST/INSTANCE_OF 为常量池下标
+ * cpIndex: 字段、方法和类的常量池下标，属于 jc，内联之后可能与方法所在的类不同
+ */
+class SSANode {
+public:
+    SSAOp op;
+    u1 type;
+    u4 id;
+    u4 pc;
+    int64_t aux = 0;
+    u2 cpIndex = 0;
+    JavaClass *jc = nullptr;
+    std::vector<SSANode*> inputs;
+    SSABlock *block = nullptr;
+
+    // SWITCH 各个分支的 key，和所在基本块的 succs 一一对应，最后一个后继为 default
+    std::vector<int32_t> keys;
+    // 解引用 inputs[0] 的节点是否还需要检查 null
+    bool nullCheck = true;
+    // LOAD_INDEXED/STORE_INDEXED 是否还需要检查下标越界
+    bool rangeCheck = true;
+    // 被消除时指向替代它的节点
+    SSANode *replacement = nullptr;
+
+    bool isConstant() const { return op == SSAOp::CONSTANT; }
+    bool isTerminator() const { return op >= SSAOp::IF; }
+};
+
+/**
+ * 基本块，nodes 的最后一个节点为跳转、返回或者抛出异常
+ *
+ * IF 的 succs[0] 为条件成立时的目标，succs[1] 为顺序执行的下一个基本块
+ */
+class SSABlock {
+public:
+    u4 id;
+    u4 startPC;
+    std::vector<SSABlock*> preds;
+    std::vector<SSABlock*> succs;
+    std::vector<SSANode*> phis;
+    std::vector<SSANode*> nodes;
+
+    // 以下由 Optimizer 计算
+    SSABlock *idom = nullptr;
+    std::vector<SSABlock*> dominated;
+    u4 loopDepth = 0;
+
+    SSANode* terminator() const { return nodes.back(); }
+};
+
+/**
+ * 方法的 SSA 形式的中间表示，优化编译的输入
+ *
+ * 由字节码一次遍历构建：在汇合点为每个局部变量和操作数栈槽位预先建立 phi，
+ * 所有基本块都处理完之后再填入 phi 的操作数，最后删除所有操作数都相同的 phi。
+ * 静态绑定、没有分支的小方法(getter/setter、简单的构造函数等)在构建时直接内联。
+ *
+ * 带异常处理器的方法和使用 jsr/ret 的方法暂不编译。
+ * 目前还没有代码生成、寄存器分配和分层编译的策略，只有基准测试构建和优化它
+ */
+class SSAGraph {
+public:
+    ~SSAGraph();
+
+    // 无法编译时返回 nullptr
+    static SSAGraph* build(JavaClass *jc, MethodInfo *method);
+
+    SSANode* newNode(SSAOp op, u1 type, u4 pc);
+    SSABlock* newBlock(u4 startPC);
+
+    // 返回节点最终的替代节点
+    static SSANode* resolve(SSANode *node);
+    // 让所有节点的输入指向最终的替代节点，并从基本块中删除被替代的节点
+    void applyReplacements();
+
+    bool dominates(const SSABlock *a, const SSABlock *b) const;
+
+    void dump(std::ostream &os) const;
+
+public:
+    JavaClass *jc = nullptr;
+    MethodInfo *method = nullptr;
+    // 按逆后序排列，blocks[0] 为入口
+    std::vector<SSABlock*> blocks;
+    std::vector<SSANode*> nodes;
+    // 构建时内联的调用个数
+    u4 inlinedCalls = 0;
+
+private:
+    std::vector<SSABlock*> allBlocks;
+};
+
+
+#endif //CJVM_SSA_H
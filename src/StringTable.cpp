@@ -0,0 +1,90 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include "StringTable.h"
+#include "JavaString.h"
+#include "JavaThread.h"
+#include "RuntimeEnv.h"
+#include "NativeMethod.h"
+
+std::size_t StringTable::intern(ThreadLocalAllocBuffer &tlab, const u1 *bytes, std::size_t length,
+                                const JavaClass *stringClass) {
+    std::string key(reinterpret_cast<const char*>(bytes), length);
+    Stripe &stripe = stripeOf(key);
+
+    std::lock_guard<std::mutex> lock(stripe.mtx);
+    auto pos = stripe.table.find(key);
+    if (pos != stripe.table.end()) {
+        return pos->second;
+    }
+
+    std::size_t str = JavaString::create(heap, tlab, bytes, length, stringClass);
+    if (str != 0) {
+        // 字符串表中的字符串所有线程都能拿到
+        heap->publish(str);
+        stripe.table.emplace(std::move(key), str);
+    }
+    return str;
+}
+
+std::size_t StringTable::intern(std::size_t str) {
+    std::string key = JavaString::toModifiedUtf8(heap, str);
+    Stripe &stripe = stripeOf(key);
+
+    std::lock_guard<std::mutex> lock(stripe.mtx);
+    auto result = stripe.table.emplace(std::move(key), str);
+    if (result.second) {
+        heap->publish(str);
+    }
+    return result.first->second;
+}
+
+void StringTable::unlink(const std::function<bool(std::size_t)> &isAlive) {
+    for (auto &stripe : stripes) {
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        for (auto it = stripe.table.begin(); it != stripe.table.end();) {
+            if (!isAlive(it->second)) {
+                it = stripe.table.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void StringTable::forEach(const std::function<void(std::size_t&)> &func) {
+    for (auto &stripe : stripes) {
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        for (auto &x : stripe.table) {
+            func(x.second);
+        }
+    }
+}
+
+std::size_t StringTable::size() {
+    std::size_t n = 0;
+    for (auto &stripe : stripes) {
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        n += stripe.table.size();
+    }
+    return n;
+}
+
+
+/****************************************************************************
+ * java.lang.String natives
+ ****************************************************************************/
+static jobject java_lang_String_intern(RuntimeEnv *env, jobject self) {
+    JObject *str = dynamic_cast<JObject*>(self);
+    currentThread->localObject.offset = env->stringTable->intern(str->offset);
+    currentThread->localObject.jc = str->jc;
+    return &currentThread->localObject;
+}
+
+void registerStringNatives(RuntimeEnv *env) {
+    static const JNINativeMethod methods[] = {
+            makeNativeMethod("intern", "()Ljava/lang/String;", java_lang_String_intern),
+    };
+    env->natives.registerNatives("java/lang/String", methods, sizeof(methods) / sizeof(methods[0]));
+}
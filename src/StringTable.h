@@ -0,0 +1,68 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_STRINGTABLE_H
+#define CJVM_STRINGTABLE_H
+
+#include <string>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+#include "Type.h"
+
+class JavaHeap;
+class JavaClass;
+class ThreadLocalAllocBuffer;
+class RuntimeEnv;
+
+/**
+ * 全局字符串常量池，所有类共享，内容相同的字符串字面量只对应一个堆上的 String
+ *
+ * 以 modified UTF-8 的字节序列为键，按哈希值分成若干段，每段一把锁，不同段之间互不影响。
+ * 表中的引用是弱引用：GC 标记结束后通过 unlink 清除已经死亡的字符串。
+ * ldc 解析过的字面量缓存在各个类的常量池缓存中，这些槽位是强根(MethodArea::forEachStringRoot)，
+ * 所以仍被常量池引用的字面量不会从表中清除
+ */
+class StringTable {
+public:
+    explicit StringTable(JavaHeap *heap) : heap(heap) {}
+
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+
+    // 返回驻留的 String 在堆上的偏移量，返回 0 表示编码非法或空间不足
+    std::size_t intern(ThreadLocalAllocBuffer &tlab, const u1 *bytes, std::size_t length,
+                       const JavaClass *stringClass);
+
+    // String.intern()：表中已有相同内容时返回表中的字符串，否则驻留 str 本身
+    std::size_t intern(std::size_t str);
+
+    // GC 在标记之后调用，移除 isAlive 返回 false 的项
+    void unlink(const std::function<bool(std::size_t)> &isAlive);
+    // 枚举所有驻留的字符串，GC 移动对象后可以直接修改偏移量
+    void forEach(const std::function<void(std::size_t&)> &func);
+
+    std::size_t size();
+
+private:
+    static const int STRIPES = 64;
+
+    class Stripe {
+    public:
+        std::mutex mtx;
+        std::unordered_map<std::string, std::size_t> table;
+    };
+
+    inline Stripe& stripeOf(const std::string &key) {
+        // 低位留给段内的哈希表使用
+        return stripes[(std::hash<std::string>()(key) >> 7) % STRIPES];
+    }
+
+    JavaHeap *heap;
+    Stripe stripes[STRIPES];
+};
+
+void registerStringNatives(RuntimeEnv *env);
+
+#endif //CJVM_STRINGTABLE_H
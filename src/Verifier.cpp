@@ -0,0 +1,1262 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <iostream>
+#include <cstring>
+#include "Verifier.h"
+#include "JavaClass.h"
+#include "AccessFlag.h"
+#include "Bytecode.h"
+#include "RuntimeEnv.h"
+
+// 基本类型数组元素在操作数栈上的类型，byte/char/short/boolean 都按 int 处理
+static u1 primitiveTag(char component) {
+    switch (component) {
+        case 'J':
+            return ITEM_Long;
+        case 'F':
+            return ITEM_Float;
+        case 'D':
+            return ITEM_Double;
+        default:
+            return ITEM_Integer;
+    }
+}
+
+Verifier::Verifier(JavaClass *jc) : jc(jc) {
+    thisName = intern(jc->getClassName());
+    objectName = intern("java/lang/Object");
+}
+
+bool Verifier::verify() {
+    // 50 之前的 class 文件没有 StackMapTable，需要类型推导校验，没有实现，不能让它们不经校验就通过。
+    // 目前解析 class 文件时已经拒绝了这些版本
+    if (jc->raw.majorVersion < JAVA_6_MAJOR) {
+        std::cerr << __func__ << ":Can not verify " << thisName << " of class file version " << jc->raw.majorVersion
+                  << ", type inference verification is not supported\n";
+        return false;
+    }
+
+    FOR_EACH(i, jc->raw.methodsCount) {
+        MethodInfo *m = &jc->raw.methods[i];
+        if (!verifyMethod(m)) {
+            std::cerr << __func__ << ":Verification failed in " << thisName << "." << jc->getString(m->nameIndex)
+                      << jc->getString(m->descriptorIndex) << " at pc " << errorPC << ": " << error << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Verifier::fail(const char *reason) {
+    error = reason;
+    return false;
+}
+
+Verifier::VType Verifier::makeType(u1 tag, const char *name, u2 offset) {
+    VType t;
+    t.tag = tag;
+    t.offset = offset;
+    t.name = name;
+    return t;
+}
+
+bool Verifier::isCategory2(const VType &t) {
+    return t.tag == ITEM_Long || t.tag == ITEM_Double;
+}
+
+const char* Verifier::intern(const std::string &name) {
+    // unordered_set 的节点在 rehash 时不会移动，返回的指针一直有效
+    return names.insert(name).first->c_str();
+}
+
+const char* Verifier::className(u2 cpIndex) {
+    if (cpIndex == 0 || cpIndex >= jc->raw.constPoolCount) {
+        return nullptr;
+    }
+    auto *c = dynamic_cast<CONSTANT_Class*>(jc->raw.constPoolInfo[cpIndex]);
+    return c ? intern(jc->getString(c->nameIndex)) : nullptr;
+}
+
+bool Verifier::parseFieldType(const char *&descriptor, VType &t) {
+    const char *start = descriptor;
+    while (*descriptor == '[') {
+        descriptor++;
+    }
+    const bool isArray = descriptor != start;
+
+    switch (*descriptor) {
+        case 'B':
+        case 'C':
+        case 'I':
+        case 'S':
+        case 'Z':
+            t = makeType(ITEM_Integer);
+            break;
+        case 'F':
+            t = makeType(ITEM_Float);
+            break;
+        case 'J':
+            t = makeType(ITEM_Long);
+            break;
+        case 'D':
+            t = makeType(ITEM_Double);
+            break;
+        case 'L': {
+            const char *end = strchr(descriptor, ';');
+            if (!end || end == descriptor + 1) {
+                return false;
+            }
+            t = makeType(ITEM_Object, intern(std::string(descriptor + 1, end)));
+            descriptor = end;
+            break;
+        }
+        default:
+            return false;
+    }
+    descriptor++;
+
+    if (isArray) {
+        t = makeType(ITEM_Object, intern(std::string(start, descriptor)));
+    }
+    return true;
+}
+
+JavaClass* Verifier::loadClass(const char *name) {
+    if (name == thisName) {
+        return jc;
+    }
+    return crt.ma ? crt.ma->loadClassIfAbsent(name) : nullptr;
+}
+
+bool Verifier::isSubclass(const char *from, const char *to) {
+    JavaClass *target = loadClass(to);
+    if (!target) {
+        return false;
+    }
+    // 和规范一样，接口类型当作 Object 处理，实际类型在 invokeinterface/checkcast 时检查
+    if (IS_CLASS_INTERFACE(target->raw.accessFlags)) {
+        return true;
+    }
+
+    const char *name = from;
+    while (name) {
+        if (strcmp(name, to) == 0) {
+            return true;
+        }
+        JavaClass *c = strcmp(name, thisName) == 0 ? jc : loadClass(intern(name));
+        if (!c) {
+            return false;
+        }
+        name = c->getSuperClassName();
+    }
+    return false;
+}
+
+bool Verifier::isReferenceAssignable(const char *from, const char *to) {
+    if (from == to || to == objectName) {
+        return true;
+    }
+
+    if (to[0] == '[') {
+        if (from[0] != '[') {
+            return false;
+        }
+        const char *fromComponent = from + 1;
+        const char *toComponent = to + 1;
+        const bool fromReference = fromComponent[0] == 'L' || fromComponent[0] == '[';
+        const bool toReference = toComponent[0] == 'L' || toComponent[0] == '[';
+        if (!fromReference || !toReference) {
+            return strcmp(fromComponent, toComponent) == 0;
+        }
+        // 引用数组是协变的，比较元素类型
+        VType f, t;
+        if (!parseFieldType(fromComponent, f) || !parseFieldType(toComponent, t)) {
+            return false;
+        }
+        return isReferenceAssignable(f.name, t.name);
+    }
+
+    if (from[0] == '[') {
+        return strcmp(to, "java/lang/Cloneable") == 0 || strcmp(to, "java/io/Serializable") == 0;
+    }
+    return isSubclass(from, to);
+}
+
+bool Verifier::isAssignable(const VType &from, const VType &to) {
+    switch (to.tag) {
+        case ITEM_Top:
+            return true;
+        case ITEM_Object:
+            return from.tag == ITEM_Null || (from.tag == ITEM_Object && isReferenceAssignable(from.name, to.name));
+        case ITEM_Uninitialized:
+            return from.tag == ITEM_Uninitialized && from.offset == to.offset;
+        default:
+            return from.tag == to.tag;
+    }
+}
+
+bool Verifier::isFrameAssignable(const VFrame &from, const VFrame &to) {
+    if (from.stack.size() != to.stack.size() || (from.flagThisUninit && !to.flagThisUninit)) {
+        return false;
+    }
+    FOR_EACH(i, from.locals.size()) {
+        if (!isAssignable(from.locals[i], to.locals[i])) {
+            return false;
+        }
+    }
+    FOR_EACH(i, from.stack.size()) {
+        if (!isAssignable(from.stack[i], to.stack[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool Verifier::verifyMethod(MethodInfo *m) {
+    method = m;
+    errorPC = 0;
+    code = static_cast<ATTR_Code*>(jc->findAttribute(m->attributes, m->attributeCount, AttributeKind::Code));
+    if (!code) {
+        if (IS_METHOD_NATIVE(m->accessFlags) || IS_METHOD_ABSTRACT(m->accessFlags)) {
+            return true;
+        }
+        return fail("missing Code attribute");
+    }
+    if (code->codeLength == 0 || code->codeLength >= 65536) {
+        return fail("invalid code length");
+    }
+
+    const char *methodName = jc->getString(m->nameIndex);
+    isInit = strcmp(methodName, "<init>") == 0;
+    const char *descriptor = jc->getString(m->descriptorIndex);
+    returnDescriptor = strchr(descriptor, ')');
+    if (descriptor[0] != '(' || !returnDescriptor) {
+        return fail("malformed method descriptor");
+    }
+    returnDescriptor++;
+
+    if (!computeBoundaries() || !buildFrames()) {
+        return false;
+    }
+
+    // 异常处理器的范围和入口
+    handlerTypes.clear();
+    FOR_EACH(i, code->exceptionTableLength) {
+        const auto &h = code->exceptionTable[i];
+        if (h.startPC >= h.endPC || h.endPC > code->codeLength || !instructionStart[h.startPC] ||
+            (h.endPC < code->codeLength && !instructionStart[h.endPC]) || h.handlerPC >= code->codeLength) {
+            return fail("invalid exception table");
+        }
+        if (frameIndex[h.handlerPC] < 0) {
+            errorPC = h.handlerPC;
+            return fail("no stack map frame at exception handler");
+        }
+        VType catchType = makeType(ITEM_Object, intern("java/lang/Throwable"));
+        if (h.catchType != 0) {
+            VType t = makeType(ITEM_Object, className(h.catchType));
+            if (!t.name || !isAssignable(t, catchType)) {
+                return fail("catch type is not a subclass of Throwable");
+            }
+            catchType = t;
+        }
+        handlerTypes.push_back(catchType);
+    }
+
+    // 初始帧由方法描述符确定
+    cur = frames[0];
+    bool fallThrough = true;
+    for (u4 pc = 0; pc < code->codeLength; pc += bytecodeLength(code->code, pc, code->codeLength)) {
+        errorPC = pc;
+        const int fi = frameIndex[pc];
+        if (fi > 0) {
+            if (fallThrough && !isFrameAssignable(cur, frames[fi])) {
+                return fail("current frame is not assignable to stack map frame");
+            }
+            cur = frames[fi];
+        } else if (!fallThrough) {
+            return fail("no stack map frame after unconditional branch");
+        }
+
+        if (!checkHandlers(pc) || !execute(pc, fallThrough)) {
+            return false;
+        }
+    }
+    if (fallThrough) {
+        return fail("falling off the end of code");
+    }
+    return true;
+}
+
+bool Verifier::computeBoundaries() {
+    const u4 codeLength = code->codeLength;
+    instructionStart.assign(codeLength, false);
+    for (u4 pc = 0; pc < codeLength;) {
+        const u4 length = bytecodeLength(code->code, pc, codeLength);
+        if (length == 0) {
+            errorPC = pc;
+            return fail("illegal or truncated instruction");
+        }
+        instructionStart[pc] = true;
+        pc += length;
+    }
+    return true;
+}
+
+bool Verifier::appendLocal(VFrame &frame, const VType &t) {
+    const u2 slots = isCategory2(t) ? 2 : 1;
+    if (frame.localsSize + slots > code->maxLocals) {
+        return false;
+    }
+    frame.locals[frame.localsSize++] = t;
+    if (slots == 2) {
+        frame.locals[frame.localsSize++] = makeType(ITEM_Top);
+    }
+    return true;
+}
+
+bool Verifier::decodeType(VerificationTypeInfo *info, VType &t) {
+    if (!info) {
+        return false;
+    }
+    switch (info->tag) {
+        case ITEM_Object:
+            t = makeType(ITEM_Object, className(static_cast<VariableInfo_Object*>(info)->cpoolIndex));
+            return t.name != nullptr;
+        case ITEM_Uninitialized: {
+            u2 offset = static_cast<VariableInfo_Uninitialized*>(info)->offset;
+            t = makeType(ITEM_Uninitialized, nullptr, offset);
+            return offset < code->codeLength && instructionStart[offset] && code->code[offset] == op_new;
+        }
+        default:
+            t = makeType(info->tag);
+            return info->tag <= ITEM_Uninitialized;
+    }
+}
+
+bool Verifier::buildFrames() {
+    frames.clear();
+    frameIndex.assign(code->codeLength, -1);
+
+    // 下标 0 是由方法描述符得到的初始帧，它不对应栈映射表中的项
+    VFrame initial;
+    initial.locals.assign(code->maxLocals, makeType(ITEM_Top));
+    if (!IS_METHOD_STATIC(method->accessFlags)) {
+        if (isInit && thisName != objectName) {
+            initial.flagThisUninit = true;
+            if (!appendLocal(initial, makeType(ITEM_UninitializedThis))) {
+                return fail("arguments exceed max_locals");
+            }
+        } else if (!appendLocal(initial, makeType(ITEM_Object, thisName))) {
+            return fail("arguments exceed max_locals");
+        }
+    }
+    const char *p = jc->getString(method->descriptorIndex) + 1;
+    while (*p != ')') {
+        VType t;
+        if (!parseFieldType(p, t)) {
+            return fail("malformed method descriptor");
+        }
+        if (!appendLocal(initial, t)) {
+            return fail("arguments exceed max_locals");
+        }
+    }
+    frames.push_back(initial);
+
+    auto *table = static_cast<ATTR_StackMapTable*>(
+            jc->findAttribute(code->attributes, code->attributeCount, AttributeKind::StackMapTable));
+    if (!table) {
+        return true;
+    }
+
+    int64_t offset = -1;
+    FOR_EACH(i, table->numberOfEntries) {
+        StackMapFrame *entry = table->entries[i];
+        VFrame frame = frames.back();
+        frame.stack.clear();
+        offset += entry->offsetDelta + 1;
+        errorPC = (u4)offset;
+
+        const u1 frameType = entry->frameType;
+        if (IS_STACKFRAME_same_frame(frameType) || IS_STACKFRAME_same_frame_extended(frameType)) {
+            // 局部变量不变，操作数栈为空
+        } else if (IS_STACKFRAME_same_locals_1_stack_item_frame(frameType) ||
+                   IS_STACKFRAME_same_locals_1_stack_item_frame_extended(frameType)) {
+            VerificationTypeInfo *info = frameType < 128
+                                         ? static_cast<Frame_Same_locals_1_stack_item*>(entry)->stack[0]
+                                         : static_cast<Frame_Same_locals_1_stack_item_extended*>(entry)->stack[0];
+            VType t;
+            if (!decodeType(info, t)) {
+                return fail("invalid verification type");
+            }
+            frame.stack.push_back(t);
+            if (isCategory2(t)) {
+                frame.stack.push_back(makeType(ITEM_Top));
+            }
+        } else if (IS_STACKFRAME_chop_frame(frameType)) {
+            FOR_EACH(k, 251 - frameType) {
+                if (frame.localsSize == 0) {
+                    return fail("chop frame removes too many locals");
+                }
+                u2 slot = --frame.localsSize;
+                frame.locals[slot] = makeType(ITEM_Top);
+                if (slot > 0 && isCategory2(frame.locals[slot - 1])) {
+                    frame.locals[--frame.localsSize] = makeType(ITEM_Top);
+                }
+            }
+        } else if (IS_STACKFRAME_append_frame(frameType)) {
+            auto *append = static_cast<Frame_Append*>(entry);
+            FOR_EACH(k, frameType - 251) {
+                VType t;
+                if (!decodeType(append->locals[k], t) || !appendLocal(frame, t)) {
+                    return fail("invalid append frame");
+                }
+            }
+        } else if (IS_STACKFRAME_full_frame(frameType)) {
+            auto *full = static_cast<Frame_Full*>(entry);
+            frame.locals.assign(code->maxLocals, makeType(ITEM_Top));
+            frame.localsSize = 0;
+            FOR_EACH(k, full->numberOfLocals) {
+                VType t;
+                if (!decodeType(full->locals[k], t) || !appendLocal(frame, t)) {
+                    return fail("invalid full frame");
+                }
+            }
+            FOR_EACH(k, full->numberOfStackItems) {
+                VType t;
+                if (!decodeType(full->stack[k], t) || t.tag == ITEM_Top) {
+                    return fail("invalid full frame");
+                }
+                frame.stack.push_back(t);
+                if (isCategory2(t)) {
+                    frame.stack.push_back(makeType(ITEM_Top));
+                }
+            }
+        } else {
+            return fail("reserved stack map frame type");
+        }
+
+        if (offset >= code->codeLength || !instructionStart[offset]) {
+            return fail("stack map frame is not at an instruction boundary");
+        }
+        if (frame.stack.size() > code->maxStack) {
+            return fail("stack map frame exceeds max_stack");
+        }
+        frame.flagThisUninit = false;
+        FOR_EACH(k, frame.localsSize) {
+            if (frame.locals[k].tag == ITEM_UninitializedThis) {
+                frame.flagThisUninit = true;
+            }
+        }
+        frameIndex[offset] = (int)frames.size();
+        frames.push_back(std::move(frame));
+    }
+    return true;
+}
+
+bool Verifier::checkHandlers(u4 pc) {
+    FOR_EACH(i, code->exceptionTableLength) {
+        const auto &h = code->exceptionTable[i];
+        if (pc < h.startPC || pc >= h.endPC) {
+            continue;
+        }
+        // 抛出异常时操作数栈被清空，只剩下异常对象
+        const VFrame &target = frames[frameIndex[h.handlerPC]];
+        if (target.stack.size() != 1 || !isAssignable(handlerTypes[i], target.stack[0]) ||
+            (cur.flagThisUninit && !target.flagThisUninit)) {
+            return fail("exception handler frame mismatch");
+        }
+        FOR_EACH(k, cur.locals.size()) {
+            if (!isAssignable(cur.locals[k], target.locals[k])) {
+                return fail("exception handler frame mismatch");
+            }
+        }
+    }
+    return true;
+}
+
+bool Verifier::checkTarget(int64_t target) {
+    if (target < 0 || target >= code->codeLength || !instructionStart[target]) {
+        return fail("branch target is not an instruction");
+    }
+    const int fi = frameIndex[target];
+    if (fi <= 0) {
+        return fail("no stack map frame at branch target");
+    }
+    if (!isFrameAssignable(cur, frames[fi])) {
+        return fail("current frame is not assignable to branch target");
+    }
+    return true;
+}
+
+
+bool Verifier::push(const VType &t) {
+    const std::size_t slots = isCategory2(t) ? 2 : 1;
+    if (cur.stack.size() + slots > code->maxStack) {
+        return fail("operand stack overflow");
+    }
+    cur.stack.push_back(t);
+    if (slots == 2) {
+        cur.stack.push_back(makeType(ITEM_Top));
+    }
+    return true;
+}
+
+bool Verifier::popAny(VType &t) {
+    if (cur.stack.empty()) {
+        return fail("operand stack underflow");
+    }
+    t = cur.stack.back();
+    cur.stack.pop_back();
+    if (t.tag == ITEM_Top) {
+        // long/double 的第二个槽
+        if (cur.stack.empty() || !isCategory2(cur.stack.back())) {
+            return fail("operand stack underflow");
+        }
+        t = cur.stack.back();
+        cur.stack.pop_back();
+    }
+    return true;
+}
+
+bool Verifier::pop(const VType &expected) {
+    VType t;
+    if (!popAny(t)) {
+        return false;
+    }
+    if (!isAssignable(t, expected)) {
+        return fail("bad type on operand stack");
+    }
+    return true;
+}
+
+bool Verifier::popReference(VType &t) {
+    if (!popAny(t)) {
+        return false;
+    }
+    if (t.tag != ITEM_Object && t.tag != ITEM_Null && t.tag != ITEM_Uninitialized &&
+        t.tag != ITEM_UninitializedThis) {
+        return fail("expecting a reference on operand stack");
+    }
+    return true;
+}
+
+bool Verifier::popArray(VType &t) {
+    if (!popAny(t)) {
+        return false;
+    }
+    if (t.tag != ITEM_Null && (t.tag != ITEM_Object || t.name[0] != '[')) {
+        return fail("expecting an array on operand stack");
+    }
+    return true;
+}
+
+bool Verifier::load(u2 index, u1 tag) {
+    const bool wide = tag == ITEM_Long || tag == ITEM_Double;
+    if (index + (wide ? 1 : 0) >= code->maxLocals) {
+        return fail("local variable index out of range");
+    }
+    const VType &t = cur.locals[index];
+    if (tag == ITEM_Object) {
+        if (t.tag != ITEM_Object && t.tag != ITEM_Null && t.tag != ITEM_Uninitialized &&
+            t.tag != ITEM_UninitializedThis) {
+            return fail("expecting a reference in local variable");
+        }
+    } else if (t.tag != tag || (wide && cur.locals[index + 1].tag != ITEM_Top)) {
+        return fail("bad type in local variable");
+    }
+    return push(t);
+}
+
+bool Verifier::store(u2 index, const VType &t) {
+    const bool wide = isCategory2(t);
+    if (index + (wide ? 1 : 0) >= code->maxLocals) {
+        return fail("local variable index out of range");
+    }
+    // 覆盖了某个 long/double 的第二个槽，它的第一个槽也就失效了
+    if (index > 0 && isCategory2(cur.locals[index - 1])) {
+        cur.locals[index - 1] = makeType(ITEM_Top);
+    }
+    cur.locals[index] = t;
+    if (wide) {
+        cur.locals[index + 1] = makeType(ITEM_Top);
+    }
+    return true;
+}
+
+bool Verifier::checkIinc(u2 index) {
+    if (index >= code->maxLocals || cur.locals[index].tag != ITEM_Integer) {
+        return fail("iinc on a non-int local variable");
+    }
+    return true;
+}
+
+bool Verifier::dup(u1 n, u1 m) {
+    const std::size_t size = cur.stack.size();
+    if (size < (std::size_t)(n + m)) {
+        return fail("operand stack underflow");
+    }
+    // 复制和移动的范围不能把 long/double 的两个槽拆开
+    if (cur.stack[size - n].tag == ITEM_Top || (m > 0 && cur.stack[size - n - m].tag == ITEM_Top)) {
+        return fail("dup splits a long or double");
+    }
+    if (size + n > code->maxStack) {
+        return fail("operand stack overflow");
+    }
+    cur.stack.insert(cur.stack.end() - n - m, cur.stack.end() - n, cur.stack.end());
+    return true;
+}
+
+
+bool Verifier::accessField(u4 pc, u1 opcode) {
+    const u2 index = readBytecodeU2(code->code + pc + 1);
+    auto *ref = index < jc->raw.constPoolCount ? dynamic_cast<CONSTANT_FieldRef*>(jc->raw.constPoolInfo[index])
+                                               : nullptr;
+    if (!ref) {
+        return fail("expecting a CONSTANT_Fieldref");
+    }
+    auto *nat = dynamic_cast<CONSTANT_NameAndType*>(jc->raw.constPoolInfo[ref->nameAndTypeIndex]);
+    const char *owner = className(ref->classIndex);
+    if (!nat || !owner) {
+        return fail("malformed CONSTANT_Fieldref");
+    }
+    const char *descriptor = jc->getString(nat->descriptorIndex);
+    VType fieldType;
+    if (!parseFieldType(descriptor, fieldType) || *descriptor != '\0') {
+        return fail("malformed field descriptor");
+    }
+
+    VType objectRef;
+    switch (opcode) {
+        case op_getstatic:
+            return push(fieldType);
+        case op_putstatic:
+            return pop(fieldType);
+        case op_getfield:
+            return pop(makeType(ITEM_Object, owner)) && push(fieldType);
+        default:
+            if (!pop(fieldType) || !popReference(objectRef)) {
+                return false;
+            }
+            // 构造函数中调用父类构造函数之前可以给本类声明的字段赋值
+            if (objectRef.tag == ITEM_UninitializedThis && owner == thisName) {
+                return true;
+            }
+            if (!isAssignable(objectRef, makeType(ITEM_Object, owner))) {
+                return fail("bad object reference for putfield");
+            }
+            return true;
+    }
+}
+
+bool Verifier::invoke(u4 pc, u1 opcode) {
+    const u2 index = readBytecodeU2(code->code + pc + 1);
+    if (index == 0 || index >= jc->raw.constPoolCount) {
+        return fail("invalid constant pool index");
+    }
+    ConstantPoolInfo *cp = jc->raw.constPoolInfo[index];
+    u2 classIndex = 0;
+    u2 natIndex;
+    if (opcode == op_invokedynamic) {
+        auto *indy = dynamic_cast<CONSTANT_InvokeDynamic*>(cp);
+        if (!indy || code->code[pc + 3] != 0 || code->code[pc + 4] != 0) {
+            return fail("malformed invokedynamic");
+        }
+        natIndex = indy->nameAndTypeIndex;
+    } else if (auto *mref = dynamic_cast<CONSTANT_MethodRef*>(cp)) {
+        if (opcode == op_invokeinterface) {
+            return fail("invokeinterface on a CONSTANT_Methodref");
+        }
+        classIndex = mref->classIndex;
+        natIndex = mref->nameAndTypeIndex;
+    } else if (auto *iref = dynamic_cast<CONSTANT_InterfaceMethodRef*>(cp)) {
+        if (opcode == op_invokevirtual) {
+            return fail("invokevirtual on a CONSTANT_InterfaceMethodref");
+        }
+        classIndex = iref->classIndex;
+        natIndex = iref->nameAndTypeIndex;
+    } else {
+        return fail("expecting a method reference");
+    }
+
+    auto *nat = dynamic_cast<CONSTANT_NameAndType*>(jc->raw.constPoolInfo[natIndex]);
+    const char *owner = classIndex != 0 ? className(classIndex) : nullptr;
+    if (!nat || (opcode != op_invokedynamic && !owner)) {
+        return fail("malformed method reference");
+    }
+    const char *name = jc->getString(nat->nameIndex);
+    const char *descriptor = jc->getString(nat->descriptorIndex);
+    const bool callsInit = strcmp(name, "<init>") == 0;
+    if (name[0] == '<' && !(callsInit && opcode == op_invokespecial)) {
+        return fail("invalid call to an initialization method");
+    }
+
+    // 参数从右向左出栈
+    if (descriptor[0] != '(') {
+        return fail("malformed method descriptor");
+    }
+    std::vector<VType> args;
+    u2 argSlots = 0;
+    const char *p = descriptor + 1;
+    while (*p != ')') {
+        VType t;
+        if (!parseFieldType(p, t)) {
+            return fail("malformed method descriptor");
+        }
+        argSlots += isCategory2(t) ? 2 : 1;
+        args.push_back(t);
+    }
+    p++;
+    for (auto it = args.rbegin(); it != args.rend(); ++it) {
+        if (!pop(*it)) {
+            return false;
+        }
+    }
+
+    if (opcode == op_invokeinterface) {
+        if (code->code[pc + 3] != argSlots + 1 || code->code[pc + 4] != 0) {
+            return fail("malformed invokeinterface");
+        }
+    }
+
+    if (opcode != op_invokestatic && opcode != op_invokedynamic) {
+        VType receiver;
+        if (!popReference(receiver)) {
+            return false;
+        }
+        if (callsInit) {
+            VType initialized;
+            if (receiver.tag == ITEM_UninitializedThis) {
+                // 只能调用本类的其它构造函数或者直接父类的构造函数
+                const char *superName = jc->getSuperClassName();
+                if (owner != thisName && (!superName || strcmp(owner, superName) != 0)) {
+                    return fail("bad <init> call on uninitialized this");
+                }
+                initialized = makeType(ITEM_Object, thisName);
+                cur.flagThisUninit = false;
+            } else if (receiver.tag == ITEM_Uninitialized) {
+                const char *created = className(readBytecodeU2(code->code + receiver.offset + 1));
+                if (created != owner) {
+                    return fail("bad <init> call on uninitialized object");
+                }
+                initialized = makeType(ITEM_Object, created);
+            } else {
+                return fail("<init> call on an initialized object");
+            }
+
+            // 同一个未初始化对象的所有副本都变为已初始化
+            for (auto &t : cur.locals) {
+                if (t.tag == receiver.tag && t.offset == receiver.offset) {
+                    t = initialized;
+                }
+            }
+            for (auto &t : cur.stack) {
+                if (t.tag == receiver.tag && t.offset == receiver.offset) {
+                    t = initialized;
+                }
+            }
+        } else if (receiver.tag == ITEM_Uninitialized || receiver.tag == ITEM_UninitializedThis) {
+            return fail("method call on an uninitialized object");
+        } else if (opcode == op_invokespecial) {
+            if (!isAssignable(receiver, makeType(ITEM_Object, thisName))) {
+                return fail("bad receiver for invokespecial");
+            }
+        } else if (opcode == op_invokevirtual) {
+            if (!isAssignable(receiver, makeType(ITEM_Object, owner))) {
+                return fail("bad receiver for invokevirtual");
+            }
+        }
+    }
+
+    if (*p == 'V') {
+        return !callsInit || p[1] == '\0' ? true : fail("malformed method descriptor");
+    }
+    VType ret;
+    if (callsInit || !parseFieldType(p, ret) || *p != '\0') {
+        return fail("malformed method descriptor");
+    }
+    return push(ret);
+}
+
+
+bool Verifier::execute(u4 pc, bool &fallThrough) {
+    const u1 *bc = code->code + pc;
+    const VType INT = makeType(ITEM_Integer);
+    const VType FLOAT = makeType(ITEM_Float);
+    const VType LONG = makeType(ITEM_Long);
+    const VType DOUBLE = makeType(ITEM_Double);
+    VType t, t2;
+
+    fallThrough = true;
+    switch (bc[0]) {
+        case op_nop:
+            return true;
+        case op_aconst_null:
+            return push(makeType(ITEM_Null));
+        case op_iconst_m1:
+        case op_iconst_0:
+        case op_iconst_1:
+        case op_iconst_2:
+        case op_iconst_3:
+        case op_iconst_4:
+        case op_iconst_5:
+        case op_bipush:
+        case op_sipush:
+            return push(INT);
+        case op_lconst_0:
+        case op_lconst_1:
+            return push(LONG);
+        case op_fconst_0:
+        case op_fconst_1:
+        case op_fconst_2:
+            return push(FLOAT);
+        case op_dconst_0:
+        case op_dconst_1:
+            return push(DOUBLE);
+
+        case op_ldc:
+        case op_ldc_w:
+        case op_ldc2_w: {
+            const u2 index = bc[0] == op_ldc ? bc[1] : readBytecodeU2(bc + 1);
+            if (index == 0 || index >= jc->raw.constPoolCount) {
+                return fail("invalid constant pool index");
+            }
+            ConstantPoolInfo *cp = jc->raw.constPoolInfo[index];
+            if (bc[0] == op_ldc2_w) {
+                if (dynamic_cast<CONSTANT_Long*>(cp)) {
+                    return push(LONG);
+                }
+                if (dynamic_cast<CONSTANT_Double*>(cp)) {
+                    return push(DOUBLE);
+                }
+                return fail("bad constant for ldc2_w");
+            }
+            if (dynamic_cast<CONSTANT_Integer*>(cp)) {
+                return push(INT);
+            }
+            if (dynamic_cast<CONSTANT_Float*>(cp)) {
+                return push(FLOAT);
+            }
+            if (dynamic_cast<CONSTANT_String*>(cp)) {
+                return push(makeType(ITEM_Object, intern("java/lang/String")));
+            }
+            if (dynamic_cast<CONSTANT_Class*>(cp)) {
+                return push(makeType(ITEM_Object, intern("java/lang/Class")));
+            }
+            if (dynamic_cast<CONSTANT_MethodType*>(cp)) {
+                return push(makeType(ITEM_Object, intern("java/lang/invoke/MethodType")));
+            }
+            if (dynamic_cast<CONSTANT_MethodHandle*>(cp)) {
+                return push(makeType(ITEM_Object, intern("java/lang/invoke/MethodHandle")));
+            }
+            return fail("bad constant for ldc");
+        }
+
+        case op_iload:
+            return load(bc[1], ITEM_Integer);
+        case op_lload:
+            return load(bc[1], ITEM_Long);
+        case op_fload:
+            return load(bc[1], ITEM_Float);
+        case op_dload:
+            return load(bc[1], ITEM_Double);
+        case op_aload:
+            return load(bc[1], ITEM_Object);
+        case op_iload_0: case op_iload_1: case op_iload_2: case op_iload_3:
+            return load(bc[0] - op_iload_0, ITEM_Integer);
+        case op_lload_0: case op_lload_1: case op_lload_2: case op_lload_3:
+            return load(bc[0] - op_lload_0, ITEM_Long);
+        case op_fload_0: case op_fload_1: case op_fload_2: case op_fload_3:
+            return load(bc[0] - op_fload_0, ITEM_Float);
+        case op_dload_0: case op_dload_1: case op_dload_2: case op_dload_3:
+            return load(bc[0] - op_dload_0, ITEM_Double);
+        case op_aload_0: case op_aload_1: case op_aload_2: case op_aload_3:
+            return load(bc[0] - op_aload_0, ITEM_Object);
+
+        case op_iaload:
+        case op_laload:
+        case op_faload:
+        case op_daload:
+        case op_aaload:
+        case op_baload:
+        case op_caload:
+        case op_saload: {
+            static const char components[] = {'I', 'J', 'F', 'D', 'L', 'B', 'C', 'S'};
+            const char component = components[bc[0] - op_iaload];
+            if (!pop(INT) || !popArray(t)) {
+                return false;
+            }
+            if (component == 'L') {
+                if (t.tag == ITEM_Null) {
+                    return push(t);
+                }
+                const char *p = t.name + 1;
+                if ((*p != 'L' && *p != '[') || !parseFieldType(p, t2)) {
+                    return fail("aaload on a primitive array");
+                }
+                return push(t2);
+            }
+            // baload 同时用于 byte[] 和 boolean[]
+            if (t.tag == ITEM_Object && !(t.name[1] == component || (component == 'B' && t.name[1] == 'Z'))) {
+                return fail("array type mismatch");
+            }
+            return push(makeType(primitiveTag(component)));
+        }
+
+        case op_istore:
+            return pop(INT) && store(bc[1], INT);
+        case op_lstore:
+            return pop(LONG) && store(bc[1], LONG);
+        case op_fstore:
+            return pop(FLOAT) && store(bc[1], FLOAT);
+        case op_dstore:
+            return pop(DOUBLE) && store(bc[1], DOUBLE);
+        case op_astore:
+            return popReference(t) && store(bc[1], t);
+        case op_istore_0: case op_istore_1: case op_istore_2: case op_istore_3:
+            return pop(INT) && store(bc[0] - op_istore_0, INT);
+        case op_lstore_0: case op_lstore_1: case op_lstore_2: case op_lstore_3:
+            return pop(LONG) && store(bc[0] - op_lstore_0, LONG);
+        case op_fstore_0: case op_fstore_1: case op_fstore_2: case op_fstore_3:
+            return pop(FLOAT) && store(bc[0] - op_fstore_0, FLOAT);
+        case op_dstore_0: case op_dstore_1: case op_dstore_2: case op_dstore_3:
+            return pop(DOUBLE) && store(bc[0] - op_dstore_0, DOUBLE);
+        case op_astore_0: case op_astore_1: case op_astore_2: case op_astore_3:
+            return popReference(t) && store(bc[0] - op_astore_0, t);
+
+        case op_iastore:
+        case op_lastore:
+        case op_fastore:
+        case op_dastore:
+        case op_aastore:
+        case op_bastore:
+        case op_castore:
+        case op_sastore: {
+            static const char components[] = {'I', 'J', 'F', 'D', 'L', 'B', 'C', 'S'};
+            const char component = components[bc[0] - op_iastore];
+            if (component == 'L') {
+                // 元素类型在运行时由 aastore 检查
+                if (!popReference(t) || t.tag == ITEM_Uninitialized || t.tag == ITEM_UninitializedThis) {
+                    return fail("bad value for aastore");
+                }
+            } else if (!pop(makeType(primitiveTag(component)))) {
+                return false;
+            }
+            if (!pop(INT) || !popArray(t)) {
+                return false;
+            }
+            if (t.tag == ITEM_Null) {
+                return true;
+            }
+            const char actual = t.name[1];
+            if (component == 'L' ? (actual != 'L' && actual != '[')
+                                 : !(actual == component || (component == 'B' && actual == 'Z'))) {
+                return fail("array type mismatch");
+            }
+            return true;
+        }
+
+        case op_pop:
+            if (cur.stack.empty() || cur.stack.back().tag == ITEM_Top) {
+                return fail("pop requires a category 1 value");
+            }
+            cur.stack.pop_back();
+            return true;
+        case op_pop2: {
+            const std::size_t size = cur.stack.size();
+            if (size < 2 || cur.stack[size - 2].tag == ITEM_Top) {
+                return fail("pop2 splits a long or double");
+            }
+            cur.stack.resize(size - 2);
+            return true;
+        }
+        case op_dup:
+            return dup(1, 0);
+        case op_dup_x1:
+            return dup(1, 1);
+        case op_dup_x2:
+            return dup(1, 2);
+        case op_dup2:
+            return dup(2, 0);
+        case op_dup2_x1:
+            return dup(2, 1);
+        case op_dup2_x2:
+            return dup(2, 2);
+        case op_swap: {
+            const std::size_t size = cur.stack.size();
+            if (size < 2 || cur.stack[size - 1].tag == ITEM_Top || cur.stack[size - 2].tag == ITEM_Top) {
+                return fail("swap requires two category 1 values");
+            }
+            std::swap(cur.stack[size - 1], cur.stack[size - 2]);
+            return true;
+        }
+
+        case op_iadd: case op_isub: case op_imul: case op_idiv: case op_irem:
+        case op_ishl: case op_ishr: case op_iushr: case op_iand: case op_ior: case op_ixor:
+            return pop(INT) && pop(INT) && push(INT);
+        case op_ladd: case op_lsub: case op_lmul: case op_ldiv: case op_lrem:
+        case op_land: case op_lor: case op_lxor:
+            return pop(LONG) && pop(LONG) && push(LONG);
+        case op_lshl: case op_lshr: case op_lushr:
+            return pop(INT) && pop(LONG) && push(LONG);
+        case op_fadd: case op_fsub: case op_fmul: case op_fdiv: case op_frem:
+            return pop(FLOAT) && pop(FLOAT) && push(FLOAT);
+        case op_dadd: case op_dsub: case op_dmul: case op_ddiv: case op_drem:
+            return pop(DOUBLE) && pop(DOUBLE) && push(DOUBLE);
+        case op_ineg:
+        case op_i2b:
+        case op_i2c:
+        case op_i2s:
+            return pop(INT) && push(INT);
+        case op_lneg:
+            return pop(LONG) && push(LONG);
+        case op_fneg:
+            return pop(FLOAT) && push(FLOAT);
+        case op_dneg:
+            return pop(DOUBLE) && push(DOUBLE);
+        case op_iinc:
+            return checkIinc(bc[1]);
+
+        case op_i2l:
+            return pop(INT) && push(LONG);
+        case op_i2f:
+            return pop(INT) && push(FLOAT);
+        case op_i2d:
+            return pop(INT) && push(DOUBLE);
+        case op_l2i:
+            return pop(LONG) && push(INT);
+        case op_l2f:
+            return pop(LONG) && push(FLOAT);
+        case op_l2d:
+            return pop(LONG) && push(DOUBLE);
+        case op_f2i:
+            return pop(FLOAT) && push(INT);
+        case op_f2l:
+            return pop(FLOAT) && push(LONG);
+        case op_f2d:
+            return pop(FLOAT) && push(DOUBLE);
+        case op_d2i:
+            return pop(DOUBLE) && push(INT);
+        case op_d2l:
+            return pop(DOUBLE) && push(LONG);
+        case op_d2f:
+            return pop(DOUBLE) && push(FLOAT);
+
+        case op_lcmp:
+            return pop(LONG) && pop(LONG) && push(INT);
+        case op_fcmpl:
+        case op_fcmpg:
+            return pop(FLOAT) && pop(FLOAT) && push(INT);
+        case op_dcmpl:
+        case op_dcmpg:
+            return pop(DOUBLE) && pop(DOUBLE) && push(INT);
+
+        case op_ifeq: case op_ifne: case op_iflt: case op_ifge: case op_ifgt: case op_ifle:
+            return pop(INT) && checkTarget((int64_t)pc + readBytecodeS2(bc + 1));
+        case op_if_icmpeq: case op_if_icmpne: case op_if_icmplt:
+        case op_if_icmpge: case op_if_icmpgt: case op_if_icmple:
+            return pop(INT) && pop(INT) && checkTarget((int64_t)pc + readBytecodeS2(bc + 1));
+        case op_if_acmpeq:
+        case op_if_acmpne:
+            return popReference(t) && popReference(t2) && checkTarget((int64_t)pc + readBytecodeS2(bc + 1));
+        case op_ifnull:
+        case op_ifnonnull:
+            return popReference(t) && checkTarget((int64_t)pc + readBytecodeS2(bc + 1));
+        case op_goto:
+            fallThrough = false;
+            return checkTarget((int64_t)pc + readBytecodeS2(bc + 1));
+        case op_goto_w:
+            fallThrough = false;
+            return checkTarget((int64_t)pc + readBytecodeS4(bc + 1));
+
+        case op_tableswitch: {
+            fallThrough = false;
+            if (!pop(INT)) {
+                return false;
+            }
+            const u1 *p = code->code + ((pc + 4) & ~3u);
+            const int32_t low = readBytecodeS4(p + 4);
+            const int32_t high = readBytecodeS4(p + 8);
+            if (!checkTarget((int64_t)pc + readBytecodeS4(p))) {
+                return false;
+            }
+            for (int64_t i = 0; i <= (int64_t)high - low; ++i) {
+                if (!checkTarget((int64_t)pc + readBytecodeS4(p + 12 + i * 4))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case op_lookupswitch: {
+            fallThrough = false;
+            if (!pop(INT)) {
+                return false;
+            }
+            const u1 *p = code->code + ((pc + 4) & ~3u);
+            const int32_t npairs = readBytecodeS4(p + 4);
+            if (!checkTarget((int64_t)pc + readBytecodeS4(p))) {
+                return false;
+            }
+            for (int32_t i = 0; i < npairs; ++i) {
+                const u1 *pair = p + 8 + i * 8;
+                if (i > 0 && readBytecodeS4(pair) <= readBytecodeS4(pair - 8)) {
+                    return fail("lookupswitch keys are not sorted");
+                }
+                if (!checkTarget((int64_t)pc + readBytecodeS4(pair + 4))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        case op_ireturn:
+        case op_lreturn:
+        case op_freturn:
+        case op_dreturn:
+        case op_areturn:
+        case op_return: {
+            fallThrough = false;
+            if (bc[0] == op_return) {
+                if (returnDescriptor[0] != 'V') {
+                    return fail("return type mismatch");
+                }
+                if (isInit && cur.flagThisUninit) {
+                    return fail("constructor returns before calling super constructor");
+                }
+                return true;
+            }
+            const char *p = returnDescriptor;
+            if (!parseFieldType(p, t) || *p != '\0') {
+                return fail("return type mismatch");
+            }
+            static const u1 tags[] = {ITEM_Integer, ITEM_Long, ITEM_Float, ITEM_Double, ITEM_Object};
+            if (t.tag != tags[bc[0] - op_ireturn]) {
+                return fail("return type mismatch");
+            }
+            return pop(t);
+        }
+
+        case op_getstatic:
+        case op_putstatic:
+        case op_getfield:
+        case op_putfield:
+            return accessField(pc, bc[0]);
+
+        case op_invokevirtual:
+        case op_invokespecial:
+        case op_invokestatic:
+        case op_invokeinterface:
+        case op_invokedynamic:
+            return invoke(pc, bc[0]);
+
+        case op_new: {
+            const char *name = className(readBytecodeU2(bc + 1));
+            if (!name || name[0] == '[') {
+                return fail("new requires a class type");
+            }
+            // 循环中再次执行同一条 new 时，之前创建但未初始化的对象不能再被使用
+            const VType created = makeType(ITEM_Uninitialized, nullptr, (u2)pc);
+            for (const auto &s : cur.stack) {
+                if (s.tag == ITEM_Uninitialized && s.offset == created.offset) {
+                    return fail("uninitialized object already on operand stack");
+                }
+            }
+            for (auto &l : cur.locals) {
+                if (l.tag == ITEM_Uninitialized && l.offset == created.offset) {
+                    l = makeType(ITEM_Top);
+                }
+            }
+            return push(created);
+        }
+        case op_newarray: {
+            static const char *descriptors[] = {"[Z", "[C", "[F", "[D", "[B", "[S", "[I", "[J"};
+            if (bc[1] < T_BOOLEAN || bc[1] > T_LONG) {
+                return fail("invalid newarray type");
+            }
+            return pop(INT) && push(makeType(ITEM_Object, intern(descriptors[bc[1] - T_BOOLEAN])));
+        }
+        case op_anewarray: {
+            const char *name = className(readBytecodeU2(bc + 1));
+            if (!name) {
+                return fail("expecting a CONSTANT_Class");
+            }
+            std::string descriptor = name[0] == '[' ? std::string("[") + name : std::string("[L") + name + ";";
+            return pop(INT) && push(makeType(ITEM_Object, intern(descriptor)));
+        }
+        case op_multianewarray: {
+            const char *name = className(readBytecodeU2(bc + 1));
+            u1 dimensions = bc[3];
+            if (!name || dimensions == 0 || strspn(name, "[") < dimensions) {
+                return fail("bad multianewarray");
+            }
+            FOR_EACH(i, dimensions) {
+                if (!pop(INT)) {
+                    return false;
+                }
+            }
+            return push(makeType(ITEM_Object, name));
+        }
+        case op_arraylength:
+            return popArray(t) && push(INT);
+        case op_athrow:
+            fallThrough = false;
+            return pop(makeType(ITEM_Object, intern("java/lang/Throwable")));
+        case op_checkcast: {
+            const char *name = className(readBytecodeU2(bc + 1));
+            if (!name) {
+                return fail("expecting a CONSTANT_Class");
+            }
+            if (!popReference(t) || t.tag == ITEM_Uninitialized || t.tag == ITEM_UninitializedThis) {
+                return fail("bad checkcast operand");
+            }
+            return push(makeType(ITEM_Object, name));
+        }
+        case op_instanceof:
+            if (!className(readBytecodeU2(bc + 1))) {
+                return fail("expecting a CONSTANT_Class");
+            }
+            return popReference(t) && push(INT);
+        case op_monitorenter:
+        case op_monitorexit:
+            return popReference(t);
+
+        case op_wide: {
+            const u2 index = readBytecodeU2(bc + 2);
+            switch (bc[1]) {
+                case op_iload:
+                    return load(index, ITEM_Integer);
+                case op_lload:
+                    return load(index, ITEM_Long);
+                case op_fload:
+                    return load(index, ITEM_Float);
+                case op_dload:
+                    return load(index, ITEM_Double);
+                case op_aload:
+                    return load(index, ITEM_Object);
+                case op_istore:
+                    return pop(INT) && store(index, INT);
+                case op_lstore:
+                    return pop(LONG) && store(index, LONG);
+                case op_fstore:
+                    return pop(FLOAT) && store(index, FLOAT);
+                case op_dstore:
+                    return pop(DOUBLE) && store(index, DOUBLE);
+                case op_astore:
+                    return popReference(t) && store(index, t);
+                case op_iinc:
+                    return checkIinc(index);
+                default:
+                    return fail("illegal wide instruction");
+            }
+        }
+
+        case op_jsr:
+        case op_jsr_w:
+        case op_ret:
+            return fail("jsr/ret are not allowed with StackMapTable");
+        default:
+            return fail("illegal opcode");
+    }
+}
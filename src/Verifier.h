@@ -0,0 +1,124 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_VERIFIER_H
+#define CJVM_VERIFIER_H
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "Type.h"
+
+class JavaClass;
+class MethodInfo;
+class ATTR_Code;
+class VerificationTypeInfo;
+
+/**
+ * 基于 StackMapTable 的类型检查验证器(JVM 规范 4.10.1)
+ *
+ * 编译器已经在每个跳转目标和异常处理入口给出了栈映射帧，验证器只需顺序扫描一遍字节码，
+ * 逐条指令模拟局部变量表和操作数栈上的类型，在有栈映射帧的位置检查当前类型能否赋值给帧中记录的类型，
+ * 不需要像类型推导验证器那样反复迭代到不动点。
+ *
+ * 版本低于 50 的 class 文件没有 StackMapTable，不做校验。jsr/ret 一律拒绝
+ */
+class Verifier {
+public:
+    explicit Verifier(JavaClass *jc);
+
+    // 校验类中所有方法，失败时输出原因并返回 false
+    bool verify();
+
+private:
+    /**
+     * 验证类型
+     *
+     * tag:     VariableInfoTag。long/double 占两个槽，第二个槽记为 Top
+     * offset:  Uninitialized 类型对应的 new 指令的位置
+     * name:    Object 类型的类名，数组为其描述符(如 [I)，经过驻留，相同的类型名指针相同
+     */
+    class VType {
+    public:
+        u1 tag;
+        u2 offset;
+        const char *name;
+    };
+
+    // 某条指令执行前局部变量表和操作数栈上的类型
+    class VFrame {
+    public:
+        std::vector<VType> locals;
+        std::vector<VType> stack;
+        // 栈映射帧中声明的局部变量槽数，chop/append 帧在此基础上增减
+        u2 localsSize = 0;
+        // this 还没有调用父类构造函数
+        bool flagThisUninit = false;
+    };
+
+private:
+    bool verifyMethod(MethodInfo *method);
+    bool computeBoundaries();
+    bool buildFrames();
+    bool checkHandlers(u4 pc);
+    bool execute(u4 pc, bool &fallThrough);
+
+    bool decodeType(VerificationTypeInfo *info, VType &t);
+    bool appendLocal(VFrame &frame, const VType &t);
+
+    bool checkTarget(int64_t target);
+    bool invoke(u4 pc, u1 opcode);
+    bool accessField(u4 pc, u1 opcode);
+
+    // 操作数栈和局部变量表
+    bool push(const VType &t);
+    bool pop(const VType &expected);
+    bool popAny(VType &t);
+    bool popReference(VType &t);
+    bool popArray(VType &t);
+    bool load(u2 index, u1 tag);
+    bool store(u2 index, const VType &t);
+    bool checkIinc(u2 index);
+    // 复制栈顶 n 个槽并插入到其下 m 个槽之下，dup 系列指令
+    bool dup(u1 n, u1 m);
+
+    // 类型关系
+    bool isAssignable(const VType &from, const VType &to);
+    bool isReferenceAssignable(const char *from, const char *to);
+    bool isSubclass(const char *from, const char *to);
+    bool isFrameAssignable(const VFrame &from, const VFrame &to);
+    JavaClass* loadClass(const char *name);
+
+    // 常量池和描述符
+    const char* intern(const std::string &name);
+    const char* className(u2 cpIndex);
+    bool parseFieldType(const char *&descriptor, VType &t);
+    static bool isCategory2(const VType &t);
+    static VType makeType(u1 tag, const char *name = nullptr, u2 offset = 0);
+    bool fail(const char *reason);
+
+private:
+    JavaClass *jc;
+    std::unordered_set<std::string> names;
+    const char *thisName;
+    const char *objectName;
+
+    // 当前正在校验的方法
+    MethodInfo *method = nullptr;
+    ATTR_Code *code = nullptr;
+    bool isInit = false;
+    const char *returnDescriptor = nullptr;
+    u4 errorPC = 0;
+    const char *error = nullptr;
+
+    // instructionStart[pc] 为 true 表示 pc 是一条指令的开始，frameIndex[pc] 为该处栈映射帧的下标
+    std::vector<bool> instructionStart;
+    std::vector<int> frameIndex;
+    std::vector<VFrame> frames;
+    std::vector<VType> handlerTypes;
+    VFrame cur;
+};
+
+
+#endif //CJVM_VERIFIER_H
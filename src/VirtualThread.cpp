@@ -0,0 +1,285 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include "VirtualThread.h"
+#include "RuntimeEnv.h"
+#include "JavaHeap.h"
+#include "Frame.h"
+
+VirtualThread::VirtualThread(JObject *threadObject, VirtualThreadScheduler *scheduler)
+        : JavaThread(threadObject), scheduler(scheduler), runState(RUNNABLE), sleeping(false) {}
+
+VirtualThread::~VirtualThread() {
+    delete pendingResult;
+}
+
+void VirtualThread::park() {
+    int expected = RUNNING;
+    runState.compare_exchange_strong(expected, PARKING);
+}
+
+void VirtualThread::unpark() {
+    for (;;) {
+        int s = runState.load();
+        if (s == PARKING) {
+            if (runState.compare_exchange_weak(s, PARKING_PERMITTED)) {
+                return;
+            }
+        } else if (s == PARKED) {
+            if (runState.compare_exchange_weak(s, RUNNABLE)) {
+                scheduler->schedule(this);
+                return;
+            }
+        } else {
+            return;
+        }
+    }
+}
+
+bool VirtualThread::sleep(int64_t millis) {
+    // 先挂起再声明睡眠，之后 unpark 的中断者和定时器一定能看到 PARKING 或 PARKED
+    park();
+    sleepSeq.fetch_add(1);
+    sleeping = true;
+    // 与 interrupt 相反的顺序写、读 sleeping 和 interrupted(都是顺序一致的)，两边至少有一方能看到对方，
+    // 再由 sleeping.exchange 决定唯一的胜者：中断者赢了会 unpark，恢复时抛出 InterruptedException
+    if (interrupted.load() && sleeping.exchange(false)) {
+        interrupted = false;
+        runState = RUNNING;
+        return false;
+    }
+    scheduler->sleepFor(this, millis);
+    return true;
+}
+
+void VirtualThread::interrupt() {
+    interrupted = true;
+    if (sleeping.exchange(false)) {
+        interrupted = false;
+        // 异常对象由虚拟线程恢复执行时自己分配，不在中断它的线程上创建
+        interruptPending = true;
+        unpark();
+    }
+}
+
+void VirtualThread::wakeFromSleep(uint64_t seq) {
+    if (seq == sleepSeq.load() && sleeping.exchange(false)) {
+        unpark();
+    }
+}
+
+
+VirtualThreadScheduler::VirtualThreadScheduler(RuntimeEnv *env, int carrierNum)
+        : env(env), carriers(this), blockingWorkers(this) {
+    carriers.initialize(carrierNum);
+    blockingWorkers.initialize(carrierNum);
+    timerThread = std::thread(&VirtualThreadScheduler::timerLoop, this);
+}
+
+VirtualThreadScheduler::~VirtualThreadScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(timerMtx);
+        timerDone = true;
+    }
+    timerCond.notify_all();
+    timerThread.join();
+
+    carriers.finalize();
+    blockingWorkers.finalize();
+}
+
+void VirtualThreadScheduler::start(JObject *threadObject) {
+    // 虚拟线程可能在另一个承载线程上运行，交出去之前发布 Thread 对象
+    if (threadObject->offset != 0) {
+        crt.jheap->publish(threadObject->offset);
+    }
+    auto vt = std::make_shared<VirtualThread>(threadObject, this);
+    vt->state = ThreadState::RUNNABLE;
+    {
+        std::lock_guard<std::mutex> lock(liveMtx);
+        liveThreads[threadObject->offset] = vt;
+    }
+    schedule(vt.get());
+}
+
+std::shared_ptr<JavaThread> VirtualThreadScheduler::find(const JObject *threadObject) {
+    std::lock_guard<std::mutex> lock(liveMtx);
+    auto pos = liveThreads.find(threadObject->offset);
+    return pos == liveThreads.end() ? nullptr : pos->second;
+}
+
+void VirtualThreadScheduler::forEach(const std::function<void(VirtualThread*)> &func) {
+    std::lock_guard<std::mutex> lock(liveMtx);
+    for (auto &x : liveThreads) {
+        func(static_cast<VirtualThread*>(x.second.get()));
+    }
+}
+
+JType* VirtualThreadScheduler::runBlocking(std::function<JType*()> call) {
+    if (!currentThread || !currentThread->isVirtual()) {
+        return call();
+    }
+
+    auto *vt = static_cast<VirtualThread*>(currentThread);
+    vt->park();
+    blockingWorkers.execute([vt, call] {
+        vt->pendingResult = call();
+        vt->unpark();
+    });
+    return nullptr;
+}
+
+void VirtualThreadScheduler::schedule(VirtualThread *vt) {
+    carriers.push(vt);
+}
+
+void VirtualThreadScheduler::sleepFor(VirtualThread *vt, int64_t millis) {
+    {
+        std::lock_guard<std::mutex> lock(timerMtx);
+        timers.push(SleepTimer{std::chrono::steady_clock::now() + std::chrono::milliseconds(millis),
+                               vt->shared_from_this(), vt->sleepSeq.load()});
+    }
+    timerCond.notify_one();
+}
+
+void VirtualThreadScheduler::timerLoop() {
+    std::unique_lock<std::mutex> lock(timerMtx);
+    while (!timerDone) {
+        if (timers.empty()) {
+            timerCond.wait(lock);
+            continue;
+        }
+
+        SleepTimer top = timers.top();
+        if (std::chrono::steady_clock::now() < top.deadline) {
+            timerCond.wait_until(lock, top.deadline);
+            continue;
+        }
+        timers.pop();
+
+        auto t = top.thread.lock();
+        if (t) {
+            lock.unlock();
+            static_cast<VirtualThread*>(t.get())->wakeFromSleep(top.seq);
+            lock.lock();
+        }
+    }
+}
+
+void VirtualThreadScheduler::runSlice(VirtualThread *vt) {
+    JavaThread *carrierThread = currentThread;
+
+    // 挂载：虚拟线程借用承载线程的 TLAB，并以承载线程的身份参与安全点
+    vt->carrier = carrierThread;
+    vt->tlab = carrierThread->tlab;
+    vt->runState = VirtualThread::RUNNING;
+    currentThread = vt;
+
+    if (vt->interruptPending.exchange(false)) {
+        vt->exception.throwNew("java/lang/InterruptedException", "sleep interrupted");
+    }
+    if (vt->pendingResult) {
+        vt->frames.back()->stack.push_back(vt->pendingResult);
+        vt->pendingResult = nullptr;
+    }
+    if (env->runJavaThread) {
+        env->runJavaThread(vt);
+    }
+
+    // 卸载
+    currentThread = carrierThread;
+    carrierThread->tlab = vt->tlab;
+    vt->tlab.retire();
+    vt->carrier = nullptr;
+
+    int s = vt->runState.load();
+    if (s == VirtualThread::RUNNING) {
+        finish(vt);
+        return;
+    }
+    if (s == VirtualThread::PARKING && vt->runState.compare_exchange_strong(s, VirtualThread::PARKED)) {
+        return;
+    }
+    // 挂起之前已经被唤醒
+    vt->runState = VirtualThread::RUNNABLE;
+    schedule(vt);
+}
+
+void VirtualThreadScheduler::finish(VirtualThread *vt) {
+    std::shared_ptr<JavaThread> holder;
+    {
+        std::lock_guard<std::mutex> lock(liveMtx);
+        auto pos = liveThreads.find(vt->threadObject->offset);
+        holder = pos->second;
+        liveThreads.erase(pos);
+    }
+    vt->terminate();
+}
+
+
+void VirtualThreadScheduler::CarrierThreadPool::runPendingWork() {
+    JavaThread *self = JavaThread::attachCurrentThread(nullptr);
+
+    while (!done) {
+        VirtualThread *vt = nullptr;
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(runQueueMtx);
+            self->safepointState = SafepointState::SAFE;
+            runQueueCond.wait(lock, [this] { return done || !runQueue.empty() || !blockingTasks.empty(); });
+            self->safepointState = SafepointState::RUNNING;
+            if (!runQueue.empty()) {
+                vt = runQueue.front();
+                runQueue.pop_front();
+            } else if (!blockingTasks.empty()) {
+                task = std::move(blockingTasks.front());
+                blockingTasks.pop_front();
+            }
+        }
+        self->pollSafepoint();
+
+        if (vt) {
+            scheduler->runSlice(vt);
+        } else if (task) {
+            // 阻塞调用不访问 Java 堆，不妨碍 GC
+            self->safepointState = SafepointState::SAFE;
+            task();
+            self->safepointState = SafepointState::RUNNING;
+        }
+    }
+
+    JavaThread::detachCurrentThread();
+}
+
+void VirtualThreadScheduler::CarrierThreadPool::finalize() {
+    {
+        std::lock_guard<std::mutex> lock(runQueueMtx);
+        done = true;
+    }
+    runQueueCond.notify_all();
+
+    // 基类的析构函数也会 join，但那时派生类的运行队列已经销毁了
+    for (std::thread &td : threads) {
+        if (td.joinable()) {
+            td.join();
+        }
+    }
+    threads.clear();
+}
+
+void VirtualThreadScheduler::CarrierThreadPool::push(VirtualThread *vt) {
+    {
+        std::lock_guard<std::mutex> lock(runQueueMtx);
+        runQueue.push_back(vt);
+    }
+    runQueueCond.notify_one();
+}
+
+void VirtualThreadScheduler::CarrierThreadPool::execute(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(runQueueMtx);
+        blockingTasks.push_back(std::move(task));
+    }
+    runQueueCond.notify_one();
+}
@@ -0,0 +1,143 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_VIRTUALTHREAD_H
+#define CJVM_VIRTUALTHREAD_H
+
+#include <deque>
+#include <queue>
+#include <vector>
+#include <unordered_map>
+#include "Concurrent.hpp"
+#include "JavaThread.h"
+
+class RuntimeEnv;
+class VirtualThreadScheduler;
+
+/**
+ * 虚拟线程：多个 Java 线程复用少量承载线程(M:N)
+ *
+ * 解释器的栈帧全部分配在堆上，所以续体(continuation)就是线程自己的 frames 加上每个帧里的 pc，
+ * 挂起时解释器只需退回到调度器，不需要保存原生栈。
+ *
+ * 阻塞点的约定：
+ *  - monitorenter 竞争失败时挂起，pc 不前进，恢复后重新执行 monitorenter
+ *  - 本地方法(sleep、I/O)中挂起时调用点正常完成，返回值由唤醒方通过 pendingResult 交付
+ */
+class VirtualThread : public JavaThread {
+    friend class VirtualThreadScheduler;
+public:
+    VirtualThread(JObject *threadObject, VirtualThreadScheduler *scheduler);
+    ~VirtualThread() override;
+
+    bool isVirtual() const override { return true; }
+    bool sleep(int64_t millis) override;
+    void interrupt() override;
+
+    // 由运行中的虚拟线程自己调用，请求在回到调度器后挂起
+    void park();
+    // 任意线程调用，使挂起的虚拟线程重新可调度
+    void unpark();
+
+    // 解释器在每个阻塞点之后检查，为 true 时必须退回调度器
+    bool yieldRequested() const {
+        return runState.load(std::memory_order_acquire) != RUNNING;
+    }
+
+    // 挂起期间完成的本地方法返回值，恢复时压入调用者的操作数栈
+    JType *pendingResult = nullptr;
+
+private:
+    enum RunState {
+        RUNNABLE,
+        RUNNING,
+        // 已请求挂起但还没退回调度器
+        PARKING,
+        // PARKING 期间就被 unpark 了，退回调度器后立即重新调度
+        PARKING_PERMITTED,
+        PARKED
+    };
+
+    void wakeFromSleep(uint64_t seq);
+
+    VirtualThreadScheduler *scheduler;
+    std::atomic<int> runState;
+
+    std::atomic_bool sleeping;
+    // 虚拟线程自己递增，定时器线程读取
+    std::atomic<uint64_t> sleepSeq{0};
+    // 睡眠被中断，恢复执行时抛出 InterruptedException
+    std::atomic_bool interruptPending{false};
+};
+
+
+class VirtualThreadScheduler {
+public:
+    VirtualThreadScheduler(RuntimeEnv *env, int carrierNum);
+    ~VirtualThreadScheduler();
+
+    void start(JObject *threadObject);
+    std::shared_ptr<JavaThread> find(const JObject *threadObject);
+
+    // 在虚拟线程中执行可能阻塞原生线程的调用(如 I/O)，期间承载线程去执行其它虚拟线程。
+    // 在平台线程中直接执行并返回结果；在虚拟线程中返回 nullptr，结果在恢复时交付
+    JType* runBlocking(std::function<JType*()> call);
+
+    // GC 通过它枚举未挂载的虚拟线程栈上的根
+    void forEach(const std::function<void(VirtualThread*)> &func);
+
+private:
+    friend class VirtualThread;
+
+    void schedule(VirtualThread *vt);
+    void sleepFor(VirtualThread *vt, int64_t millis);
+    void runSlice(VirtualThread *vt);
+    void finish(VirtualThread *vt);
+    void timerLoop();
+
+    class CarrierThreadPool : public ThreadPool {
+    public:
+        explicit CarrierThreadPool(VirtualThreadScheduler *scheduler) : scheduler(scheduler) {}
+        void runPendingWork() override;
+        // 等待所有承载线程退出，之后才能销毁运行队列和调度器的其它成员
+        void finalize() override;
+
+        void push(VirtualThread *vt);
+        void execute(std::function<void()> task);
+
+    private:
+        VirtualThreadScheduler *scheduler;
+        std::deque<VirtualThread*> runQueue;
+        std::deque<std::function<void()>> blockingTasks;
+        std::mutex runQueueMtx;
+        std::condition_variable runQueueCond;
+    };
+
+    class SleepTimer {
+    public:
+        std::chrono::steady_clock::time_point deadline;
+        std::weak_ptr<JavaThread> thread;
+        uint64_t seq;
+
+        bool operator>(const SleepTimer &rhs) const { return deadline > rhs.deadline; }
+    };
+
+    RuntimeEnv *env;
+    CarrierThreadPool carriers;
+    // 执行阻塞调用的线程池，与承载线程隔离
+    CarrierThreadPool blockingWorkers;
+
+    std::mutex liveMtx;
+    // 以 Thread 对象在堆上的偏移量为键
+    std::unordered_map<std::size_t, std::shared_ptr<JavaThread>> liveThreads;
+
+    std::mutex timerMtx;
+    std::condition_variable timerCond;
+    std::priority_queue<SleepTimer, std::vector<SleepTimer>, std::greater<SleepTimer>> timers;
+    bool timerDone = false;
+    std::thread timerThread;
+};
+
+
+#endif //CJVM_VIRTUALTHREAD_H
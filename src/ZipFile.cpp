@@ -0,0 +1,230 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#include "ZipFile.h"
+#include "Option.h"
+
+#define ZIP_LOCAL_HEADER_SIG 0x04034b50
+#define ZIP_CENTRAL_HEADER_SIG 0x02014b50
+#define ZIP_END_OF_CENTRAL_DIR_SIG 0x06054b50
+
+#define ZIP_LOCAL_HEADER_SIZE 30
+#define ZIP_CENTRAL_HEADER_SIZE 46
+#define ZIP_END_OF_CENTRAL_DIR_SIZE 22
+
+#define ZIP_METHOD_STORED 0
+#define ZIP_METHOD_DEFLATED 8
+
+// zip 中的整数都是小端序
+static inline u2 le16(const u1 *p) {
+    return (u2)(p[0] | (p[1] << 8));
+}
+
+static inline u4 le32(const u1 *p) {
+    return (u4)p[0] | ((u4)p[1] << 8) | ((u4)p[2] << 16) | ((u4)p[3] << 24);
+}
+
+/**
+ * 解压器池：z_stream 的初始化要分配约 7KB 的内部状态和 32KB 的窗口，
+ * 用完后 inflateReset 放回池中，之后解压其它条目时直接复用
+ */
+class InflaterPool {
+public:
+    ~InflaterPool() {
+        for (auto *zs : pool) {
+            inflateEnd(zs);
+            delete zs;
+        }
+    }
+
+    z_stream* acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!pool.empty()) {
+                z_stream *zs = pool.back();
+                pool.pop_back();
+                return zs;
+            }
+        }
+
+        auto *zs = new z_stream;
+        memset(zs, 0, sizeof(z_stream));
+        // 负的窗口大小表示没有 zlib 头的原始 deflate 数据
+        if (inflateInit2(zs, -MAX_WBITS) != Z_OK) {
+            delete zs;
+            return nullptr;
+        }
+        return zs;
+    }
+
+    void release(z_stream *zs) {
+        inflateReset(zs);
+        std::lock_guard<std::mutex> lock(mtx);
+        pool.push_back(zs);
+    }
+
+private:
+    std::mutex mtx;
+    std::vector<z_stream*> pool;
+};
+
+static InflaterPool inflaters;
+
+
+ZipFile::~ZipFile() {
+    if (base) {
+        munmap(const_cast<u1*>(base), size);
+    }
+}
+
+bool ZipFile::open(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (std::size_t)st.st_size < ZIP_END_OF_CENTRAL_DIR_SIZE) {
+        close(fd);
+        return false;
+    }
+
+    void *p = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        return false;
+    }
+    base = static_cast<const u1*>(p);
+    size = (std::size_t)st.st_size;
+
+    if (!parseCentralDirectory()) {
+        std::cerr << __func__ << ":Malformed zip file " << path << "\n";
+        munmap(p, size);
+        base = nullptr;
+        size = 0;
+        return false;
+    }
+    return true;
+}
+
+bool ZipFile::parseCentralDirectory() {
+    // 中央目录结束记录在文件末尾，后面最多跟着 64KB 的注释
+    const u1 *eocd = nullptr;
+    std::size_t lowest = size > ZIP_END_OF_CENTRAL_DIR_SIZE + 0xFFFF ? size - ZIP_END_OF_CENTRAL_DIR_SIZE - 0xFFFF : 0;
+    for (std::size_t i = size - ZIP_END_OF_CENTRAL_DIR_SIZE + 1; i-- > lowest;) {
+        if (le32(base + i) == ZIP_END_OF_CENTRAL_DIR_SIG) {
+            eocd = base + i;
+            break;
+        }
+    }
+    if (!eocd) {
+        return false;
+    }
+
+    const u2 entryCount = le16(eocd + 10);
+    const u4 dirSize = le32(eocd + 12);
+    const u4 dirOffset = le32(eocd + 16);
+    if ((uint64_t)dirOffset + dirSize > size) {
+        return false;
+    }
+
+    index.reserve(entryCount);
+    const u1 *p = base + dirOffset;
+    const u1 *end = p + dirSize;
+    for (u2 i = 0; i < entryCount; ++i) {
+        if (p + ZIP_CENTRAL_HEADER_SIZE > end || le32(p) != ZIP_CENTRAL_HEADER_SIG) {
+            return false;
+        }
+        const u2 nameLength = le16(p + 28);
+        const u2 extraLength = le16(p + 30);
+        const u2 commentLength = le16(p + 32);
+        if (p + ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength > end) {
+            return false;
+        }
+
+        Entry e;
+        e.method = le16(p + 10);
+        e.crc = le32(p + 16);
+        e.compressedSize = le32(p + 20);
+        e.uncompressedSize = le32(p + 24);
+        e.localHeaderOffset = le32(p + 42);
+        index.emplace(std::string(reinterpret_cast<const char*>(p + ZIP_CENTRAL_HEADER_SIZE), nameLength), e);
+
+        p += ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+    }
+    return true;
+}
+
+const u1* ZipFile::entryData(const Entry &e) const {
+    if ((uint64_t)e.localHeaderOffset + ZIP_LOCAL_HEADER_SIZE > size) {
+        return nullptr;
+    }
+    const u1 *local = base + e.localHeaderOffset;
+    if (le32(local) != ZIP_LOCAL_HEADER_SIG) {
+        return nullptr;
+    }
+    // 本地头里的扩展字段长度可能和中央目录中的不同
+    uint64_t dataOffset = (uint64_t)e.localHeaderOffset + ZIP_LOCAL_HEADER_SIZE + le16(local + 26) + le16(local + 28);
+    if (dataOffset + e.compressedSize > size) {
+        return nullptr;
+    }
+    return base + dataOffset;
+}
+
+bool ZipFile::read(const std::string &name, const u1 *&data, std::size_t &length, std::vector<u1> &buffer) const {
+    auto pos = index.find(name);
+    if (pos == index.end()) {
+        return false;
+    }
+    const Entry &e = pos->second;
+    const u1 *raw = entryData(e);
+    if (!raw) {
+        return false;
+    }
+
+    if (e.method == ZIP_METHOD_STORED) {
+#ifdef YVM_JAR_MAP_STORED_ENTRIES
+        data = raw;
+        length = e.compressedSize;
+#else
+        buffer.assign(raw, raw + e.compressedSize);
+        data = buffer.data();
+        length = buffer.size();
+#endif
+        return true;
+    }
+    if (e.method != ZIP_METHOD_DEFLATED) {
+        return false;
+    }
+
+    // 中央目录记录了解压后的大小，一次分配到位
+    buffer.resize(e.uncompressedSize);
+    z_stream *zs = inflaters.acquire();
+    if (!zs) {
+        return false;
+    }
+    zs->next_in = const_cast<Bytef*>(raw);
+    zs->avail_in = e.compressedSize;
+    zs->next_out = buffer.data();
+    zs->avail_out = e.uncompressedSize;
+    int ret = inflate(zs, Z_FINISH);
+    bool ok = ret == Z_STREAM_END && zs->total_out == e.uncompressedSize &&
+              crc32(0L, buffer.data(), e.uncompressedSize) == e.crc;
+    inflaters.release(zs);
+
+    if (!ok) {
+        std::cerr << __func__ << ":Corrupted zip entry " << name << "\n";
+        return false;
+    }
+    data = buffer.data();
+    length = buffer.size();
+    return true;
+}
@@ -0,0 +1,67 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#ifndef CJVM_ZIPFILE_H
+#define CJVM_ZIPFILE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Type.h"
+
+/**
+ * 只读的 zip/jar 文件
+ *
+ * 整个文件只读映射，打开时解析一次中央目录并建立以条目名为键的哈希索引，之后每次查找都不再访问文件系统。
+ * 不支持 ZIP64 和加密条目
+ */
+class ZipFile {
+public:
+    ZipFile() = default;
+    ~ZipFile();
+
+    ZipFile(const ZipFile&) = delete;
+    ZipFile& operator=(const ZipFile&) = delete;
+
+    bool open(const std::string &path);
+
+    bool contains(const std::string &name) const {
+        return index.find(name) != index.end();
+    }
+
+    /**
+     * 读出条目内容：
+     *  - 未压缩(stored)的条目 data 直接指向映射的内存，不拷贝
+     *  - deflate 压缩的条目解压到 buffer 中，data 指向 buffer
+     */
+    bool read(const std::string &name, const u1 *&data, std::size_t &length, std::vector<u1> &buffer) const;
+
+    // 枚举所有条目名
+    template<typename Func>
+    void forEachName(Func func) const {
+        for (const auto &x : index) {
+            func(x.first);
+        }
+    }
+
+private:
+    class Entry {
+    public:
+        u2 method;
+        u4 crc;
+        u4 compressedSize;
+        u4 uncompressedSize;
+        u4 localHeaderOffset;
+    };
+
+    bool parseCentralDirectory();
+    const u1* entryData(const Entry &e) const;
+
+    const u1 *base = nullptr;
+    std::size_t size = 0;
+    std::unordered_map<std::string, Entry> index;
+};
+
+
+#endif //CJVM_ZIPFILE_H
@@ -0,0 +1,135 @@
+//
+// Created by cyh on 2026/10/19.
+//
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <ftw.h>
+#include <unistd.h>
+#include "ClassWriter.h"
+#include "RuntimeEnv.h"
+#include "MethodArea.h"
+#include "JavaClass.h"
+#include "Verifier.h"
+#include "GC.h"
+#include "Opcode.h"
+
+#define ACC_PUBLIC_STATIC 0x0009
+
+RuntimeEnv crt;
+
+/**
+ * 校验器的测试：每个用例生成一个只有一个静态方法 m 的类，直接调用 Verifier 而不经过链接，
+ * 链接时校验失败会在当前线程上抛出 VerifyError，这里没有 Java 线程
+ */
+class VerifierCase {
+public:
+    const char *name;
+    const char *descriptor;
+    u2 maxStack;
+    u2 maxLocals;
+    bool expected;
+    std::function<void(ClassWriter&, CodeBuilder&)> emit;
+};
+
+static const std::vector<VerifierCase> CASES = {
+        // 对照：带栈映射帧的合法循环
+        {"test/Valid", "(I)I", 2, 2, true, [](ClassWriter &, CodeBuilder &c) {
+            CodeBuilder::Label body = c.newLabel(), cond = c.newLabel();
+            c.op(op_iconst_0).op(op_istore_1).branch(op_goto, cond);
+            c.bind(body);
+            c.frame({ClassWriter::intType(), ClassWriter::intType()});
+            c.iinc(1, 1);
+            c.bind(cond);
+            c.frame({ClassWriter::intType(), ClassWriter::intType()});
+            c.op(op_iload_1).op(op_iload_0).branch(op_if_icmplt, body);
+            c.op(op_iload_1).op(op_ireturn);
+        }},
+        // 跳转目标的栈映射帧声明栈上有一个 int，而跳转过来时操作数栈为空
+        {"test/BadStackMap", "(I)I", 1, 1, false, [](ClassWriter &, CodeBuilder &c) {
+            CodeBuilder::Label target = c.newLabel();
+            c.op(op_iload_0).branch(op_ifeq, target);
+            c.op(op_iconst_1).op(op_ireturn);
+            c.bind(target);
+            c.frame({ClassWriter::intType()}, {ClassWriter::intType()});
+            c.op(op_ireturn);
+        }},
+        // 没有调用构造函数的对象不能作为返回值
+        {"test/UninitializedReturn", "()Ljava/lang/Object;", 1, 0, false, [](ClassWriter &w, CodeBuilder &c) {
+            c.op2(op_new, w.classRef("java/lang/Object")).op(op_areturn);
+        }},
+        // 没有调用构造函数的对象不能调用实例方法
+        {"test/UninitializedInvoke", "()V", 1, 0, false, [](ClassWriter &w, CodeBuilder &c) {
+            c.op2(op_new, w.classRef("java/lang/Object"))
+             .op2(op_invokevirtual, w.methodRef("java/lang/Object", "hashCode", "()I")).op(op_pop).op(op_return);
+        }},
+        // 跳转到 goto 指令的操作数中间
+        {"test/BranchIntoInstruction", "()V", 0, 0, false, [](ClassWriter &, CodeBuilder &c) {
+            c.op2(op_goto, 1).op(op_return);
+        }},
+        // 跳转到方法体之外
+        {"test/BranchOutOfCode", "()V", 0, 0, false, [](ClassWriter &, CodeBuilder &c) {
+            c.op2(op_goto, 100).op(op_return);
+        }},
+};
+
+static int removeEntry(const char *path, const struct stat *, int, struct FTW *) {
+    return remove(path);
+}
+
+static bool emitClasses(const std::string &dir) {
+    ClassWriter object("java/lang/Object", "");
+    CodeBuilder ret;
+    ret.op(op_return);
+    object.addMethod(0x0001, "<init>", "()V", 0, 1, ret);
+    CodeBuilder hash;
+    hash.op(op_iconst_0).op(op_ireturn);
+    object.addMethod(0x0001, "hashCode", "()I", 1, 1, hash);
+    if (!object.write(dir)) {
+        return false;
+    }
+
+    for (const auto &c : CASES) {
+        ClassWriter w(c.name, "java/lang/Object");
+        CodeBuilder code;
+        c.emit(w, code);
+        w.addMethod(ACC_PUBLIC_STATIC, "m", c.descriptor, c.maxStack, c.maxLocals, code);
+        if (!w.write(dir)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    char pattern[] = "/tmp/cjvm-verifier-test-XXXXXX";
+    if (!mkdtemp(pattern)) {
+        std::cerr << __func__ << ":Can not create temporary class directory\n";
+        return EXIT_FAILURE;
+    }
+    const std::string classDir = pattern;
+
+    int failures = 0;
+    if (!emitClasses(classDir)) {
+        std::cerr << __func__ << ":Failed to write test classes to " << classDir << "\n";
+        failures++;
+    } else {
+        crt.ma = new MethodArea({classDir});
+        for (const auto &c : CASES) {
+            JavaClass *jc = crt.ma->loadClassIfAbsent(c.name);
+            const bool verified = jc && Verifier(jc).verify();
+            const bool passed = jc && verified == c.expected;
+            std::cout << (passed ? "PASS " : "FAIL ") << c.name << (c.expected ? " (accept)" : " (reject)") << "\n";
+            failures += passed ? 0 : 1;
+        }
+        delete crt.ma;
+        crt.ma = nullptr;
+    }
+
+    nftw(classDir.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    crt.gc->terminateGC();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}